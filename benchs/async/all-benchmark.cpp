@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nhope/async/all.h"
+#include "nhope/async/ao-context.h"
+#include "nhope/async/future.h"
+#include "nhope/async/thread-executor.h"
+
+namespace {
+
+constexpr std::int64_t argCount = 50'000;
+constexpr std::size_t maxInFlight = 64;
+constexpr std::size_t payloadSize = 4096;
+
+// Counts the live operations and the memory of their results, remembers the high-water marks
+class Tracker final
+{
+public:
+    static void add(std::atomic<std::int64_t>& value, std::atomic<std::int64_t>& peak, std::int64_t delta)
+    {
+        const auto current = value.fetch_add(delta) + delta;
+        auto prev = peak.load();
+        while (current > prev && !peak.compare_exchange_weak(prev, current)) {
+        }
+    }
+
+    static void reset()
+    {
+        inFlight = 0;
+        peakInFlight = 0;
+        bytes = 0;
+        peakBytes = 0;
+    }
+
+    static inline std::atomic<std::int64_t> inFlight = 0;
+    static inline std::atomic<std::int64_t> peakInFlight = 0;
+    static inline std::atomic<std::int64_t> bytes = 0;
+    static inline std::atomic<std::int64_t> peakBytes = 0;
+};
+
+class Payload final
+{
+public:
+    Payload()
+      : m_data(std::make_unique<char[]>(payloadSize))   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    {
+        Tracker::add(Tracker::bytes, Tracker::peakBytes, payloadSize);
+    }
+
+    Payload(Payload&&) = default;
+    Payload& operator=(Payload&& other) noexcept
+    {
+        this->release();
+        m_data = std::move(other.m_data);
+        return *this;
+    }
+
+    Payload(const Payload&) = delete;
+    Payload& operator=(const Payload&) = delete;
+
+    ~Payload()
+    {
+        this->release();
+    }
+
+private:
+    void release()
+    {
+        if (m_data != nullptr) {
+            Tracker::add(Tracker::bytes, Tracker::peakBytes, -static_cast<std::int64_t>(payloadSize));
+            m_data.reset();
+        }
+    }
+
+    std::unique_ptr<char[]> m_data;   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+};
+
+// Asynchronous operation, which completes in the queue of the context
+nhope::Future<Payload> readPayload(nhope::AOContext& ctx, std::int64_t /*arg*/)
+{
+    Tracker::add(Tracker::inFlight, Tracker::peakInFlight, 1);
+
+    auto promise = std::make_shared<nhope::Promise<Payload>>();
+    ctx.exec([promise] {
+        Tracker::add(Tracker::inFlight, Tracker::peakInFlight, -1);
+        promise->setValue(Payload());
+    });
+    return promise->future();
+}
+
+class DropConsumer final : public nhope::Consumer<Payload>
+{
+public:
+    Status consume(const Payload& value) override
+    {
+        benchmark::DoNotOptimize(&value);
+        return Status::Ok;
+    }
+};
+
+std::vector<std::int64_t> makeArgs()
+{
+    std::vector<std::int64_t> args(argCount);
+    std::iota(args.begin(), args.end(), 0);
+    return args;
+}
+
+void setCounters(benchmark::State& state)
+{
+    state.SetItemsProcessed(state.iterations() * argCount);
+    state.counters["peakInFlight"] = static_cast<double>(Tracker::peakInFlight);
+    state.counters["peakBytes"] = benchmark::Counter(static_cast<double>(Tracker::peakBytes),
+                                                     benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+}
+
+void allUnlimited(benchmark::State& state)
+{
+    nhope::ThreadExecutor executor;
+    nhope::AOContext ao(executor);
+    const auto args = makeArgs();
+    Tracker::reset();
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::all(ao, readPayload, args).get());
+    }
+    setCounters(state);
+}
+
+void allLimited(benchmark::State& state)
+{
+    nhope::ThreadExecutor executor;
+    nhope::AOContext ao(executor);
+    const auto args = makeArgs();
+    Tracker::reset();
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::allLimited(ao, readPayload, args, maxInFlight).get());
+    }
+    setCounters(state);
+}
+
+void allToConsumer(benchmark::State& state)
+{
+    nhope::ThreadExecutor executor;
+    nhope::AOContext ao(executor);
+    const auto args = makeArgs();
+    Tracker::reset();
+
+    for ([[maybe_unused]] auto _ : state) {
+        nhope::allToConsumer(ao, readPayload, args, std::make_unique<DropConsumer>(), maxInFlight).get();
+    }
+    setCounters(state);
+}
+
+}   // namespace
+
+BENCHMARK(allUnlimited)   // NOLINT
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK(allLimited)   // NOLINT
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK(allToConsumer)   // NOLINT
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
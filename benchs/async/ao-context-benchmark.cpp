@@ -0,0 +1,59 @@
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/async/async-invoke.h"
+#include "nhope/async/thread-executor.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr std::int64_t minNestingDepth = 1;
+constexpr std::int64_t maxNestingDepth = 256;
+constexpr std::int64_t nestedExecCount = 1000;
+
+void execNested(std::vector<std::unique_ptr<nhope::AOContext>>& aoCtxs, std::size_t depth)
+{
+    if (depth == aoCtxs.size()) {
+        return;
+    }
+
+    aoCtxs[depth]->exec(
+      [&aoCtxs, depth] {
+          execNested(aoCtxs, depth + 1);
+      },
+      nhope::Executor::ExecMode::ImmediatelyIfPossible);
+}
+
+/* Every AOContext is a separate group, so each nested exec adds one more record
+   to the thread local set of the working AOContexts. */
+void nestedExec(benchmark::State& state)
+{
+    nhope::ThreadExecutor executor;
+    nhope::AOContext rootCtx(executor);
+
+    std::vector<std::unique_ptr<nhope::AOContext>> aoCtxs;
+    for (std::int64_t i = 0; i < state.range(); ++i) {
+        aoCtxs.emplace_back(std::make_unique<nhope::AOContext>(executor));
+    }
+
+    for ([[maybe_unused]] auto _ : state) {
+        nhope::invoke(rootCtx, [&aoCtxs] {
+            for (std::int64_t i = 0; i < nestedExecCount; ++i) {
+                execNested(aoCtxs, 0);
+            }
+        });
+    }
+
+    state.SetItemsProcessed(state.iterations() * nestedExecCount * state.range());
+}
+
+}   // namespace
+
+BENCHMARK(nestedExec)   // NOLINT
+  ->RangeMultiplier(4)
+  ->Range(minNestingDepth, maxNestingDepth)
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
@@ -0,0 +1,94 @@
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nhope/async/manageable-task.h"
+
+namespace {
+
+constexpr std::int64_t taskCount = 1000;
+constexpr std::int64_t maxBatchSize = 64;
+
+void emptyTask(nhope::ManageableTaskCtx& ctx)
+{
+    benchmark::DoNotOptimize(ctx.checkPoint());
+}
+
+// The cost of a dedicated thread per task, for comparison
+void threadPerTask(benchmark::State& state)
+{
+    for ([[maybe_unused]] auto _ : state) {
+        for (std::int64_t i = 0; i < taskCount; ++i) {
+            std::thread([] {
+                benchmark::ClobberMemory();
+            }).join();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * taskCount);
+}
+
+void startAndWait(benchmark::State& state)
+{
+    for ([[maybe_unused]] auto _ : state) {
+        for (std::int64_t i = 0; i < taskCount; ++i) {
+            nhope::ManageableTask::start(emptyTask)->waitForStopped();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * taskCount);
+}
+
+// Batches of tasks are started at once and then destroyed
+void startBatch(benchmark::State& state)
+{
+    const auto batchSize = state.range(0);
+
+    std::vector<std::unique_ptr<nhope::ManageableTask>> tasks;
+    tasks.reserve(static_cast<std::size_t>(batchSize));
+    for ([[maybe_unused]] auto _ : state) {
+        for (std::int64_t i = 0; i < taskCount; i += batchSize) {
+            for (std::int64_t j = 0; j < batchSize; ++j) {
+                tasks.emplace_back(nhope::ManageableTask::start(emptyTask));
+            }
+            tasks.clear();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * taskCount);
+}
+
+void createNotStarted(benchmark::State& state)
+{
+    for ([[maybe_unused]] auto _ : state) {
+        for (std::int64_t i = 0; i < taskCount; ++i) {
+            nhope::ManageableTask::create(emptyTask).reset();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * taskCount);
+}
+
+}   // namespace
+
+BENCHMARK(threadPerTask)   // NOLINT
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK(startAndWait)   // NOLINT
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK(startBatch)   // NOLINT
+  ->RangeMultiplier(8)
+  ->Range(1, maxBatchSize)
+  ->ArgName("batch")
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK(createNotStarted)   // NOLINT
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
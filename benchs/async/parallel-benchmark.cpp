@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nhope/async/parallel.h"
+#include "nhope/async/thread-pool-executor.h"
+
+namespace {
+
+constexpr std::size_t valueCount = 1 << 24;
+
+const std::vector<std::uint32_t>& values()
+{
+    static const auto result = [] {
+        std::vector<std::uint32_t> v(valueCount);
+        std::iota(v.begin(), v.end(), 0U);
+        return v;
+    }();
+    return result;
+}
+
+std::uint32_t mix(std::uint32_t v)
+{
+    v ^= v >> 16;
+    v *= 0x7feb352dU;
+    v ^= v >> 15;
+    return v;
+}
+
+void serialReduce(benchmark::State& state)
+{
+    const auto& v = values();
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(std::accumulate(v.begin(), v.end(), std::uint64_t(0)));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * valueCount * sizeof(std::uint32_t)));
+}
+
+void parallelReduce(benchmark::State& state)
+{
+    nhope::ThreadPoolExecutor executor(static_cast<std::size_t>(state.range(0)));
+    const auto& v = values();
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(
+          nhope::parallelReduce(executor, v.begin(), v.end(), std::uint64_t(0), std::plus<std::uint64_t>()).get());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * valueCount * sizeof(std::uint32_t)));
+}
+
+void parallelTransform(benchmark::State& state)
+{
+    nhope::ThreadPoolExecutor executor(static_cast<std::size_t>(state.range(0)));
+    const auto& v = values();
+    std::vector<std::uint32_t> out(valueCount);
+    for ([[maybe_unused]] auto _ : state) {
+        nhope::parallelTransform(executor, v.begin(), v.end(), out.begin(), mix).get();
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * valueCount * sizeof(std::uint32_t)));
+}
+
+// A small range: the cost of the fork-join itself
+void parallelForSmall(benchmark::State& state)
+{
+    nhope::ThreadPoolExecutor executor(static_cast<std::size_t>(state.range(0)));
+    std::vector<std::uint32_t> data(1024);
+    for ([[maybe_unused]] auto _ : state) {
+        nhope::parallelFor(executor, 0, data.size(), [&data](std::size_t i) {
+            data[i] = mix(static_cast<std::uint32_t>(i));
+        }).get();
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * data.size()));
+}
+
+void threadCounts(benchmark::internal::Benchmark* b)
+{
+    const auto maxThreads = std::max<std::int64_t>(std::thread::hardware_concurrency(), 8);
+    for (std::int64_t threads = 1; threads <= maxThreads; threads *= 2) {
+        b->Arg(threads);
+    }
+}
+
+}   // namespace
+
+BENCHMARK(serialReduce)   // NOLINT
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK(parallelReduce)   // NOLINT
+  ->Apply(threadCounts)
+  ->ArgName("threads")
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK(parallelTransform)   // NOLINT
+  ->Apply(threadCounts)
+  ->ArgName("threads")
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK(parallelForSmall)   // NOLINT
+  ->Apply(threadCounts)
+  ->ArgName("threads")
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMicrosecond);
@@ -0,0 +1,105 @@
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "nhope/async/scheduler.h"
+
+namespace {
+
+using namespace std::literals;
+
+constexpr std::int64_t maxTaskCount = 10'000;
+constexpr std::int64_t batchTaskCount = 32;
+constexpr std::int64_t maxConcurrency = 8;
+
+void idleTask(nhope::ManageableTaskCtx& ctx)
+{
+    while (ctx.checkPoint()) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+// The first task is active, the rest are waiting in the queue
+std::vector<nhope::Scheduler::TaskId> fillScheduler(nhope::Scheduler& scheduler, std::int64_t taskCount)
+{
+    std::vector<nhope::Scheduler::TaskId> ids;
+    ids.reserve(static_cast<std::size_t>(taskCount));
+    for (std::int64_t i = 0; i < taskCount; ++i) {
+        ids.push_back(scheduler.push(idleTask, static_cast<int>(i % 8)));
+    }
+    return ids;
+}
+
+void lookupTask(benchmark::State& state)
+{
+    nhope::Scheduler scheduler;
+    const auto ids = fillScheduler(scheduler, state.range(0));
+
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<std::size_t> index(0, ids.size() - 1);
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(scheduler.getState(ids[index(gen)]));
+    }
+}
+
+void pushAndCancel(benchmark::State& state)
+{
+    nhope::Scheduler scheduler;
+    fillScheduler(scheduler, state.range(0));
+
+    for ([[maybe_unused]] auto _ : state) {
+        // The task is not started, so it is removed from the queue at once
+        scheduler.cancel(scheduler.push(idleTask, 4));
+    }
+}
+
+void batchTask(nhope::ManageableTaskCtx& ctx)
+{
+    std::uint64_t value = 0;
+    for (int i = 0; i < 100 && ctx.checkPoint(); ++i) {
+        for (int j = 0; j < 10'000; ++j) {
+            value = value * 31 + static_cast<std::uint64_t>(j);
+        }
+        benchmark::DoNotOptimize(value);
+    }
+}
+
+void concurrentTasks(benchmark::State& state)
+{
+    const nhope::Scheduler::Options options{static_cast<std::size_t>(state.range(0)), std::nullopt};
+
+    for ([[maybe_unused]] auto _ : state) {
+        nhope::Scheduler scheduler(options);
+        for (std::int64_t i = 0; i < batchTaskCount; ++i) {
+            scheduler.push(batchTask);
+        }
+        scheduler.waitAll();
+    }
+
+    state.SetItemsProcessed(state.iterations() * batchTaskCount);
+}
+
+}   // namespace
+
+BENCHMARK(lookupTask)   // NOLINT
+  ->RangeMultiplier(10)
+  ->Range(100, maxTaskCount)
+  ->ArgName("tasks")
+  ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+BENCHMARK(pushAndCancel)   // NOLINT
+  ->RangeMultiplier(10)
+  ->Range(100, maxTaskCount)
+  ->ArgName("tasks")
+  ->Unit(benchmark::TimeUnit::kMicrosecond);
+
+BENCHMARK(concurrentTasks)   // NOLINT
+  ->RangeMultiplier(2)
+  ->Range(1, maxConcurrency)
+  ->ArgName("concurrency")
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
@@ -0,0 +1,145 @@
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "nhope/async/lock-free-ts-queue.h"
+#include "nhope/async/ts-queue.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr std::int64_t itemCount = 100'000;
+constexpr std::size_t queueCapacity = 1024;
+constexpr std::int64_t maxThreadCount = 16;
+constexpr std::size_t batchSize = 64;
+
+template<typename Queue>
+void doTransfer(std::int64_t producerCount, std::int64_t consumerCount)
+{
+    Queue queue(queueCapacity);
+
+    std::vector<std::thread> consumers;
+    for (std::int64_t i = 0; i < consumerCount; ++i) {
+        consumers.emplace_back([&queue] {
+            std::int64_t value = 0;
+            while (queue.read(value)) {
+                benchmark::DoNotOptimize(value);
+            }
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for (std::int64_t i = 0; i < producerCount; ++i) {
+        producers.emplace_back([&queue, producerCount] {
+            for (std::int64_t v = 0; v < itemCount / producerCount; ++v) {
+                queue.write(std::int64_t(v));
+            }
+        });
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    queue.close();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+}
+
+template<typename Queue>
+void queueTransfer(benchmark::State& state)
+{
+    for ([[maybe_unused]] auto _ : state) {
+        doTransfer<Queue>(state.range(0), state.range(1));
+    }
+
+    state.SetItemsProcessed(state.iterations() * itemCount);
+}
+
+template<typename Queue>
+void doBatchTransfer(std::int64_t producerCount, std::int64_t consumerCount)
+{
+    Queue queue(queueCapacity);
+
+    std::vector<std::thread> consumers;
+    for (std::int64_t i = 0; i < consumerCount; ++i) {
+        consumers.emplace_back([&queue] {
+            std::vector<std::int64_t> values;
+            values.reserve(batchSize);
+            while (queue.readBatch(values, batchSize) > 0) {
+                benchmark::DoNotOptimize(values.data());
+                values.clear();
+            }
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for (std::int64_t i = 0; i < producerCount; ++i) {
+        producers.emplace_back([&queue, producerCount] {
+            std::vector<std::int64_t> values;
+            values.reserve(batchSize);
+            for (std::int64_t v = 0; v < itemCount / producerCount; ++v) {
+                values.push_back(v);
+                if (values.size() == batchSize) {
+                    queue.writeBatch(values);
+                    values.clear();
+                }
+            }
+            queue.writeBatch(values);
+        });
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    queue.close();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+}
+
+template<typename Queue>
+void queueBatchTransfer(benchmark::State& state)
+{
+    for ([[maybe_unused]] auto _ : state) {
+        doBatchTransfer<Queue>(state.range(0), state.range(1));
+    }
+
+    state.SetItemsProcessed(state.iterations() * itemCount);
+}
+
+void producersAndConsumers(benchmark::internal::Benchmark* b)
+{
+    for (std::int64_t producers = 1; producers <= maxThreadCount; producers *= 2) {
+        for (std::int64_t consumers = 1; consumers <= maxThreadCount; consumers *= 2) {
+            b->Args({producers, consumers});
+        }
+    }
+}
+
+}   // namespace
+
+BENCHMARK_TEMPLATE(queueTransfer, nhope::TSQueue<std::int64_t>)   // NOLINT
+  ->Apply(producersAndConsumers)
+  ->ArgNames({"producers", "consumers"})
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK_TEMPLATE(queueTransfer, nhope::LockFreeTSQueue<std::int64_t>)   // NOLINT
+  ->Apply(producersAndConsumers)
+  ->ArgNames({"producers", "consumers"})
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK_TEMPLATE(queueBatchTransfer, nhope::TSQueue<std::int64_t>)   // NOLINT
+  ->Apply(producersAndConsumers)
+  ->ArgNames({"producers", "consumers"})
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK_TEMPLATE(queueBatchTransfer, nhope::LockFreeTSQueue<std::int64_t>)   // NOLINT
+  ->Apply(producersAndConsumers)
+  ->ArgNames({"producers", "consumers"})
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
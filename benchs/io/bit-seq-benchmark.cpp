@@ -0,0 +1,82 @@
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+#include <gsl/span>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/async/event.h"
+#include "nhope/async/thread-executor.h"
+#include "nhope/io/bit-seq-reader.h"
+#include "nhope/io/io-device.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr std::size_t chunkSize = 64 * 1024;
+
+// PRBS of the polynomial x^order + x^tap + 1, one period
+std::vector<bool> makePrbs(int order, int tap)
+{
+    std::vector<bool> bits;
+    std::uint32_t state = (1U << order) - 1;
+    const auto period = (std::size_t(1) << order) - 1;
+    bits.reserve(period);
+    for (std::size_t i = 0; i < period; ++i) {
+        const auto bit = ((state >> (order - 1)) ^ (state >> (tap - 1))) & 1;
+        state = ((state << 1) | bit) & ((1U << order) - 1);
+        bits.push_back(bit != 0);
+    }
+    return bits;
+}
+
+std::size_t readChunk(nhope::Reader& dev, gsl::span<std::uint8_t> buf)
+{
+    nhope::Event finished;
+    std::size_t result = 0;
+    dev.read(buf, [&](const std::exception_ptr& /*err*/, std::size_t n) {
+        result = n;
+        finished.set();
+    });
+    finished.wait();
+    return result;
+}
+
+void bitSeqReader(benchmark::State& state, const std::vector<bool>& bits)
+{
+    nhope::ThreadExecutor executor;
+    nhope::AOContext aoCtx(executor);
+    auto dev = nhope::BitSeqReader::create(aoCtx, bits);
+
+    std::vector<std::uint8_t> buf(chunkSize);
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(readChunk(*dev, buf));
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * chunkSize));
+}
+
+void shortPattern(benchmark::State& state)
+{
+    bitSeqReader(state, {true, false, true});
+}
+
+void prbs15(benchmark::State& state)
+{
+    static const auto bits = makePrbs(15, 14);
+    bitSeqReader(state, bits);
+}
+
+// The period of 8 MB is generated word by word
+void prbs23(benchmark::State& state)
+{
+    static const auto bits = makePrbs(23, 18);
+    bitSeqReader(state, bits);
+}
+
+}   // namespace
+
+BENCHMARK(shortPattern)->UseRealTime();   // NOLINT
+BENCHMARK(prbs15)->UseRealTime();         // NOLINT
+BENCHMARK(prbs23)->UseRealTime();         // NOLINT
@@ -1,8 +1,129 @@
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "nhope/seq/fifo.h"
 
+namespace {
+
+constexpr std::size_t crossThreadFifoSize = 4096;
+constexpr std::size_t crossThreadBytes = 16 * 1024 * 1024;
+
+constexpr std::size_t deviceFifoSize = 64 * 1024;
+constexpr std::size_t deviceReadSize = 4096;
+constexpr std::size_t parserReadSize = 256;
+
+/* Fifo protected by a mutex, as it was used to pass bytes between threads */
+class LockedFifo final
+{
+public:
+    std::size_t push(gsl::span<const std::uint8_t> data)
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_fifo.push(data);
+    }
+
+    std::size_t pop(gsl::span<std::uint8_t> data)
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_fifo.pop(data);
+    }
+
+private:
+    std::mutex m_mutex;
+    nhope::Fifo<std::uint8_t, crossThreadFifoSize> m_fifo;
+};
+
+template<typename Fifo>
+void crossThreadFifo(benchmark::State& state)
+{
+    const auto chunkSize = static_cast<std::size_t>(state.range());
+
+    for ([[maybe_unused]] auto _ : state) {
+        Fifo fifo;
+
+        std::thread producer([&fifo, chunkSize] {
+            std::vector<std::uint8_t> chunk(chunkSize);
+            for (std::size_t sent = 0; sent < crossThreadBytes;) {
+                const auto count = std::min(chunkSize, crossThreadBytes - sent);
+                const auto pushed = fifo.push(gsl::span(chunk).first(count));
+                if (pushed == 0) {
+                    std::this_thread::yield();
+                }
+                sent += pushed;
+            }
+        });
+
+        std::vector<std::uint8_t> chunk(chunkSize);
+        for (std::size_t received = 0; received < crossThreadBytes;) {
+            const auto popped = fifo.pop(chunk);
+            if (popped == 0) {
+                std::this_thread::yield();
+            }
+            benchmark::DoNotOptimize(chunk.data());
+            received += popped;
+        }
+
+        producer.join();
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * crossThreadBytes));
+}
+
+/* Stands for a device read: fills the buffer with data from the device */
+std::size_t deviceRead(gsl::span<std::uint8_t> buf, const std::vector<std::uint8_t>& device)
+{
+    const auto n = std::min(buf.size(), device.size());
+    std::memcpy(buf.data(), device.data(), n);
+    return n;
+}
+
+void fifoFromDeviceByCopy(benchmark::State& state)
+{
+    nhope::Fifo<std::uint8_t, deviceFifoSize> fifo;
+    const std::vector<std::uint8_t> device(deviceReadSize, 1);
+    std::vector<std::uint8_t> staging(deviceReadSize);
+    std::vector<std::uint8_t> out(parserReadSize);
+
+    for ([[maybe_unused]] auto _ : state) {
+        const auto n = deviceRead(staging, device);
+        fifo.push(gsl::span(staging).first(n));
+        while (fifo.pop(out) != 0) {
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * deviceReadSize));
+}
+
+void fifoFromDeviceZeroCopy(benchmark::State& state)
+{
+    nhope::Fifo<std::uint8_t, deviceFifoSize> fifo;
+    const std::vector<std::uint8_t> device(deviceReadSize, 1);
+    std::vector<std::uint8_t> out(parserReadSize);
+
+    for ([[maybe_unused]] auto _ : state) {
+        auto space = fifo.prepare(deviceReadSize);
+        auto n = deviceRead(space[0], device);
+        if (n < deviceReadSize) {
+            n += deviceRead(space[1], device);
+        }
+        fifo.commit(n);
+        while (fifo.pop(out) != 0) {
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * deviceReadSize));
+}
+
+}   // namespace
+
 void fifo(benchmark::State& state)
 {
     nhope::Fifo<int, 1024> fifo;
@@ -19,3 +140,18 @@ void fifo(benchmark::State& state)
 }
 
 BENCHMARK(fifo)->Iterations(100000)->Unit(benchmark::TimeUnit::kMillisecond);   //NOLINT
+
+BENCHMARK_TEMPLATE(crossThreadFifo, LockedFifo)   //NOLINT
+  ->RangeMultiplier(8)
+  ->Range(8, 512)
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK_TEMPLATE(crossThreadFifo, nhope::SpscFifo<std::uint8_t, crossThreadFifoSize>)   //NOLINT
+  ->RangeMultiplier(8)
+  ->Range(8, 512)
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK(fifoFromDeviceByCopy);     //NOLINT
+BENCHMARK(fifoFromDeviceZeroCopy);   //NOLINT
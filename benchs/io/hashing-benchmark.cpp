@@ -0,0 +1,78 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/async/thread-executor.h"
+#include "nhope/io/digest.h"
+#include "nhope/io/hashing-reader.h"
+#include "nhope/io/io-device.h"
+#include "nhope/io/null-device.h"
+#include "nhope/io/string-reader.h"
+#include "nhope/utils/crc.h"
+#include "nhope/utils/md5.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr std::int64_t dataSize = 16 * 1024 * 1024;
+
+std::string makeData()
+{
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    std::string data(static_cast<std::size_t>(dataSize), '\0');
+    for (auto& c : data) {
+        c = static_cast<char>(dist(gen));
+    }
+    return data;
+}
+
+// Copy, then read the data once more to check it
+template<typename Hash>
+void copyThenDigest(benchmark::State& state)
+{
+    const auto data = makeData();
+
+    nhope::ThreadExecutor executor;
+    nhope::AOContext aoCtx(executor);
+    auto dest = nhope::NullDevice::create(aoCtx);
+
+    for ([[maybe_unused]] auto _ : state) {
+        auto src = nhope::StringReader::create(aoCtx, data);
+        nhope::copy(*src, *dest).get();
+
+        auto check = nhope::StringReader::create(aoCtx, data);
+        benchmark::DoNotOptimize(nhope::digest<Hash>(*check).get());
+    }
+
+    state.SetBytesProcessed(state.iterations() * dataSize);
+}
+
+// Checksum on copy: one pass
+template<typename Hash>
+void hashingCopy(benchmark::State& state)
+{
+    const auto data = makeData();
+
+    nhope::ThreadExecutor executor;
+    nhope::AOContext aoCtx(executor);
+    auto dest = nhope::NullDevice::create(aoCtx);
+
+    for ([[maybe_unused]] auto _ : state) {
+        auto src = nhope::HashingReader<Hash>::create(aoCtx, nhope::StringReader::create(aoCtx, data));
+        nhope::copy(*src, *dest).get();
+        benchmark::DoNotOptimize(src->digest());
+    }
+
+    state.SetBytesProcessed(state.iterations() * dataSize);
+}
+
+}   // namespace
+
+BENCHMARK_TEMPLATE(copyThenDigest, nhope::MD5)->Unit(benchmark::kMillisecond)->UseRealTime();      // NOLINT
+BENCHMARK_TEMPLATE(hashingCopy, nhope::MD5)->Unit(benchmark::kMillisecond)->UseRealTime();         // NOLINT
+BENCHMARK_TEMPLATE(copyThenDigest, nhope::CRC32C)->Unit(benchmark::kMillisecond)->UseRealTime();   // NOLINT
+BENCHMARK_TEMPLATE(hashingCopy, nhope::CRC32C)->Unit(benchmark::kMillisecond)->UseRealTime();      // NOLINT
@@ -1,6 +1,11 @@
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
 
 #include "nhope/async/ao-context.h"
+#include "nhope/io/fifo-reader.h"
 #include "nhope/io/file.h"
 #include "nhope/async/thread-executor.h"
 #include "nhope/io/io-device.h"
@@ -10,6 +15,16 @@
 namespace {
 
 constexpr auto bufSize{4096};
+constexpr auto lineCount{1000};
+
+std::string makeLines()
+{
+    std::string lines;
+    for (int i = 0; i < lineCount; ++i) {
+        lines += "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,," + std::to_string(i) + "\n";
+    }
+    return lines;
+}
 
 }   // namespace
 
@@ -39,5 +54,68 @@ void fileWriter(benchmark::State& state)
     }
 }
 
+/* readLine reads byte by byte, so every line costs a lot of device reads without buffering */
+class LinesFile final
+{
+public:
+    LinesFile()
+      : m_path((std::filesystem::temp_directory_path() / "nhope-read-lines-benchmark.txt").string())
+    {
+        std::ofstream(m_path) << makeLines();
+    }
+
+    ~LinesFile()
+    {
+        std::error_code ec;
+        std::filesystem::remove(m_path, ec);
+    }
+
+    LinesFile(const LinesFile&) = delete;
+    LinesFile& operator=(const LinesFile&) = delete;
+
+    [[nodiscard]] const std::string& path() const
+    {
+        return m_path;
+    }
+
+private:
+    std::string m_path;
+};
+
+void readLines(benchmark::State& state)
+{
+    nhope::ThreadExecutor e;
+    nhope::AOContext aoCtx(e);
+
+    const LinesFile file;
+    for ([[maybe_unused]] auto _ : state) {
+        auto reader = nhope::File::open(aoCtx, file.path(), nhope::OpenFileMode::ReadOnly);
+        for (int i = 0; i < lineCount; ++i) {
+            benchmark::DoNotOptimize(nhope::readLine(*reader).get());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * lineCount);
+}
+
+void readLinesFifoReader(benchmark::State& state)
+{
+    nhope::ThreadExecutor e;
+    nhope::AOContext aoCtx(e);
+
+    const LinesFile file;
+    for ([[maybe_unused]] auto _ : state) {
+        auto reader = nhope::FifoReader::create(
+          aoCtx, nhope::File::open(aoCtx, file.path(), nhope::OpenFileMode::ReadOnly));
+        for (int i = 0; i < lineCount; ++i) {
+            benchmark::DoNotOptimize(nhope::readLine(*reader).get());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * lineCount);
+}
+
 BENCHMARK(fileReader)->Iterations(100000)->Unit(benchmark::TimeUnit::kMillisecond);   //NOLINT
 BENCHMARK(fileWriter)->Iterations(100000)->Unit(benchmark::TimeUnit::kMillisecond);   //NOLINT
+BENCHMARK(readLines)->UseRealTime()->Unit(benchmark::TimeUnit::kMillisecond);             //NOLINT
+BENCHMARK(readLinesFifoReader)->UseRealTime()->Unit(benchmark::TimeUnit::kMillisecond);   //NOLINT
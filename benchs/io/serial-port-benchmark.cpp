@@ -0,0 +1,62 @@
+#ifdef __linux__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/async/thread-executor.h"
+#include "nhope/io/io-device.h"
+#include "nhope/io/serial-port.h"
+#include <benchmark/benchmark.h>
+
+#include "../../tests/test-helpers/pseudo-terminal.h"
+
+namespace {
+
+using namespace nhope;
+
+// Round trip of a frame: master -> port -> master.
+// Args: the frame size and VMIN (1 - the port wakes up on every received byte)
+void ptyLoopback(benchmark::State& state)
+{
+    const auto frameSize = static_cast<std::size_t>(state.range(0));
+    const auto minReadSize = static_cast<std::uint8_t>(state.range(1));
+
+    test::PseudoTerminal pty;
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    SerialPortParams params;
+    params.customBaudrate = 921600;
+    params.lowLatency = true;
+    params.minReadSize = minReadSize;
+    auto port = SerialPort::open(aoCtx, pty.slaveName(), params);
+
+    const std::vector<std::uint8_t> frame(frameSize, 0x55);
+    std::vector<std::uint8_t> echo(frameSize);
+    for ([[maybe_unused]] auto _ : state) {
+        // The read is posted first, so with VMIN = size it completes once, with the whole frame
+        auto received = readExactly(*port, frameSize);
+        pty.write(frame);
+        writeExactly(*port, received.get()).get();
+        pty.read(echo);
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * frameSize));
+}
+
+void frames(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"size", "vmin"});
+    b->Args({1, 1});
+    for (const auto size : {16, 255}) {
+        b->Args({size, 1})->Args({size, size});
+    }
+}
+
+}   // namespace
+
+BENCHMARK(ptyLoopback)->Apply(frames)->UseRealTime();   // NOLINT
+
+#endif
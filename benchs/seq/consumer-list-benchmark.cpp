@@ -0,0 +1,138 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "nhope/seq/consumer-list.h"
+#include "nhope/seq/consumer.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr std::int64_t valueCount = 10'000;
+constexpr std::int64_t maxConsumerCount = 64;
+constexpr std::int64_t maxProducerCount = 8;
+constexpr std::size_t frameSize = 16 * 1024;
+constexpr std::int64_t maxFrameConsumerCount = 8;
+
+class CountingConsumer final : public nhope::Consumer<std::int64_t>
+{
+public:
+    explicit CountingConsumer(std::atomic<std::int64_t>& counter)
+      : m_counter(counter)
+    {}
+
+    Status consume(const std::int64_t& value) override
+    {
+        benchmark::DoNotOptimize(value);
+        m_counter.fetch_add(1, std::memory_order_relaxed);
+        return Status::Ok;
+    }
+
+private:
+    std::atomic<std::int64_t>& m_counter;
+};
+
+void broadcast(benchmark::State& state)
+{
+    const auto consumerCount = state.range(0);
+    const auto producerCount = state.range(1);
+
+    std::atomic<std::int64_t> counter = 0;
+    nhope::ConsumerList<std::int64_t> consumers;
+    for (std::int64_t i = 0; i < consumerCount; ++i) {
+        consumers.addConsumer(std::make_unique<CountingConsumer>(counter));
+    }
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<std::thread> producers;
+        for (std::int64_t i = 0; i < producerCount; ++i) {
+            producers.emplace_back([&consumers, producerCount] {
+                for (std::int64_t v = 0; v < valueCount / producerCount; ++v) {
+                    consumers.consume(v);
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+    }
+
+    benchmark::DoNotOptimize(counter.load());
+    state.SetItemsProcessed(state.iterations() * (valueCount / producerCount) * producerCount * consumerCount);
+}
+
+struct Frame
+{
+    std::vector<std::uint8_t> data;
+};
+
+/* Keeps the last frame, as a queue or a task of an executor would do */
+class FrameConsumer final : public nhope::Consumer<Frame>
+{
+public:
+    Status consume(const Frame& value) override
+    {
+        m_last = value;
+        return Status::Ok;
+    }
+
+    Status consumeOwned(Frame&& value) override
+    {
+        m_last = std::move(value);
+        return Status::Ok;
+    }
+
+    Status consumeShared(const std::shared_ptr<const Frame>& value) override
+    {
+        m_lastShared = value;
+        return Status::Ok;
+    }
+
+private:
+    Frame m_last;
+    std::shared_ptr<const Frame> m_lastShared;
+};
+
+template<bool owned>
+void broadcastFrames(benchmark::State& state)
+{
+    nhope::ConsumerList<Frame> consumers;
+    for (std::int64_t i = 0; i < state.range(); ++i) {
+        consumers.addConsumer(std::make_unique<FrameConsumer>());
+    }
+
+    Frame frame;
+    std::uint8_t counter = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        // The producer fills the frame every time (after moving it has to allocate the data again)
+        frame.data.assign(frameSize, ++counter);
+        if constexpr (owned) {
+            consumers.consumeOwned(std::move(frame));
+        } else {
+            consumers.consume(frame);
+        }
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * frameSize));
+}
+
+}   // namespace
+
+BENCHMARK_TEMPLATE(broadcastFrames, false)   // NOLINT
+  ->RangeMultiplier(2)
+  ->Range(1, maxFrameConsumerCount)
+  ->ArgName("consumers");
+
+BENCHMARK_TEMPLATE(broadcastFrames, true)   // NOLINT
+  ->RangeMultiplier(2)
+  ->Range(1, maxFrameConsumerCount)
+  ->ArgName("consumers");
+
+BENCHMARK(broadcast)   // NOLINT
+  ->ArgsProduct({benchmark::CreateRange(1, maxConsumerCount, 4), benchmark::CreateRange(1, maxProducerCount, 2)})
+  ->ArgNames({"consumers", "producers"})
+  ->UseRealTime()
+  ->Unit(benchmark::TimeUnit::kMillisecond);
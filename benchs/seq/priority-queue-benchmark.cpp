@@ -0,0 +1,79 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "nhope/seq/priority-queue.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+constexpr std::int64_t minQueueSize = 1'000;
+constexpr std::int64_t maxQueueSize = 1'000'000;
+constexpr int priorityCount = 16;
+
+std::vector<int> makePriorities(std::int64_t count)
+{
+    std::mt19937 gen(count);
+    std::uniform_int_distribution<int> dist(0, priorityCount - 1);
+
+    std::vector<int> priorities(count);
+    for (auto& p : priorities) {
+        p = dist(gen);
+    }
+    return priorities;
+}
+
+template<typename Queue>
+void pushPop(benchmark::State& state)
+{
+    const auto priorities = makePriorities(state.range());
+
+    for ([[maybe_unused]] auto _ : state) {
+        Queue queue;
+        for (std::int64_t i = 0; i < state.range(); ++i) {
+            queue.push(i, priorities[i]);
+        }
+        while (auto value = queue.pop()) {
+            benchmark::DoNotOptimize(value);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range());
+}
+
+void changePriority(benchmark::State& state)
+{
+    using Queue = nhope::IndexedPriorityQueue<std::int64_t>;
+
+    const auto priorities = makePriorities(state.range());
+
+    Queue queue;
+    std::vector<Queue::Handle> handles;
+    for (std::int64_t i = 0; i < state.range(); ++i) {
+        handles.push_back(queue.push(i, priorities[i]));
+    }
+
+    std::size_t i = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        queue.changePriority(handles[i % handles.size()], priorities[(i + 1) % priorities.size()]);
+        ++i;
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+}   // namespace
+
+BENCHMARK_TEMPLATE(pushPop, nhope::PriorityQueue<std::int64_t>)   // NOLINT
+  ->RangeMultiplier(10)
+  ->Range(minQueueSize, maxQueueSize)
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK_TEMPLATE(pushPop, nhope::IndexedPriorityQueue<std::int64_t>)   // NOLINT
+  ->RangeMultiplier(10)
+  ->Range(minQueueSize, maxQueueSize)
+  ->Unit(benchmark::TimeUnit::kMillisecond);
+
+BENCHMARK(changePriority)   // NOLINT
+  ->RangeMultiplier(10)
+  ->Range(minQueueSize, maxQueueSize);
@@ -0,0 +1,113 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nhope/utils/base64.h"
+#include "nhope/utils/detail/cpu-features.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using nhope::detail::SimdLevel;
+
+constexpr std::int64_t minDataSize = 1024;
+constexpr std::int64_t maxDataSize = 4 * 1024 * 1024;
+constexpr std::size_t mimeLineLength = 76;
+
+std::vector<std::uint8_t> makeData(std::int64_t size)
+{
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(size));
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(size));
+    for (auto& b : data) {
+        b = static_cast<std::uint8_t>(dist(gen));
+    }
+    return data;
+}
+
+void setLevel(benchmark::State& state)
+{
+    const auto level = static_cast<SimdLevel>(state.range(1));
+    nhope::detail::setSimdLevelLimit(level);
+    if (nhope::detail::simdLevel() != level) {
+        state.SkipWithError("the instruction set is not supported");
+    }
+}
+
+void encode(benchmark::State& state)
+{
+    setLevel(state);
+    const auto data = makeData(state.range(0));
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::toBase64(data));
+    }
+
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void decode(benchmark::State& state)
+{
+    setLevel(state);
+    const auto text = nhope::toBase64(makeData(state.range(0)));
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::fromBase64(text, false));
+    }
+
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Text split into lines, as in MIME
+void decodeLines(benchmark::State& state)
+{
+    setLevel(state);
+    const auto base64 = nhope::toBase64(makeData(state.range(0)));
+    std::string text;
+    for (std::size_t i = 0; i < base64.size(); i += mimeLineLength) {
+        text += base64.substr(i, mimeLineLength) + "\r\n";
+    }
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::fromBase64(text));
+    }
+
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void decodeToSpan(benchmark::State& state)
+{
+    setLevel(state);
+    const auto text = nhope::toBase64(makeData(state.range(0)));
+    std::vector<std::uint8_t> out(nhope::base64DecodedMaxSize(text.size()));
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::fromBase64(text, out, false));
+    }
+
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void levelArgs(benchmark::internal::Benchmark* b)
+{
+    for (const auto level : {SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2}) {
+        for (auto size = minDataSize; size <= maxDataSize; size *= 64) {
+            b->Args({size, static_cast<std::int64_t>(level)});
+        }
+    }
+    b->ArgNames({"size", "level"});
+}
+
+}   // namespace
+
+BENCHMARK(encode)->Apply(levelArgs);         // NOLINT
+BENCHMARK(decode)->Apply(levelArgs);         // NOLINT
+BENCHMARK(decodeLines)->Apply(levelArgs);    // NOLINT
+BENCHMARK(decodeToSpan)->Apply(levelArgs);   // NOLINT
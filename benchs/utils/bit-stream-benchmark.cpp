@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nhope/utils/bit-stream.h"
+#include "nhope/utils/bits.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using nhope::BitOrder;
+
+// A telemetry frame of fields of the same width
+constexpr std::size_t frameSize = 64 * 1024;
+
+std::vector<std::uint8_t> makeBytes(std::size_t size)
+{
+    std::vector<std::uint8_t> bytes(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<std::uint8_t>(i * 7 + i / 3);
+    }
+    return bytes;
+}
+
+// Bit by bit, MSB first
+void naiveRead(benchmark::State& state)
+{
+    const auto width = static_cast<std::size_t>(state.range(0));
+    const auto bytes = makeBytes(frameSize);
+    const auto fieldCount = bytes.size() * 8 / width;
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::uint64_t sum = 0;
+        std::size_t pos = 0;
+        for (std::size_t i = 0; i < fieldCount; ++i) {
+            std::uint64_t value = 0;
+            for (std::size_t b = 0; b < width; ++b, ++pos) {
+                value = value << 1 | ((bytes[pos / 8] >> (7 - pos % 8)) & 1);
+            }
+            sum += value;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes.size()));
+}
+
+template<BitOrder Order>
+void bitReader(benchmark::State& state)
+{
+    const auto width = static_cast<std::size_t>(state.range(0));
+    const auto bytes = makeBytes(frameSize);
+    const auto fieldCount = bytes.size() * 8 / width;
+
+    for ([[maybe_unused]] auto _ : state) {
+        nhope::BitReader<Order> reader(bytes);
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i < fieldCount; ++i) {
+            sum += reader.read(width);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes.size()));
+}
+
+// Bit by bit, MSB first
+void naiveWrite(benchmark::State& state)
+{
+    const auto width = static_cast<std::size_t>(state.range(0));
+    std::vector<std::uint8_t> bytes(frameSize);
+    const auto fieldCount = bytes.size() * 8 / width;
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::fill(bytes.begin(), bytes.end(), 0);
+        std::size_t pos = 0;
+        for (std::size_t i = 0; i < fieldCount; ++i) {
+            for (std::size_t b = width; b-- > 0; ++pos) {
+                bytes[pos / 8] |= static_cast<std::uint8_t>(((i >> b) & 1) << (7 - pos % 8));
+            }
+        }
+        benchmark::DoNotOptimize(bytes.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes.size()));
+}
+
+template<BitOrder Order>
+void bitWritter(benchmark::State& state)
+{
+    const auto width = static_cast<std::size_t>(state.range(0));
+    std::vector<std::uint8_t> bytes(frameSize);
+    const auto fieldCount = bytes.size() * 8 / width;
+
+    for ([[maybe_unused]] auto _ : state) {
+        nhope::BitWritter<Order> writter(bytes);
+        for (std::size_t i = 0; i < fieldCount; ++i) {
+            writter.write(i, width);
+        }
+        writter.flush();
+        benchmark::DoNotOptimize(bytes.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes.size()));
+}
+
+void widths(benchmark::internal::Benchmark* b)
+{
+    b->Arg(1)->Arg(5)->Arg(13)->Arg(32)->Arg(57)->ArgName("width");
+}
+
+}   // namespace
+
+BENCHMARK(naiveRead)->Apply(widths);                                 // NOLINT
+BENCHMARK_TEMPLATE(bitReader, BitOrder::MsbFirst)->Apply(widths);    // NOLINT
+BENCHMARK_TEMPLATE(bitReader, BitOrder::LsbFirst)->Apply(widths);    // NOLINT
+BENCHMARK(naiveWrite)->Apply(widths);                                // NOLINT
+BENCHMARK_TEMPLATE(bitWritter, BitOrder::MsbFirst)->Apply(widths);   // NOLINT
+BENCHMARK_TEMPLATE(bitWritter, BitOrder::LsbFirst)->Apply(widths);   // NOLINT
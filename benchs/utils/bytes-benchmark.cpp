@@ -0,0 +1,81 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <gsl/span>
+
+#include "nhope/utils/bits.h"
+#include "nhope/utils/bytes.h"
+#include "nhope/utils/detail/cpu-features.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using nhope::detail::SimdLevel;
+
+// A buffer of device samples
+constexpr std::size_t sampleCount = 100000;
+
+std::vector<std::uint8_t> makeBytes(std::size_t size)
+{
+    std::vector<std::uint8_t> bytes(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<std::uint8_t>(i * 7);
+    }
+    return bytes;
+}
+
+// One value at a time, as the samples were decoded before
+template<typename Int>
+void fromBytesLoop(benchmark::State& state)
+{
+    const auto bytes = makeBytes(sampleCount * sizeof(Int));
+    std::vector<Int> values(sampleCount);
+
+    for ([[maybe_unused]] auto _ : state) {
+        for (std::size_t i = 0; i < sampleCount; ++i) {
+            values[i] = nhope::fromBytes<Int>(gsl::span(bytes).subspan(i * sizeof(Int)), nhope::Endian::Big);
+        }
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes.size()));
+}
+
+template<typename Int>
+void fromBytesBulk(benchmark::State& state)
+{
+    const auto level = static_cast<SimdLevel>(state.range(0));
+    nhope::detail::setSimdLevelLimit(level);
+    if (nhope::detail::simdLevel() != level) {
+        state.SkipWithError("the instruction set is not supported");
+    }
+
+    const auto bytes = makeBytes(sampleCount * sizeof(Int));
+    std::vector<Int> values(sampleCount);
+
+    for ([[maybe_unused]] auto _ : state) {
+        nhope::fromBytes<Int>(bytes, values, nhope::Endian::Big);
+        benchmark::DoNotOptimize(values.data());
+        benchmark::ClobberMemory();
+    }
+
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes.size()));
+}
+
+void levels(benchmark::internal::Benchmark* b)
+{
+    b->Arg(static_cast<std::int64_t>(SimdLevel::Scalar))
+      ->Arg(static_cast<std::int64_t>(SimdLevel::Sse41))
+      ->Arg(static_cast<std::int64_t>(SimdLevel::Avx2))
+      ->ArgName("level");
+}
+
+}   // namespace
+
+BENCHMARK_TEMPLATE(fromBytesLoop, std::uint16_t);                   // NOLINT
+BENCHMARK_TEMPLATE(fromBytesBulk, std::uint16_t)->Apply(levels);   // NOLINT
+BENCHMARK_TEMPLATE(fromBytesLoop, std::uint32_t);                   // NOLINT
+BENCHMARK_TEMPLATE(fromBytesBulk, std::uint32_t)->Apply(levels);   // NOLINT
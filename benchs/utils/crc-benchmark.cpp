@@ -0,0 +1,121 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "nhope/utils/crc.h"
+#include "nhope/utils/detail/cpu-features.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using nhope::detail::SimdLevel;
+
+constexpr std::int64_t packetSize = 64;
+constexpr std::int64_t maxDataSize = 1024 * 1024;
+
+std::vector<std::uint8_t> makeData(std::int64_t size)
+{
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(size));
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(size));
+    for (auto& b : data) {
+        b = static_cast<std::uint8_t>(dist(gen));
+    }
+    return data;
+}
+
+// The byte-at-a-time table code, which was used before
+template<typename T, bool Reflected>
+T byteAtATime(T crc, const std::array<T, 256>& table, const std::vector<std::uint8_t>& data)
+{
+    constexpr int width = std::numeric_limits<T>::digits;
+    for (const auto b : data) {
+        if constexpr (Reflected) {
+            crc = static_cast<T>(table[(crc ^ b) & 0xff] ^ (crc >> 8));
+        } else {
+            crc = static_cast<T>(table[((crc >> (width - 8)) ^ b) & 0xff] ^ (crc << 8));
+        }
+    }
+    return crc;
+}
+
+void crc16Table(benchmark::State& state)
+{
+    static constexpr auto table = nhope::makeCrcTable<std::uint16_t>(0x8005, true);
+    const auto data = makeData(state.range(0));
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(byteAtATime<std::uint16_t, true>(0xffff, table, data));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void crc16Modbus(benchmark::State& state)
+{
+    const auto data = makeData(state.range(0));
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::CRC16Modbus::digest(data));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void crc32Table(benchmark::State& state)
+{
+    static constexpr auto table = nhope::makeCrcTable<std::uint32_t>(0x04c11db7, true);
+    const auto data = makeData(state.range(0));
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(~byteAtATime<std::uint32_t, true>(0xffffffff, table, data));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Level Scalar disables the crc32 and clmul instructions
+template<typename Hash>
+void crc32Kernels(benchmark::State& state)
+{
+    const auto level = static_cast<SimdLevel>(state.range(1));
+    nhope::detail::setSimdLevelLimit(level);
+    if (level != SimdLevel::Scalar && !nhope::detail::hasClmulInstructions()) {
+        state.SkipWithError("the instruction set is not supported");
+    }
+
+    const auto data = makeData(state.range(0));
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(Hash::digest(data));
+    }
+
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void sizes(benchmark::internal::Benchmark* b)
+{
+    b->RangeMultiplier(128)->Range(packetSize, maxDataSize);
+}
+
+void sizesAndLevels(benchmark::internal::Benchmark* b)
+{
+    b->ArgsProduct({
+                     benchmark::CreateRange(packetSize, maxDataSize, 128),
+                     {static_cast<std::int64_t>(SimdLevel::Scalar), static_cast<std::int64_t>(SimdLevel::Avx2)},
+                   })
+      ->ArgNames({"size", "level"});
+}
+
+}   // namespace
+
+BENCHMARK(crc16Table)->Apply(sizes);                                      // NOLINT
+BENCHMARK(crc16Modbus)->Apply(sizes);                                     // NOLINT
+BENCHMARK(crc32Table)->Apply(sizes);                                      // NOLINT
+BENCHMARK_TEMPLATE(crc32Kernels, nhope::CRC32)->Apply(sizesAndLevels);    // NOLINT
+BENCHMARK_TEMPLATE(crc32Kernels, nhope::CRC32C)->Apply(sizesAndLevels);   // NOLINT
@@ -0,0 +1,132 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/async/thread-executor.h"
+#include "nhope/io/hex-writter.h"
+#include "nhope/io/null-device.h"
+#include "nhope/utils/detail/cpu-features.h"
+#include "nhope/utils/hex.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using nhope::detail::SimdLevel;
+
+constexpr std::int64_t minDataSize = 1024;
+constexpr std::int64_t maxDataSize = 4 * 1024 * 1024;
+constexpr std::int64_t writeChunkSize = 4096;
+
+std::vector<std::uint8_t> makeData(std::int64_t size)
+{
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(size));
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(size));
+    for (auto& b : data) {
+        b = static_cast<std::uint8_t>(dist(gen));
+    }
+    return data;
+}
+
+void setLevel(benchmark::State& state)
+{
+    const auto level = static_cast<SimdLevel>(state.range(1));
+    nhope::detail::setSimdLevelLimit(level);
+    if (nhope::detail::simdLevel() != level) {
+        state.SkipWithError("the instruction set is not supported");
+    }
+}
+
+void encode(benchmark::State& state)
+{
+    setLevel(state);
+    const auto data = makeData(state.range(0));
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::toHex(data));
+    }
+
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void decode(benchmark::State& state)
+{
+    setLevel(state);
+    const auto text = nhope::toHex(makeData(state.range(0)));
+    std::vector<std::uint8_t> out(text.size() / 2);
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::fromHex(text, out));
+    }
+
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Dump with a space after each byte
+void decodeSpaced(benchmark::State& state)
+{
+    setLevel(state);
+    const auto hex = nhope::toHex(makeData(state.range(0)));
+    std::string text;
+    for (std::size_t i = 0; i < hex.size(); i += 2) {
+        text += hex.substr(i, 2) + " ";
+    }
+    std::vector<std::uint8_t> out(text.size() / 2);
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::fromHex(text, out));
+    }
+
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void hexWritter(benchmark::State& state)
+{
+    setLevel(state);
+    const auto data = makeData(state.range(0));
+
+    nhope::ThreadExecutor executor;
+    nhope::AOContext aoCtx(executor);
+    auto dev = nhope::HexWritter::create(aoCtx, nhope::NullDevice::create(aoCtx));
+
+    for ([[maybe_unused]] auto _ : state) {
+        for (auto it = data.begin(); it != data.end(); it += writeChunkSize) {
+            nhope::writeExactly(*dev, {it, it + writeChunkSize}).get();
+        }
+    }
+
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void levelArgs(benchmark::internal::Benchmark* b)
+{
+    for (const auto level : {SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2}) {
+        for (auto size = minDataSize; size <= maxDataSize; size *= 64) {
+            b->Args({size, static_cast<std::int64_t>(level)});
+        }
+    }
+    b->ArgNames({"size", "level"});
+}
+
+void writterArgs(benchmark::internal::Benchmark* b)
+{
+    for (const auto level : {SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2}) {
+        b->Args({maxDataSize, static_cast<std::int64_t>(level)});
+    }
+    b->ArgNames({"size", "level"});
+}
+
+}   // namespace
+
+BENCHMARK(encode)->Apply(levelArgs);         // NOLINT
+BENCHMARK(decode)->Apply(levelArgs);         // NOLINT
+BENCHMARK(decodeSpaced)->Apply(levelArgs);   // NOLINT
+BENCHMARK(hexWritter)->Apply(writterArgs);   // NOLINT
@@ -0,0 +1,159 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/async/thread-executor.h"
+#include "nhope/io/digest.h"
+#include "nhope/io/string-reader.h"
+#include "nhope/utils/detail/cpu-features.h"
+#include "nhope/utils/md5.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using nhope::detail::SimdLevel;
+
+constexpr std::int64_t streamSize = 4 * 1024 * 1024;
+constexpr std::int64_t fileSize = 64 * 1024;
+constexpr std::int64_t fileCount = 256;
+
+std::vector<std::uint8_t> makeData(std::int64_t size)
+{
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(size));
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(size));
+    for (auto& b : data) {
+        b = static_cast<std::uint8_t>(dist(gen));
+    }
+    return data;
+}
+
+void singleStream(benchmark::State& state)
+{
+    const auto data = makeData(streamSize);
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::MD5::digest(data));
+    }
+
+    state.SetBytesProcessed(state.iterations() * streamSize);
+}
+
+// Many files after sync: one by one and in SIMD lanes
+void manyStreams(benchmark::State& state)
+{
+    const auto data = makeData(fileSize * fileCount);
+    std::vector<gsl::span<const std::uint8_t>> files;
+    for (std::int64_t i = 0; i < fileCount; ++i) {
+        files.push_back(gsl::span(data).subspan(static_cast<std::size_t>(i * fileSize), fileSize));
+    }
+
+    for ([[maybe_unused]] auto _ : state) {
+        for (const auto& file : files) {
+            benchmark::DoNotOptimize(nhope::MD5::digest(file));
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * fileSize * fileCount);
+}
+
+void manyStreamsLanes(benchmark::State& state)
+{
+    const auto level = static_cast<SimdLevel>(state.range(0));
+    nhope::detail::setSimdLevelLimit(level);
+    if (nhope::detail::simdLevel() != level) {
+        state.SkipWithError("the instruction set is not supported");
+    }
+
+    const auto data = makeData(fileSize * fileCount);
+    std::vector<gsl::span<const std::uint8_t>> files;
+    for (std::int64_t i = 0; i < fileCount; ++i) {
+        files.push_back(gsl::span(data).subspan(static_cast<std::size_t>(i * fileSize), fileSize));
+    }
+
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::MD5::digestMany(files));
+    }
+
+    state.counters["lanes"] = static_cast<double>(nhope::MD5::laneCount());
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * fileSize * fileCount);
+}
+
+void readerDigest(benchmark::State& state)
+{
+    const auto data = makeData(streamSize);
+    const std::string text(data.begin(), data.end());
+
+    nhope::ThreadExecutor executor;
+    nhope::AOContext aoCtx(executor);
+
+    for ([[maybe_unused]] auto _ : state) {
+        auto reader = nhope::StringReader::create(aoCtx, text);
+        benchmark::DoNotOptimize(nhope::digest(*reader).get());
+    }
+
+    state.SetBytesProcessed(state.iterations() * streamSize);
+}
+
+// Files read by Readers: one by one and in SIMD lanes
+constexpr std::int64_t readerCount = 16;
+
+void readerDigestEach(benchmark::State& state)
+{
+    const auto data = makeData(streamSize);
+    const std::string text(data.begin(), data.end());
+    const auto size = text.size() / readerCount;
+
+    nhope::ThreadExecutor executor;
+    nhope::AOContext aoCtx(executor);
+
+    for ([[maybe_unused]] auto _ : state) {
+        for (std::int64_t i = 0; i < readerCount; ++i) {
+            auto reader = nhope::StringReader::create(aoCtx, text.substr(static_cast<std::size_t>(i) * size, size));
+            benchmark::DoNotOptimize(nhope::digest(*reader).get());
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * streamSize);
+}
+
+void readerDigestMany(benchmark::State& state)
+{
+    const auto data = makeData(streamSize);
+    const std::string text(data.begin(), data.end());
+    const auto size = text.size() / readerCount;
+
+    nhope::ThreadExecutor executor;
+    nhope::AOContext aoCtx(executor);
+
+    for ([[maybe_unused]] auto _ : state) {
+        std::vector<nhope::StringReaderPtr> readers;
+        std::vector<nhope::Reader*> devs;
+        for (std::int64_t i = 0; i < readerCount; ++i) {
+            readers.push_back(
+              nhope::StringReader::create(aoCtx, text.substr(static_cast<std::size_t>(i) * size, size)));
+            devs.push_back(readers.back().get());
+        }
+        benchmark::DoNotOptimize(nhope::digestMany(devs).get());
+    }
+
+    state.SetBytesProcessed(state.iterations() * streamSize);
+}
+
+}   // namespace
+
+BENCHMARK(singleStream);   // NOLINT
+BENCHMARK(manyStreams);    // NOLINT
+BENCHMARK(manyStreamsLanes)   // NOLINT
+  ->Arg(static_cast<std::int64_t>(SimdLevel::Scalar))
+  ->Arg(static_cast<std::int64_t>(SimdLevel::Sse41))
+  ->Arg(static_cast<std::int64_t>(SimdLevel::Avx2))
+  ->ArgName("level");
+BENCHMARK(readerDigest)->Unit(benchmark::TimeUnit::kMillisecond);   // NOLINT
+BENCHMARK(readerDigestEach)->Unit(benchmark::TimeUnit::kMillisecond);   // NOLINT
+BENCHMARK(readerDigestMany)->Unit(benchmark::TimeUnit::kMillisecond);   // NOLINT
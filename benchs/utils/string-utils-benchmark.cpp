@@ -0,0 +1,178 @@
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include <gsl/span>
+
+#include "nhope/utils/detail/cpu-features.h"
+#include "nhope/utils/string-utils.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+using nhope::detail::SimdLevel;
+
+constexpr std::int64_t minTextSize = 1024 * 1024;
+constexpr std::int64_t maxTextSize = 100 * 1024 * 1024;
+
+// A log export: lines of words, sometimes with tags and quotes
+std::string makeLog(std::int64_t size)
+{
+    constexpr std::string_view lines[] = {
+      "2024-03-01 12:00:01.123 [info] device connected, port=/dev/ttyUSB0 baud=115200\n",
+      "2024-03-01 12:00:01.456 [debug] rx frame: a6 e7 d3 b4 6f df af 0b de 2a 1f 83\n",
+      "2024-03-01 12:00:02.001 [warn] timeout while waiting for <ack>, retry \"3\" & continue\n",
+      "2024-03-01 12:00:02.010 [info]\tstate changed: idle -> running\n",
+    };
+
+    std::string text;
+    text.reserve(static_cast<std::size_t>(size));
+    for (std::size_t i = 0; text.size() < static_cast<std::size_t>(size); ++i) {
+        text += lines[i % std::size(lines)];
+    }
+    text.resize(static_cast<std::size_t>(size));
+    return text;
+}
+
+void setLevel(benchmark::State& state)
+{
+    const auto level = static_cast<SimdLevel>(state.range(1));
+    nhope::detail::setSimdLevelLimit(level);
+    if (nhope::detail::simdLevel() != level) {
+        state.SkipWithError("the instruction set is not supported");
+    }
+}
+
+// The char by char implementations, which were used before
+std::string simpleRemoveWhitespaces(std::string_view s)
+{
+    std::string result;
+    result.reserve(s.size());
+    for (char symbol : s) {
+        if (isspace(symbol) == 0) {
+            result += symbol;
+        }
+    }
+    result.shrink_to_fit();
+    return result;
+}
+
+std::string simpleToHtmlEscaped(std::string_view s)
+{
+    std::string rich;
+    rich.reserve(static_cast<std::size_t>(static_cast<double>(s.size()) * 1.1));
+    for (auto c : s) {
+        switch (c) {
+        case '<':
+            rich += "&lt;";
+            break;
+        case '>':
+            rich += "&gt;";
+            break;
+        case '&':
+            rich += "&amp;";
+            break;
+        case '"':
+            rich += "&quot;";
+            break;
+        default:
+            rich += c;
+            break;
+        }
+    }
+    rich.shrink_to_fit();
+    return rich;
+}
+
+void simpleRemove(benchmark::State& state)
+{
+    const auto text = makeLog(state.range(0));
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(simpleRemoveWhitespaces(text));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void removeWhitespaces(benchmark::State& state)
+{
+    setLevel(state);
+    const auto text = makeLog(state.range(0));
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::removeWhitespaces(text));
+    }
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void removeWhitespacesToSpan(benchmark::State& state)
+{
+    setLevel(state);
+    const auto text = makeLog(state.range(0));
+    std::string out(text.size(), '\0');
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::removeWhitespaces(text, gsl::span<char>(out.data(), out.size())));
+    }
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void simpleEscape(benchmark::State& state)
+{
+    const auto text = makeLog(state.range(0));
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(simpleToHtmlEscaped(text));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void toHtmlEscaped(benchmark::State& state)
+{
+    setLevel(state);
+    const auto text = makeLog(state.range(0));
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::toHtmlEscaped(text));
+    }
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void toHtmlEscapedToSpan(benchmark::State& state)
+{
+    setLevel(state);
+    const auto text = makeLog(state.range(0));
+    std::string out(nhope::htmlEscapedSize(text), '\0');
+    for ([[maybe_unused]] auto _ : state) {
+        benchmark::DoNotOptimize(nhope::toHtmlEscaped(text, gsl::span<char>(out.data(), out.size())));
+    }
+    nhope::detail::setSimdLevelLimit(SimdLevel::Avx2);
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void sizes(benchmark::internal::Benchmark* b)
+{
+    for (auto size = minTextSize; size <= maxTextSize; size *= 10) {
+        b->Args({size, static_cast<std::int64_t>(SimdLevel::Scalar)});
+    }
+    b->ArgNames({"size", "level"});
+}
+
+void levelArgs(benchmark::internal::Benchmark* b)
+{
+    for (const auto level : {SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2}) {
+        for (auto size = minTextSize; size <= maxTextSize; size *= 10) {
+            b->Args({size, static_cast<std::int64_t>(level)});
+        }
+    }
+    b->ArgNames({"size", "level"});
+}
+
+}   // namespace
+
+BENCHMARK(simpleRemove)->Apply(sizes)->Unit(benchmark::kMillisecond);                  // NOLINT
+BENCHMARK(removeWhitespaces)->Apply(levelArgs)->Unit(benchmark::kMillisecond);         // NOLINT
+BENCHMARK(removeWhitespacesToSpan)->Apply(levelArgs)->Unit(benchmark::kMillisecond);   // NOLINT
+BENCHMARK(simpleEscape)->Apply(sizes)->Unit(benchmark::kMillisecond);                  // NOLINT
+BENCHMARK(toHtmlEscaped)->Apply(levelArgs)->Unit(benchmark::kMillisecond);             // NOLINT
+BENCHMARK(toHtmlEscapedToSpan)->Apply(levelArgs)->Unit(benchmark::kMillisecond);       // NOLINT
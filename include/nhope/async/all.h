@@ -5,11 +5,15 @@
 #include <functional>
 #include <memory>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include <gsl/assert>
+
 #include "nhope/async/ao-context.h"
 #include "nhope/async/future.h"
+#include "nhope/seq/consumer.h"
 
 namespace nhope {
 
@@ -267,4 +271,260 @@ Future<std::tuple<T...>> all(AOContext& ctx, std::function<Future<T>(AOContext&)
     }
 }
 
+namespace detail {
+
+template<typename Fn>
+using AllFnResultType = typename FunctionProps<decltype(std::function(std::declval<Fn>()))>::ReturnType::Type;
+
+template<typename ResT>
+class AllVectorSink final
+{
+public:
+    using ResultType = std::vector<ResT>;
+
+    explicit AllVectorSink(std::size_t count)
+      : m_result(count)
+    {}
+
+    bool put(std::size_t i, ResT&& value)
+    {
+        m_result[i] = std::move(value);
+        return true;
+    }
+
+    ResultType take()
+    {
+        return std::move(m_result);
+    }
+
+private:
+    ResultType m_result;
+};
+
+class AllVoidSink final
+{
+public:
+    using ResultType = void;
+
+    explicit AllVoidSink(std::size_t /*count*/)
+    {}
+
+    bool put(std::size_t /*i*/)
+    {
+        return true;
+    }
+};
+
+template<typename ResT>
+class AllConsumerSink final
+{
+public:
+    using ResultType = void;
+
+    explicit AllConsumerSink(std::unique_ptr<Consumer<ResT>> consumer)
+      : m_consumer(std::move(consumer))
+    {}
+
+    bool put(std::size_t /*i*/, ResT&& value)
+    {
+        return m_consumer->consumeOwned(std::move(value)) == Consumer<ResT>::Status::Ok;
+    }
+
+private:
+    std::unique_ptr<Consumer<ResT>> m_consumer;
+};
+
+/*!
+ * Запускает fn для аргументов по порядку так, чтобы одновременно выполнялось не больше maxInFlight операций,
+ * и передает результаты в Sink
+ */
+template<typename ResT, typename ArgT, typename Fn, typename Sink>
+class AllLimitedOp final : public std::enable_shared_from_this<AllLimitedOp<ResT, ArgT, Fn, Sink>>
+{
+public:
+    using ResultType = typename Sink::ResultType;
+
+    AllLimitedOp(AOContext& parent, Fn fn, std::vector<ArgT> args, std::size_t maxInFlight, Sink sink)
+      : m_fn(std::move(fn))
+      , m_args(std::move(args))
+      , m_maxInFlight(maxInFlight)
+      , m_sink(std::move(sink))
+      , m_ctx(parent)
+    {}
+
+    Future<ResultType> start()
+    {
+        auto future = m_promise.future();
+        if (m_args.empty()) {
+            this->finish();
+            return future;
+        }
+
+        // Операции запускаются и завершаются в потоке контекста
+        m_ctx.exec([self = this->shared_from_this()] {
+            self->launchTasks();
+        });
+        return future;
+    }
+
+private:
+    void launchTasks()
+    {
+        // Готовые future завершают задачи прямо в цикле, повторный вход только продолжает его
+        if (m_launching) {
+            return;
+        }
+        m_launching = true;
+
+        while (!m_done && m_inFlight < m_maxInFlight && m_next < m_args.size()) {
+            const auto i = m_next++;
+            ++m_inFlight;
+            try {
+                this->launchTask(i);
+            } catch (...) {
+                this->taskFailed(std::current_exception());
+            }
+        }
+
+        m_launching = false;
+    }
+
+    void launchTask(std::size_t i)
+    {
+        auto future = m_fn(m_ctx, m_args[i]);
+        if constexpr (std::is_void_v<ResT>) {
+            future
+              .then(m_ctx,
+                    [i, self = this->shared_from_this()] {
+                        self->taskFinished(i);
+                    })
+              .fail(m_ctx, [self = this->shared_from_this()](auto e) {
+                  self->taskFailed(std::move(e));
+              });
+        } else {
+            future
+              .then(m_ctx,
+                    [i, self = this->shared_from_this()](auto r) {
+                        self->taskFinished(i, std::move(r));
+                    })
+              .fail(m_ctx, [self = this->shared_from_this()](auto e) {
+                  self->taskFailed(std::move(e));
+              });
+        }
+    }
+
+    template<typename... V>
+    void taskFinished(std::size_t i, V&&... value)
+    {
+        if (m_done) {
+            return;
+        }
+
+        --m_inFlight;
+        if (!m_sink.put(i, std::forward<V>(value)...)) {
+            // получатель результатов закрыт, оставшиеся операции отменяются
+            m_ctx.close();
+            this->finish();
+            return;
+        }
+
+        if (++m_finishedCount == m_args.size()) {
+            this->finish();
+            return;
+        }
+        this->launchTasks();
+    }
+
+    void taskFailed(std::exception_ptr e)
+    {
+        if (m_done) {
+            return;
+        }
+
+        m_done = true;
+        m_promise.setException(std::move(e));
+        m_ctx.close();
+    }
+
+    void finish()
+    {
+        m_done = true;
+        if constexpr (std::is_void_v<ResultType>) {
+            m_promise.setValue();
+        } else {
+            m_promise.setValue(m_sink.take());
+        }
+    }
+
+    Fn m_fn;
+    std::vector<ArgT> m_args;
+    const std::size_t m_maxInFlight;
+    Sink m_sink;
+
+    std::size_t m_next = 0;
+    std::size_t m_inFlight = 0;
+    std::size_t m_finishedCount = 0;
+    bool m_launching = false;
+    bool m_done = false;
+
+    Promise<ResultType> m_promise;
+    AOContext m_ctx;
+};
+
+}   // namespace detail
+
+/*!
+ * @brief То же, что all, но одновременно выполняется не больше maxInFlight вызовов fn.
+ *
+ * Следующий аргумент обрабатывается, когда завершается одна из выполняемых операций.
+ * При первой ошибке оставшиеся операции отменяются.
+ *
+ * @param maxInFlight максимальное количество одновременно выполняемых операций, больше 0
+ *
+ * @return Future<std::vector<FnRetValType>> или Future<void>, если Fn возвращает Future<void>.
+ */
+template<typename Fn, typename ArgT>
+auto allLimited(AOContext& ctx, Fn&& fn, std::vector<ArgT> args, std::size_t maxInFlight)
+{
+    using FnProps = FunctionProps<decltype(std::function(std::declval<Fn>()))>;
+
+    using FutureType = typename FnProps::ReturnType;
+    static_assert(isFuture<FutureType>, "function must return future");
+
+    using ResT = typename FutureType::Type;
+    static_assert(std::is_invocable_v<Fn, AOContext&, ArgT>, "Fn must accept AOContext and ArgT");
+    Expects(maxInFlight > 0);
+
+    using Sink = std::conditional_t<std::is_void_v<ResT>, detail::AllVoidSink, detail::AllVectorSink<ResT>>;
+    using Op = detail::AllLimitedOp<ResT, ArgT, std::decay_t<Fn>, Sink>;
+
+    const auto argCount = args.size();
+    auto op = std::make_shared<Op>(ctx, std::forward<Fn>(fn), std::move(args), maxInFlight, Sink(argCount));
+    return op->start();
+}
+
+/*!
+ * @brief То же, что allLimited, но результаты не накапливаются, а передаются consumer по мере готовности
+ *        (в порядке завершения операций).
+ *
+ * Если consumer закрывается, оставшиеся операции отменяются и Future завершается без ошибки.
+ *
+ * @return Future<void>, завершается, когда все результаты переданы consumer
+ */
+template<typename Fn, typename ArgT>
+Future<void> allToConsumer(AOContext& ctx, Fn&& fn, std::vector<ArgT> args,
+                           std::unique_ptr<Consumer<detail::AllFnResultType<Fn>>> consumer, std::size_t maxInFlight)
+{
+    using ResT = detail::AllFnResultType<Fn>;
+    static_assert(!std::is_void_v<ResT>, "function must return Future<T> with non-void T");
+    static_assert(std::is_invocable_v<Fn, AOContext&, ArgT>, "Fn must accept AOContext and ArgT");
+    Expects(maxInFlight > 0);
+
+    using Sink = detail::AllConsumerSink<ResT>;
+    using Op = detail::AllLimitedOp<ResT, ArgT, std::decay_t<Fn>, Sink>;
+
+    auto op = std::make_shared<Op>(ctx, std::forward<Fn>(fn), std::move(args), maxInFlight, Sink(std::move(consumer)));
+    return op->start();
+}
+
 }   // namespace nhope
@@ -200,6 +200,24 @@ private:
             m_d->setNewValue(value);
             return Consumer<T>::Status::Ok;
         };
+
+        typename Consumer<T>::Status consumeOwned(T&& value) override
+        {
+            if (m_d->closed.load()) {
+                return Consumer<T>::Status::Closed;
+            }
+            m_d->setNewValue(std::move(value));
+            return Consumer<T>::Status::Ok;
+        }
+
+        // Only the last value of the batch matters
+        typename Consumer<T>::Status consumeBatch(gsl::span<const T> values) override
+        {
+            if (values.empty()) {
+                return Consumer<T>::Status::Ok;
+            }
+            return this->consume(values.back());
+        }
     };
 };
 
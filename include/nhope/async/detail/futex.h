@@ -0,0 +1,26 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace nhope::detail {
+
+/**
+ * @brief Blocks the calling thread while value == expected.
+ *
+ * A substitute for std::atomic::wait from C++20.
+ * Spurious wakeups are possible, so the caller must recheck its condition.
+ */
+void futexWait(std::atomic<std::uint32_t>& value, std::uint32_t expected);
+
+/**
+ * @brief Same as futexWait, but no longer than timeout.
+ * @return false if the timeout has expired.
+ */
+bool futexWaitFor(std::atomic<std::uint32_t>& value, std::uint32_t expected, std::chrono::nanoseconds timeout);
+
+void futexWakeOne(std::atomic<std::uint32_t>& value);
+void futexWakeAll(std::atomic<std::uint32_t>& value);
+
+}   // namespace nhope::detail
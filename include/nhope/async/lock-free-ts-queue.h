@@ -0,0 +1,366 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "nhope/async/detail/futex.h"
+#include "nhope/utils/detail/compiler.h"
+
+namespace nhope {
+
+/**
+ * @brief Bounded lock-free MPMC queue (D. Vyukov's algorithm).
+ *
+ * Has the same interface and close semantics as TSQueue, so it can be used
+ * as the queue of Chan (Chan<T, LockFreeTSQueue>).
+ *
+ * Readers and writers block on futexes only when the queue is empty/full,
+ * the fast path is one CAS and no syscalls.
+ *
+ * @note The capacity is rounded up to a power of two (at least 2) and limited to maxCapacity
+ *       (the default "unbounded" capacity of TSQueue becomes maxCapacity).
+ */
+template<typename T>
+class LockFreeTSQueue final
+{
+public:
+    static constexpr std::size_t maxCapacity = std::size_t(1) << 16;
+
+    LockFreeTSQueue(const LockFreeTSQueue&) = delete;
+    LockFreeTSQueue& operator=(const LockFreeTSQueue&) = delete;
+
+    explicit LockFreeTSQueue(std::size_t capacity = maxCapacity)
+      : m_mask(roundCapacity(capacity) - 1)
+      , m_cells(std::make_unique<Cell[]>(m_mask + 1))   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    {
+        assert(capacity > 0);   // NOLINT
+
+        for (std::size_t i = 0; i <= m_mask; ++i) {
+            m_cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~LockFreeTSQueue()
+    {
+        const auto tail = m_tail.load(std::memory_order_acquire);
+        for (auto pos = m_head.load(std::memory_order_acquire); pos != tail; ++pos) {
+            m_cells[pos & m_mask].value().~T();
+        }
+    }
+
+    void close()
+    {
+        m_closed.store(true, std::memory_order_seq_cst);
+
+        m_readEpoch.fetch_add(oneEpoch, std::memory_order_seq_cst);
+        m_writeEpoch.fetch_add(oneEpoch, std::memory_order_seq_cst);
+        detail::futexWakeAll(m_readEpoch);
+        detail::futexWakeAll(m_writeEpoch);
+    }
+
+    template<typename Tv>
+    bool write(Tv&& value)
+    {
+        return this->writeUntil(std::forward<Tv>(value), std::nullopt);
+    }
+
+    template<typename Tv>
+    bool write(Tv&& value, std::chrono::nanoseconds timeout)
+    {
+        return this->writeUntil(std::forward<Tv>(value), Clock::now() + timeout);
+    }
+
+    bool read(T& value)
+    {
+        return this->readUntil(value, std::nullopt);
+    }
+
+    std::optional<T> read()
+    {
+        std::optional<T> retval;
+        this->readUntil(retval, std::nullopt);
+        return retval;
+    }
+
+    bool read(T& value, std::chrono::nanoseconds timeout)
+    {
+        return this->readUntil(value, Clock::now() + timeout);
+    }
+
+    /**
+     * @brief Writes all values of the range, waits while the queue is full.
+     * @return number of written values (less than the size of the range if the queue was closed)
+     */
+    template<typename Range>
+    std::size_t writeBatch(Range&& values)
+    {
+        std::size_t written = 0;
+        for (auto&& value : values) {
+            bool ok = false;
+            if constexpr (std::is_rvalue_reference_v<Range&&>) {
+                ok = this->write(std::move(value));
+            } else {
+                ok = this->write(value);
+            }
+            if (!ok) {
+                break;
+            }
+            ++written;
+        }
+        return written;
+    }
+
+    /**
+     * @brief Waits for the values and reads up to maxCount of them into the end of out.
+     * @return number of read values, 0 if the queue is closed and empty
+     */
+    template<typename Container>
+    std::size_t readBatch(Container& out, std::size_t maxCount)
+    {
+        return this->readBatchUntil(out, maxCount, std::nullopt);
+    }
+
+    template<typename Container>
+    std::size_t readBatch(Container& out, std::size_t maxCount, std::chrono::nanoseconds timeout)
+    {
+        return this->readBatchUntil(out, maxCount, Clock::now() + timeout);
+    }
+
+    /**
+     * @brief Moves all values of the queue into the end of out without waiting.
+     * @return number of moved values
+     */
+    template<typename Container>
+    std::size_t drainTo(Container& out)
+    {
+        std::size_t count = 0;
+        std::optional<T> value;
+        while (this->tryRead(value)) {
+            out.push_back(std::move(*value));
+            ++count;
+        }
+        return count;
+    }
+
+    [[nodiscard]] std::size_t size() const
+    {
+        const auto head = m_head.load(std::memory_order_acquire);
+        const auto tail = m_tail.load(std::memory_order_acquire);
+        const auto size = static_cast<std::ptrdiff_t>(tail - head);
+        return size > 0 ? static_cast<std::size_t>(size) : 0;
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return this->size() == 0;
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept
+    {
+        return m_mask + 1;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Cell final
+    {
+        std::atomic<std::size_t> seq;
+        std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+        T& value() noexcept
+        {
+            return *std::launder(reinterpret_cast<T*>(&storage));   // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+        }
+    };
+
+    static std::size_t roundCapacity(std::size_t capacity) noexcept
+    {
+        // The algorithm requires at least two cells
+        std::size_t result = 2;
+        while (result < capacity && result < maxCapacity) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    template<typename Tv>
+    bool writeUntil(Tv&& value, std::optional<Clock::time_point> deadline)
+    {
+        bool written = false;
+        this->waitUntil(m_writeEpoch, m_writeSleepers, deadline, [&] {
+            if (m_closed.load(std::memory_order_acquire)) {
+                return true;
+            }
+            written = this->tryWrite(std::forward<Tv>(value));
+            return written;
+        });
+        return written;
+    }
+
+    template<typename Out>
+    bool readUntil(Out& out, std::optional<Clock::time_point> deadline)
+    {
+        bool read = false;
+        this->waitUntil(m_readEpoch, m_readSleepers, deadline, [&] {
+            // The closed queue is drained, so closed flag must be checked before reading
+            const bool closed = m_closed.load(std::memory_order_acquire);
+            read = this->tryRead(out);
+            return read || closed;
+        });
+        return read;
+    }
+
+    template<typename Container>
+    std::size_t readBatchUntil(Container& out, std::size_t maxCount, std::optional<Clock::time_point> deadline)
+    {
+        if (maxCount == 0) {
+            return 0;
+        }
+
+        std::optional<T> value;
+        if (!this->readUntil(value, deadline)) {
+            return 0;
+        }
+
+        std::size_t count = 0;
+        do {
+            out.push_back(std::move(*value));
+            ++count;
+        } while (count < maxCount && this->tryRead(value));
+        return count;
+    }
+
+    template<typename Tv>
+    bool tryWrite(Tv&& value)
+    {
+        auto pos = m_tail.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            const auto seq = cell->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;   // The queue is full
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (&cell->storage) T(std::forward<Tv>(value));
+        cell->seq.store(pos + 1, std::memory_order_release);
+
+        notify(m_readEpoch);
+        return true;
+    }
+
+    template<typename Out>
+    bool tryRead(Out& out)
+    {
+        auto pos = m_head.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            const auto seq = cell->seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;   // The queue is empty
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        out = std::move(cell->value());
+        cell->value().~T();
+        cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+
+        notify(m_writeEpoch);
+        return true;
+    }
+
+    /* Eventcount. The lowest bit of the epoch tells that there are sleeping waiters,
+       the rest is the counter of notifications. The waiter sets the bit, rechecks its condition
+       and sleeps while the epoch is unchanged; the notifier makes a syscall only if the bit is set.
+       The fences order the setting of the bit against the publication of the data. */
+    static constexpr std::uint32_t hasWaiters = 1;
+    static constexpr std::uint32_t oneEpoch = 2;
+
+    static void notify(std::atomic<std::uint32_t>& epoch)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto cur = epoch.load(std::memory_order_relaxed);
+        // cur + 1 clears hasWaiters and increments the counter
+        if ((cur & hasWaiters) != 0 && epoch.compare_exchange_strong(cur, cur + 1, std::memory_order_relaxed)) {
+            detail::futexWakeOne(epoch);
+        }
+    }
+
+    template<typename DoneFn>
+    static void waitUntil(std::atomic<std::uint32_t>& epoch, std::atomic<std::uint32_t>& sleepers,
+                          std::optional<Clock::time_point> deadline, DoneFn done)
+    {
+        if (done()) {
+            return;
+        }
+
+        bool finished = false;
+        while (!finished) {
+            sleepers.fetch_add(1, std::memory_order_relaxed);
+            const auto curEpoch = epoch.fetch_or(hasWaiters, std::memory_order_relaxed) | hasWaiters;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            finished = done();
+            if (!finished) {
+                bool timeout = false;
+                if (deadline.has_value()) {
+                    timeout = !detail::futexWaitFor(epoch, curEpoch, *deadline - Clock::now());
+                } else {
+                    detail::futexWait(epoch, curEpoch);
+                }
+                finished = done() || timeout;
+            }
+
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        /* The notifier clears hasWaiters and wakes only one waiter, so the rest of the sleepers
+           could miss notifications made in the meantime. Pass the baton to the next one. */
+        if (sleepers.load(std::memory_order_relaxed) != 0) {
+            epoch.fetch_add(oneEpoch, std::memory_order_relaxed);
+            detail::futexWakeOne(epoch);
+        }
+    }
+
+    const std::size_t m_mask;
+    const std::unique_ptr<Cell[]> m_cells;   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+
+    alignas(cacheLineSize) std::atomic<std::size_t> m_tail = 0;
+    alignas(cacheLineSize) std::atomic<std::size_t> m_head = 0;
+
+    alignas(cacheLineSize) std::atomic<std::uint32_t> m_readEpoch = 0;
+    std::atomic<std::uint32_t> m_readSleepers = 0;
+
+    alignas(cacheLineSize) std::atomic<std::uint32_t> m_writeEpoch = 0;
+    std::atomic<std::uint32_t> m_writeSleepers = 0;
+
+    std::atomic<bool> m_closed = false;
+};
+
+}   // namespace nhope
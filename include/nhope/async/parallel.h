@@ -0,0 +1,268 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "nhope/async/executor.h"
+#include "nhope/async/future.h"
+#include "nhope/async/thread-pool-executor.h"
+
+namespace nhope {
+
+namespace detail {
+
+inline std::size_t executorParallelism(Executor& executor)
+{
+    if (dynamic_cast<SequenceExecutor*>(&executor) != nullptr) {
+        return 1;
+    }
+    if (auto* pool = dynamic_cast<ThreadPoolExecutor*>(&executor); pool != nullptr) {
+        return std::max<std::size_t>(pool->threadCount(), 1);
+    }
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+/*!
+ * Fork-join над диапазоном индексов.
+ *
+ * Исполнители берут из общего счетчика куски убывающего размера (remaining / (2 * workerCount),
+ * но не меньше grain): в начале куски крупные и накладные расходы малы, в конце мелкие и
+ * исполнители заканчивают одновременно. Последний завершившийся исполнитель разрешает Promise.
+ * На операцию приходится одно выделение памяти под состояние, задачи executor-а хранят только
+ * указатель на него.
+ */
+template<typename T, typename ChunkFn, typename FinishFn>
+class ForkJoin final : public std::enable_shared_from_this<ForkJoin<T, ChunkFn, FinishFn>>
+{
+public:
+    ForkJoin(std::size_t first, std::size_t last, std::size_t grain, std::size_t workerCount, ChunkFn chunkFn,
+             FinishFn finishFn)
+      : m_last(last)
+      , m_grain(grain)
+      , m_workerCount(workerCount)
+      , m_next(first)
+      , m_runningCount(workerCount)
+      , m_chunkFn(std::move(chunkFn))
+      , m_finishFn(std::move(finishFn))
+    {}
+
+    Future<T> start(Executor& executor)
+    {
+        auto future = m_promise.future();
+        for (std::size_t i = 0; i < m_workerCount; ++i) {
+            executor.exec([self = this->shared_from_this()] {
+                self->work();
+            });
+        }
+        return future;
+    }
+
+private:
+    void work()
+    {
+        const auto worker = m_workerIndex.fetch_add(1, std::memory_order_relaxed);
+        try {
+            std::size_t begin = 0;
+            std::size_t end = 0;
+            while (this->nextChunk(begin, end)) {
+                m_chunkFn(worker, begin, end);
+            }
+        } catch (...) {
+            this->fail(std::current_exception());
+        }
+
+        if (m_runningCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            this->finish();
+        }
+    }
+
+    bool nextChunk(std::size_t& begin, std::size_t& end)
+    {
+        auto current = m_next.load(std::memory_order_relaxed);
+        while (current < m_last) {
+            const auto remaining = m_last - current;
+            const auto chunk = std::min(remaining, std::max(m_grain, remaining / (2 * m_workerCount)));
+            if (m_next.compare_exchange_weak(current, current + chunk, std::memory_order_relaxed)) {
+                begin = current;
+                end = current + chunk;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void fail(std::exception_ptr error)
+    {
+        // Оставшиеся куски не обрабатываются
+        m_next.store(m_last, std::memory_order_relaxed);
+
+        std::scoped_lock lock(m_errorMutex);
+        if (m_error == nullptr) {
+            m_error = std::move(error);
+        }
+    }
+
+    void finish()
+    {
+        if (m_error != nullptr) {
+            m_promise.setException(m_error);
+            return;
+        }
+
+        try {
+            if constexpr (std::is_void_v<T>) {
+                m_finishFn();
+                m_promise.setValue();
+            } else {
+                m_promise.setValue(m_finishFn());
+            }
+        } catch (...) {
+            m_promise.setException(std::current_exception());
+        }
+    }
+
+    const std::size_t m_last;
+    const std::size_t m_grain;
+    const std::size_t m_workerCount;
+    std::atomic<std::size_t> m_next;
+    std::atomic<std::size_t> m_runningCount;
+    std::atomic<std::size_t> m_workerIndex = 0;
+
+    ChunkFn m_chunkFn;
+    FinishFn m_finishFn;
+
+    std::mutex m_errorMutex;
+    std::exception_ptr m_error;
+    Promise<T> m_promise;
+};
+
+// Сколько исполнителей запускать и минимальный размер куска
+struct ForkJoinPlan
+{
+    std::size_t workerCount;
+    std::size_t grain;
+};
+
+inline ForkJoinPlan planForkJoin(Executor& executor, std::size_t count, std::size_t grain)
+{
+    static constexpr std::size_t chunksPerWorker = 16;
+
+    const auto parallelism = executorParallelism(executor);
+    if (grain == 0) {
+        grain = std::max<std::size_t>(count / (parallelism * chunksPerWorker), 1);
+    }
+    const auto workerCount = std::clamp<std::size_t>((count + grain - 1) / grain, 1, parallelism);
+    return {workerCount, grain};
+}
+
+template<typename T, typename ChunkFn, typename FinishFn>
+Future<T> forkJoin(Executor& executor, std::size_t first, std::size_t last, std::size_t grain, ChunkFn&& chunkFn,
+                   FinishFn&& finishFn)
+{
+    const auto plan = planForkJoin(executor, last - first, grain);
+    auto op = std::make_shared<ForkJoin<T, std::decay_t<ChunkFn>, std::decay_t<FinishFn>>>(
+      first, last, plan.grain, plan.workerCount, std::forward<ChunkFn>(chunkFn), std::forward<FinishFn>(finishFn));
+    return op->start(executor);
+}
+
+}   // namespace detail
+
+/*!
+ * @brief Вызывает fn для каждого индекса из [first, last) на исполнителях executor-а.
+ *
+ * Fn принимает индекс (void(std::size_t)) или границы куска (void(std::size_t begin, std::size_t end)).
+ * Диапазон делится на куски не меньше grain, при grain == 0 размер подбирается по длине диапазона
+ * и количеству потоков executor-а. Исключение из fn останавливает обработку и передается в Future.
+ */
+template<typename Fn>
+Future<void> parallelFor(Executor& executor, std::size_t first, std::size_t last, Fn&& fn, std::size_t grain = 0)
+{
+    if (first >= last) {
+        return makeReadyFuture();
+    }
+
+    return detail::forkJoin<void>(
+      executor, first, last, grain,
+      [fn = std::forward<Fn>(fn)](std::size_t /*worker*/, std::size_t begin, std::size_t end) mutable {
+          if constexpr (std::is_invocable_v<Fn&, std::size_t, std::size_t>) {
+              fn(begin, end);
+          } else {
+              for (auto i = begin; i != end; ++i) {
+                  fn(i);
+              }
+          }
+      },
+      [] {});
+}
+
+/*!
+ * @brief Параллельный аналог std::transform: *(out + i) = fn(*(first + i)).
+ *
+ * Итераторы должны быть random access, данные должны жить до завершения Future.
+ */
+template<typename InIt, typename OutIt, typename Fn>
+Future<void> parallelTransform(Executor& executor, InIt first, InIt last, OutIt out, Fn&& fn, std::size_t grain = 0)
+{
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+    return parallelFor(
+      executor, 0, count,
+      [first, out, fn = std::forward<Fn>(fn)](std::size_t begin, std::size_t end) mutable {
+          std::transform(first + static_cast<std::ptrdiff_t>(begin), first + static_cast<std::ptrdiff_t>(end),
+                         out + static_cast<std::ptrdiff_t>(begin), fn);
+      },
+      grain);
+}
+
+/*!
+ * @brief Параллельный аналог std::reduce.
+ *
+ * Каждый исполнитель сворачивает свои куски в частичный результат, в конце частичные
+ * результаты сворачиваются с init. Порядок применения op не определен, поэтому op должна быть
+ * ассоциативной и коммутативной и принимать как (T, элемент), так и (T, T).
+ */
+template<typename InIt, typename T, typename Op>
+Future<T> parallelReduce(Executor& executor, InIt first, InIt last, T init, Op&& op, std::size_t grain = 0)
+{
+    const auto count = static_cast<std::size_t>(std::distance(first, last));
+    if (count == 0) {
+        return makeReadyFuture<T>(std::move(init));
+    }
+
+    const auto plan = detail::planForkJoin(executor, count, grain);
+    auto partials = std::make_shared<std::vector<std::optional<T>>>(plan.workerCount);
+    auto sharedOp = std::make_shared<std::decay_t<Op>>(std::forward<Op>(op));
+
+    return detail::forkJoin<T>(
+      executor, 0, count, plan.grain,
+      [first, partials, sharedOp](std::size_t worker, std::size_t begin, std::size_t end) {
+          auto& acc = (*partials)[worker];
+          auto it = first + static_cast<std::ptrdiff_t>(begin);
+          const auto chunkEnd = first + static_cast<std::ptrdiff_t>(end);
+          if (!acc.has_value()) {
+              acc.emplace(*it++);
+          }
+          for (; it != chunkEnd; ++it) {
+              *acc = (*sharedOp)(std::move(*acc), *it);
+          }
+      },
+      [partials, sharedOp, init = std::move(init)]() mutable {
+          for (auto& partial : *partials) {
+              if (partial.has_value()) {
+                  init = (*sharedOp)(std::move(init), std::move(*partial));
+              }
+          }
+          return std::move(init);
+      });
+}
+
+}   // namespace nhope
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <map>
 #include <optional>
+#include <vector>
 
 #include <nhope/async/manageable-task.h>
 #include <nhope/utils/noncopyable.h>
@@ -9,17 +13,51 @@
 
 namespace nhope {
 
+/*!
+ * Планировщик задач с приоритетами.
+ *
+ * Одновременно выполняется не больше Options::concurrency задач. Новая задача с большим приоритетом
+ * вытесняет (ставит на паузу) выполняемую задачу с наименьшим приоритетом.
+ */
 class Scheduler final : Noncopyable
 {
 public:
     using TaskId = uint64_t;
 
+    struct Options
+    {
+        // Количество одновременно выполняемых задач
+        std::size_t concurrency = 1;
+
+        /* Если задан, задача, выполняющаяся дольше кванта, уступает место ожидающей задаче
+           с тем же приоритетом, так задачи одного приоритета выполняются по очереди */
+        std::optional<std::chrono::nanoseconds> timeSlice;
+    };
+
+    struct TaskStats
+    {
+        std::chrono::nanoseconds waitTime{};   // время в очереди на запуск
+        std::chrono::nanoseconds runTime{};    // время выполнения
+    };
+
+    struct PriorityStats
+    {
+        std::size_t finishedCount{};           // количество завершенных и удаленных задач
+        std::chrono::nanoseconds waitTime{};   // суммарное время в очереди на запуск
+        std::chrono::nanoseconds runTime{};    // суммарное время выполнения
+    };
+
     Scheduler();
+    explicit Scheduler(const Options& options);
     ~Scheduler();
 
     TaskId push(ManageableTask::TaskFunction task, int priority = 0);
 
+    /*!
+     * Возвращает идентификатор выполняемой задачи с наибольшим приоритетом
+     */
     [[nodiscard]] std::optional<TaskId> getActiveTaskId() const noexcept;
+    [[nodiscard]] std::vector<TaskId> getActiveTaskIds() const;
 
     [[nodiscard]] std::optional<ManageableTask::State> getState(TaskId id) const noexcept;
 
@@ -56,9 +94,16 @@ public:
 
     [[nodiscard]] std::size_t size() const noexcept;
 
+    [[nodiscard]] std::optional<TaskStats> getTaskStats(TaskId id) const;
+
+    /*!
+     * Статистика завершенных задач по приоритетам
+     */
+    [[nodiscard]] std::map<int, PriorityStats> getStats() const;
+
 private:
     class Impl;
-    static constexpr std::size_t implSize{176};
+    static constexpr std::size_t implSize{384};
     detail::FastPimpl<Impl, implSize> m_impl;
 };
 
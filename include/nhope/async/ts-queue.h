@@ -2,11 +2,15 @@
 
 #include <cassert>
 
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
+#include <iterator>
 #include <limits>
 #include <list>
 #include <mutex>
 #include <optional>
+#include <type_traits>
 #include <utility>
 
 namespace nhope {
@@ -120,6 +124,93 @@ public:
         return true;
     }
 
+    /**
+     * @brief Writes all values of the range, waits while the queue is full.
+     *
+     * Values are moved if the range is passed as rvalue.
+     * The nodes are allocated outside of the lock and the whole batch is linked
+     * into the queue under one lock with one wakeup of the readers.
+     *
+     * @return number of written values (less than the size of the range if the queue was closed)
+     */
+    template<typename Range>
+    std::size_t writeBatch(Range&& values)
+    {
+        std::list<T> batch;
+        for (auto&& value : values) {
+            if constexpr (std::is_rvalue_reference_v<Range&&>) {
+                batch.emplace_back(std::move(value));
+            } else {
+                batch.emplace_back(value);
+            }
+        }
+
+        std::size_t written = 0;
+        std::unique_lock lock(m_mutex);
+        while (!batch.empty()) {
+            m_wcv.wait(lock, [this] {
+                return m_closed || m_values.size() < m_capacity;
+            });
+
+            if (m_closed) {
+                break;
+            }
+
+            const auto count = std::min(m_capacity - m_values.size(), batch.size());
+            if (count == batch.size()) {
+                m_values.splice(m_values.end(), batch);
+            } else {
+                m_values.splice(m_values.end(), batch, batch.begin(), std::next(batch.begin(), count));
+            }
+
+            written += count;
+            notifyAbout(m_rcv, count);
+        }
+
+        return written;
+    }
+
+    /**
+     * @brief Waits for the values and reads up to maxCount of them into the end of out.
+     * @return number of read values, 0 if the queue is closed and empty
+     */
+    template<typename Container>
+    std::size_t readBatch(Container& out, std::size_t maxCount)
+    {
+        std::unique_lock lock(m_mutex);
+        m_rcv.wait(lock, [this] {
+            return m_closed || !m_values.empty();
+        });
+
+        return this->takeBatch(lock, out, maxCount);
+    }
+
+    /**
+     * @brief Same as readBatch, but waits for the values no longer than timeout.
+     * @return number of read values, 0 if the queue is closed and empty or the timeout has expired
+     */
+    template<typename Container>
+    std::size_t readBatch(Container& out, std::size_t maxCount, std::chrono::nanoseconds timeout)
+    {
+        std::unique_lock lock(m_mutex);
+        m_rcv.wait_for(lock, timeout, [this] {
+            return m_closed || !m_values.empty();
+        });
+
+        return this->takeBatch(lock, out, maxCount);
+    }
+
+    /**
+     * @brief Moves all values of the queue into the end of out without waiting.
+     * @return number of moved values
+     */
+    template<typename Container>
+    std::size_t drainTo(Container& out)
+    {
+        std::unique_lock lock(m_mutex);
+        return this->takeBatch(lock, out, m_values.size());
+    }
+
     [[nodiscard]] std::size_t size() const
     {
         std::unique_lock lock(m_mutex);
@@ -133,6 +224,34 @@ public:
     }
 
 private:
+    static void notifyAbout(std::condition_variable& cv, std::size_t count)
+    {
+        if (count == 1) {
+            cv.notify_one();
+        } else if (count > 1) {
+            cv.notify_all();
+        }
+    }
+
+    /* Unlinks the segment under the lock, moves the values out of the lock */
+    template<typename Container>
+    std::size_t takeBatch(std::unique_lock<std::mutex>& lock, Container& out, std::size_t maxCount)
+    {
+        std::list<T> batch;
+        const auto count = std::min(maxCount, m_values.size());
+        if (count == m_values.size()) {
+            batch.splice(batch.end(), m_values);
+        } else {
+            batch.splice(batch.end(), m_values, m_values.begin(), std::next(m_values.begin(), count));
+        }
+
+        notifyAbout(m_wcv, count);
+        lock.unlock();
+
+        out.insert(out.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        return count;
+    }
+
     const std::size_t m_capacity;
 
     mutable std::mutex m_mutex;
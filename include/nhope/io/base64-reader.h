@@ -0,0 +1,26 @@
+#pragma once
+
+#include <memory>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/io/io-device.h"
+
+namespace nhope {
+
+class Base64Reader;
+using Base64ReaderPtr = std::unique_ptr<Base64Reader>;
+
+/**
+ * @brief Reader of bytes decoded from the base64 text of the origin reader.
+ *
+ * The text is decoded incrementally, end of the origin reader ends the text.
+ * Invalid text is reported to the read handler as Base64ParseError.
+ */
+class Base64Reader : public Reader
+{
+public:
+    static Base64ReaderPtr create(AOContext& aoCtx, Reader& reader, bool skipSpaces = true);
+    static Base64ReaderPtr create(AOContext& aoCtx, ReaderPtr reader, bool skipSpaces = true);
+};
+
+}   // namespace nhope
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <memory>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/io/io-device.h"
+
+namespace nhope {
+
+class Base64Writter;
+using Base64WritterPtr = std::unique_ptr<Base64Writter>;
+
+/**
+ * @brief Writter, which encodes the data to base64 and writes the text to the origin writter.
+ *
+ * write reports the number of accepted bytes after the encoded text is written,
+ * finish writes the last group with padding.
+ */
+class Base64Writter : public Writter
+{
+public:
+    virtual void finish(IOHandler handler) = 0;
+
+    static Base64WritterPtr create(AOContext& aoCtx, Writter& writter);
+    static Base64WritterPtr create(AOContext& aoCtx, WritterPtr writter);
+};
+
+}   // namespace nhope
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/async/future.h"
+#include "nhope/io/io-device.h"
+#include "nhope/utils/bits.h"
+#include "nhope/utils/noncopyable.h"
+
+namespace nhope {
+
+class BitStreamReader;
+using BitStreamReaderPtr = std::unique_ptr<BitStreamReader>;
+
+using BitsHandler = std::function<void(std::exception_ptr, std::uint64_t)>;
+
+class UnexpectedEndOfStream final : public std::runtime_error
+{
+public:
+    UnexpectedEndOfStream();
+};
+
+/**
+ * @brief Reads bit fields from a Reader.
+ *
+ * The data is read from the origin reader in chunks and parsed by BitReader, so most fields
+ * are taken from the buffer without reading the device.
+ */
+class BitStreamReader : public Noncopyable
+{
+public:
+    virtual ~BitStreamReader() = default;
+
+    /**
+     * @brief Reads the next field of bitCount bits (bitCount <= 64).
+     *        If the stream ends inside the field, the handler gets UnexpectedEndOfStream.
+     */
+    virtual void read(std::size_t bitCount, BitsHandler handler) = 0;
+
+    static BitStreamReaderPtr create(AOContext& aoCtx, Reader& reader, BitOrder order = BitOrder::MsbFirst);
+    static BitStreamReaderPtr create(AOContext& aoCtx, ReaderPtr reader, BitOrder order = BitOrder::MsbFirst);
+};
+
+Future<std::uint64_t> readBits(BitStreamReader& reader, std::size_t bitCount);
+
+}   // namespace nhope
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 #include "asio/serial_port.hpp"
 #include "nhope/io/serial-port.h"
 
@@ -8,5 +11,10 @@ namespace nhope::detail {
 void setRTS(asio::serial_port& serialPort, bool state);
 void setDTR(asio::serial_port& serialPort, bool state);
 SerialPortParams::ModemControl getModemControl(asio::serial_port& serialPort);
+std::size_t bytesAvailable(asio::serial_port& serialPort);
+
+void setBaudrate(asio::serial_port& serialPort, std::uint32_t baudrate);
+void setLowLatency(asio::serial_port& serialPort, bool state);
+void setReadThreshold(asio::serial_port& serialPort, std::uint8_t minSize);
 
 }   // namespace nhope::detail
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include <gsl/span>
+
+#include "nhope/async/ao-context-error.h"
+#include "nhope/async/future.h"
+#include "nhope/io/io-device.h"
+#include "nhope/utils/detail/ref-ptr.h"
+#include "nhope/utils/md5.h"
+
+namespace nhope {
+
+namespace detail {
+
+template<typename Hash>
+class DigestOp final : public BaseRefCounter
+{
+public:
+    static constexpr std::size_t bufferSize = 64 * 1024;
+
+    explicit DigestOp(Reader& dev)
+      : m_dev(dev)
+      , m_buf(bufferSize)
+    {}
+
+    ~DigestOp()
+    {
+        if (!m_promise.satisfied()) {
+            m_promise.setException(std::make_exception_ptr(AsyncOperationWasCancelled()));
+        }
+    }
+
+    Future<typename Hash::Digest> start()
+    {
+        auto future = m_promise.future();
+        this->readNextPortion();
+        return future;
+    }
+
+private:
+    void readNextPortion()
+    {
+        m_dev.read(m_buf, [self = refPtrFromRawPtr(this)](auto err, auto count) {
+            self->readPortionHandler(std::move(err), count);
+        });
+    }
+
+    void readPortionHandler(std::exception_ptr err, std::size_t count)
+    {
+        if (err) {
+            m_promise.setException(std::move(err));
+            return;
+        }
+
+        if (count == 0) {
+            // EOF
+            m_promise.setValue(m_hash.digest());
+            return;
+        }
+
+        m_hash.update(gsl::span<const std::uint8_t>(m_buf).first(count));
+        this->readNextPortion();
+    }
+
+    Reader& m_dev;   // NOLINT cppcoreguidelines-avoid-const-or-ref-data-members
+    Promise<typename Hash::Digest> m_promise;
+    std::vector<std::uint8_t> m_buf;
+    Hash m_hash;
+};
+
+}   // namespace detail
+
+/**
+ * @brief Hashes the data of dev until EOF. The data is hashed as it is read, through one buffer
+ *        of DigestOp::bufferSize bytes.
+ *
+ * Hash needs Digest type, update(gsl::span<const std::uint8_t>) and digest() (as MD5 has).
+ */
+template<typename Hash = MD5>
+Future<typename Hash::Digest> digest(Reader& dev)
+{
+    return detail::makeRefPtr<detail::DigestOp<Hash>>(dev)->start();
+}
+
+/**
+ * @brief MD5 of the data of every device until EOF, the devices are hashed at once in SIMD lanes by MultiMD5.
+ *
+ * Each round reads a portion of DigestOp::bufferSize bytes from every device that has not reached EOF,
+ * so a round waits for the slowest device and the memory is devs.size() buffers.
+ * Many files (e.g. thousands) are better passed by groups of a multiple of MD5::laneCount().
+ * The devices must exist until the future is resolved.
+ */
+Future<std::vector<MD5::Digest>> digestMany(gsl::span<Reader* const> devs);
+
+}   // namespace nhope
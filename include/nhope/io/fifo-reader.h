@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/io/io-device.h"
+
+namespace nhope {
+
+class FifoReader;
+using FifoReaderPtr = std::unique_ptr<FifoReader>;
+
+/**
+ * @brief Buffered reader.
+ *
+ * Reads the origin reader by big portions directly into the internal ring buffer
+ * and serves small reads from it (e.g. readUntil/readLine which read byte by byte).
+ * Reads that are bigger than the buffer go to the origin reader as is.
+ */
+class FifoReader : public Reader
+{
+public:
+    static constexpr std::size_t bufferSize = 16 * 1024;
+
+    /**
+     * @brief Number of bytes that can be read without reading the origin reader
+     */
+    [[nodiscard]] virtual std::size_t buffered() const = 0;
+
+    static FifoReaderPtr create(AOContext& aoCtx, Reader& reader);
+    static FifoReaderPtr create(AOContext& aoCtx, ReaderPtr reader);
+};
+
+}   // namespace nhope
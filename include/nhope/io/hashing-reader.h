@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <utility>
+
+#include <gsl/span>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/async/executor.h"
+#include "nhope/io/io-device.h"
+#include "nhope/utils/md5.h"
+
+namespace nhope {
+
+template<typename Hash>
+class HashingReader;
+
+template<typename Hash>
+using HashingReaderPtr = std::unique_ptr<HashingReader<Hash>>;
+
+/**
+ * @brief Reader, which passes the data of the origin reader through and hashes it on the way,
+ *        so the data is checked in the same pass it is consumed (e.g. by copy).
+ *
+ * Hash needs Digest type, update(gsl::span<const std::uint8_t>) and digest() (as MD5 and CRC32C have).
+ */
+template<typename Hash = MD5>
+class HashingReader : public Reader
+{
+public:
+    using Digest = typename Hash::Digest;
+
+    /**
+     * @brief Digest of the data read since the creation or the previous call.
+     *        Must not be called while a read is in progress.
+     */
+    virtual Digest digest() = 0;
+
+    static HashingReaderPtr<Hash> create(AOContext& aoCtx, Reader& reader);
+    static HashingReaderPtr<Hash> create(AOContext& aoCtx, ReaderPtr reader);
+};
+
+namespace detail {
+
+template<typename Hash>
+class HashingReaderImpl final : public HashingReader<Hash>
+{
+public:
+    HashingReaderImpl(AOContext& parent, Reader& reader)
+      : m_originReader(reader)
+      , m_aoCtx(parent)
+    {}
+
+    ~HashingReaderImpl() final
+    {
+        m_aoCtx.close();
+    }
+
+    void read(gsl::span<std::uint8_t> buf, IOHandler handler) final
+    {
+        m_originReader.read(
+          buf, [this, buf, aoCtx = AOContextRef(m_aoCtx), handler = std::move(handler)](auto err, auto size) mutable {
+              aoCtx.exec(
+                [this, buf, err = std::move(err), size, handler = std::move(handler)] {
+                    if (err == nullptr) {
+                        m_hash.update(buf.first(size));
+                    }
+                    handler(std::move(err), size);
+                },
+                Executor::ExecMode::ImmediatelyIfPossible);
+          });
+    }
+
+    typename Hash::Digest digest() final
+    {
+        return m_hash.digest();
+    }
+
+private:
+    Reader& m_originReader;
+    Hash m_hash;
+    AOContext m_aoCtx;
+};
+
+template<typename Hash>
+class HashingReaderOwnerImpl final : public HashingReader<Hash>
+{
+public:
+    HashingReaderOwnerImpl(AOContext& parent, ReaderPtr reader)
+      : m_originReader(std::move(reader))
+      , m_hashingReader(parent, *m_originReader)
+    {}
+
+    void read(gsl::span<std::uint8_t> buf, IOHandler handler) final
+    {
+        m_hashingReader.read(buf, std::move(handler));
+    }
+
+    typename Hash::Digest digest() final
+    {
+        return m_hashingReader.digest();
+    }
+
+private:
+    ReaderPtr m_originReader;
+    HashingReaderImpl<Hash> m_hashingReader;
+};
+
+}   // namespace detail
+
+template<typename Hash>
+HashingReaderPtr<Hash> HashingReader<Hash>::create(AOContext& aoCtx, Reader& reader)
+{
+    return std::make_unique<detail::HashingReaderImpl<Hash>>(aoCtx, reader);
+}
+
+template<typename Hash>
+HashingReaderPtr<Hash> HashingReader<Hash>::create(AOContext& aoCtx, ReaderPtr reader)
+{
+    return std::make_unique<detail::HashingReaderOwnerImpl<Hash>>(aoCtx, std::move(reader));
+}
+
+}   // namespace nhope
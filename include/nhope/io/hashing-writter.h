@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <utility>
+
+#include <gsl/span>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/async/executor.h"
+#include "nhope/io/io-device.h"
+#include "nhope/utils/md5.h"
+
+namespace nhope {
+
+template<typename Hash>
+class HashingWritter;
+
+template<typename Hash>
+using HashingWritterPtr = std::unique_ptr<HashingWritter<Hash>>;
+
+/**
+ * @brief Writter, which passes the data to the origin writter and hashes the written part of it,
+ *        so the checksum of a transfer (e.g. by copy) is computed in the same pass.
+ *
+ * Hash needs Digest type, update(gsl::span<const std::uint8_t>) and digest() (as MD5 and CRC32C have).
+ */
+template<typename Hash = MD5>
+class HashingWritter : public Writter
+{
+public:
+    using Digest = typename Hash::Digest;
+
+    /**
+     * @brief Digest of the data written since the creation or the previous call.
+     *        Must not be called while a write is in progress.
+     */
+    virtual Digest digest() = 0;
+
+    static HashingWritterPtr<Hash> create(AOContext& aoCtx, Writter& writter);
+    static HashingWritterPtr<Hash> create(AOContext& aoCtx, WritterPtr writter);
+};
+
+namespace detail {
+
+template<typename Hash>
+class HashingWritterImpl final : public HashingWritter<Hash>
+{
+public:
+    HashingWritterImpl(AOContext& parent, Writter& writter)
+      : m_originWritter(writter)
+      , m_aoCtx(parent)
+    {}
+
+    ~HashingWritterImpl() final
+    {
+        m_aoCtx.close();
+    }
+
+    void write(gsl::span<const std::uint8_t> data, IOHandler handler) final
+    {
+        m_originWritter.write(
+          data, [this, data, aoCtx = AOContextRef(m_aoCtx), handler = std::move(handler)](auto err, auto size) mutable {
+              aoCtx.exec(
+                [this, data, err = std::move(err), size, handler = std::move(handler)] {
+                    if (err == nullptr) {
+                        m_hash.update(data.first(size));
+                    }
+                    handler(std::move(err), size);
+                },
+                Executor::ExecMode::ImmediatelyIfPossible);
+          });
+    }
+
+    typename Hash::Digest digest() final
+    {
+        return m_hash.digest();
+    }
+
+private:
+    Writter& m_originWritter;
+    Hash m_hash;
+    AOContext m_aoCtx;
+};
+
+template<typename Hash>
+class HashingWritterOwnerImpl final : public HashingWritter<Hash>
+{
+public:
+    HashingWritterOwnerImpl(AOContext& parent, WritterPtr writter)
+      : m_originWritter(std::move(writter))
+      , m_hashingWritter(parent, *m_originWritter)
+    {}
+
+    void write(gsl::span<const std::uint8_t> data, IOHandler handler) final
+    {
+        m_hashingWritter.write(data, std::move(handler));
+    }
+
+    typename Hash::Digest digest() final
+    {
+        return m_hashingWritter.digest();
+    }
+
+private:
+    WritterPtr m_originWritter;
+    HashingWritterImpl<Hash> m_hashingWritter;
+};
+
+}   // namespace detail
+
+template<typename Hash>
+HashingWritterPtr<Hash> HashingWritter<Hash>::create(AOContext& aoCtx, Writter& writter)
+{
+    return std::make_unique<detail::HashingWritterImpl<Hash>>(aoCtx, writter);
+}
+
+template<typename Hash>
+HashingWritterPtr<Hash> HashingWritter<Hash>::create(AOContext& aoCtx, WritterPtr writter)
+{
+    return std::make_unique<detail::HashingWritterOwnerImpl<Hash>>(aoCtx, std::move(writter));
+}
+
+}   // namespace nhope
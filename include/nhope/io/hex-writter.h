@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/io/io-device.h"
+
+namespace nhope {
+
+class HexWritter;
+using HexWritterPtr = std::unique_ptr<HexWritter>;
+
+/**
+ * @brief Writter, which writes the data as hex text to the origin writter (e.g. a log of device traffic).
+ *
+ * write reports the number of accepted bytes after their text is written.
+ */
+class HexWritter : public Writter
+{
+public:
+    static HexWritterPtr create(AOContext& aoCtx, Writter& writter);
+    static HexWritterPtr create(AOContext& aoCtx, WritterPtr writter);
+};
+
+}   // namespace nhope
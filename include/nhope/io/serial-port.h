@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
@@ -70,6 +72,20 @@ struct SerialPortParams
     std::optional<Parity> parity;
     std::optional<StopBits> stopbits;
     std::optional<FlowControl> flow;
+
+    // Any baud rate (e.g. 921600 or 3000000), overrides baudrate. Linux sets it by termios2 with BOTHER
+    std::optional<std::uint32_t> customBaudrate;
+
+    /* Linux-specific options for low latency, ignored on other platforms */
+
+    // ASYNC_LOW_LATENCY, USB-serial drivers (e.g. FTDI) drop the latency timer from 16 ms to 1 ms.
+    // Ignored by drivers, which do not support it (e.g. pty)
+    std::optional<bool> lowLatency;
+    // VMIN, the port becomes readable only when so many bytes are received, so a read posted before the data
+    // arrives completes with the whole frame instead of its first bytes (VTIME is reset to 0, because any
+    // timeout cancels VMIN on a non-blocking port and does not time reads out).
+    // It does not hold back a read posted when some bytes are already received: they are returned at once.
+    std::optional<std::uint8_t> minReadSize;
 };
 
 class SerialPort;
@@ -86,6 +102,9 @@ public:
     virtual void setRTS(bool state) = 0;
     virtual void setDTR(bool state) = 0;
     virtual SerialPortParams::ModemControl getModemControl() = 0;
+
+    // Number of received bytes, which can be read without waiting (a hint for the size of the next read)
+    virtual std::size_t bytesAvailable() = 0;
 };
 
 }   // namespace nhope
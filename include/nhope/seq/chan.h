@@ -8,13 +8,18 @@
 #include <optional>
 #include <utility>
 
+#include "nhope/async/lock-free-ts-queue.h"
 #include "nhope/async/ts-queue.h"
 
 #include "producer.h"
 
 namespace nhope {
 
-template<typename T>
+/**
+ * @tparam Queue queue used to pass values between threads
+ *               (TSQueue or LockFreeTSQueue, or any queue with the same interface)
+ */
+template<typename T, template<typename> class Queue = TSQueue>
 class Chan final
 {
 public:
@@ -45,6 +50,16 @@ public:
         return m_d->queue.read();
     }
 
+    /**
+     * @brief Waits for the values and reads up to maxCount of them into the end of out at once.
+     * @return number of read values, 0 if the chan is closed and empty
+     */
+    template<typename Container>
+    std::size_t getMany(Container& out, std::size_t maxCount)
+    {
+        return m_d->queue.readBatch(out, maxCount);
+    }
+
     void attachToProducer(Producer<T>& producer)
     {
         auto newInput = this->makeInput();
@@ -65,7 +80,7 @@ private:
         {}
 
         const bool autoClose;
-        TSQueue<T> queue;
+        Queue<T> queue;
         std::atomic<std::size_t> inputCount = 0;
     };
 
@@ -95,6 +110,22 @@ private:
             return Consumer<T>::Status::Closed;
         }
 
+        typename Consumer<T>::Status consumeOwned(T&& value) override
+        {
+            if (m_d->queue.write(std::move(value))) {
+                return Consumer<T>::Status::Ok;
+            }
+            return Consumer<T>::Status::Closed;
+        }
+
+        typename Consumer<T>::Status consumeBatch(gsl::span<const T> values) override
+        {
+            if (m_d->queue.writeBatch(values) == values.size()) {
+                return Consumer<T>::Status::Ok;
+            }
+            return Consumer<T>::Status::Closed;
+        }
+
     private:
         std::shared_ptr<Prv> m_d;
     };
@@ -1,81 +1,179 @@
 #pragma once
 
-#include <list>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
 #include <memory>
 #include <mutex>
+#include <vector>
 
-#include "nhope/async/reverse-lock.h"
 #include "nhope/seq/consumer.h"
 
 namespace nhope {
 
+/**
+ * @brief Broadcasts values to the list of consumers.
+ *
+ * The list is copy-on-write: addConsumer/close and removal of the closed consumers
+ * publish a new immutable snapshot, consume only takes a reference to the current one.
+ * So producers do not block each other and a consumer may be called from several
+ * producer threads at the same time.
+ */
 template<typename T>
 class ConsumerList final : public Consumer<T>
 {
 public:
+    ConsumerList()
+      : m_snapshot(std::make_shared<const Snapshot>())
+    {}
+
     void close()
     {
         std::scoped_lock lock(m_mutex);
-        m_closed = true;
-        m_list.clear();
+        m_closed.store(true, std::memory_order_release);
+        this->publish(std::make_shared<const Snapshot>());
     }
 
     void addConsumer(std::unique_ptr<Consumer<T>> consumer)
     {
         std::scoped_lock lock(m_mutex);
-        if (m_closed) {
+        if (m_closed.load(std::memory_order_relaxed)) {
             return;
         }
 
-        m_list.emplace_back(std::move(consumer));
+        auto snapshot = std::make_shared<Snapshot>(*this->snapshot());
+        snapshot->emplace_back(std::move(consumer));
+        this->publish(std::move(snapshot));
     }
 
     // Consumer
     typename Consumer<T>::Status consume(const T& value) override
     {
-        std::unique_lock lock(m_mutex);
-        if (m_closed) {
+        if (m_closed.load(std::memory_order_acquire)) {
+            return Consumer<T>::Status::Closed;
+        }
+
+        const auto snapshot = this->snapshot();
+        for (const auto& consumer : *snapshot) {
+            this->exceptionSafeDeliver(consumer, [&value](Consumer<T>& c) {
+                return c.consume(value);
+            });
+        }
+
+        return Consumer<T>::Status::Ok;
+    }
+
+    /**
+     * The last consumer gets the ownership of the value, the rest share one immutable copy of it.
+     */
+    typename Consumer<T>::Status consumeOwned(T&& value) override
+    {
+        if (m_closed.load(std::memory_order_acquire)) {
             return Consumer<T>::Status::Closed;
         }
-        List list;
-        list.splice(list.begin(), m_list);
-
-        {
-            nhope::ReverseLock unlock(lock);
-            auto it = list.begin();
-            while (it != list.end()) {
-                switch (exceptionSafeConsume(*it, value)) {
-                case Consumer<T>::Status::Ok:
-                    it++;
-                    break;
-                case Consumer<T>::Status::Closed:
-                    it = list.erase(it);
-                    break;
-                }
+
+        const auto snapshot = this->snapshot();
+        if (snapshot->empty()) {
+            return Consumer<T>::Status::Ok;
+        }
+
+        if (snapshot->size() > 1) {
+            const auto shared = std::make_shared<const T>(value);
+            for (auto it = snapshot->begin(); it != std::prev(snapshot->end()); ++it) {
+                this->exceptionSafeDeliver(*it, [&shared](Consumer<T>& c) {
+                    return c.consumeShared(shared);
+                });
             }
         }
 
-        m_list.splice(m_list.begin(), list);
+        this->exceptionSafeDeliver(snapshot->back(), [&value](Consumer<T>& c) {
+            return c.consumeOwned(std::move(value));
+        });
+        return Consumer<T>::Status::Ok;
+    }
+
+    typename Consumer<T>::Status consumeShared(const std::shared_ptr<const T>& value) override
+    {
+        if (m_closed.load(std::memory_order_acquire)) {
+            return Consumer<T>::Status::Closed;
+        }
+
+        const auto snapshot = this->snapshot();
+        for (const auto& consumer : *snapshot) {
+            this->exceptionSafeDeliver(consumer, [&value](Consumer<T>& c) {
+                return c.consumeShared(value);
+            });
+        }
+
+        return Consumer<T>::Status::Ok;
+    }
+
+    typename Consumer<T>::Status consumeBatch(gsl::span<const T> values) override
+    {
+        if (m_closed.load(std::memory_order_acquire)) {
+            return Consumer<T>::Status::Closed;
+        }
+
+        const auto snapshot = this->snapshot();
+        for (const auto& consumer : *snapshot) {
+            this->exceptionSafeDeliver(consumer, [values](Consumer<T>& c) {
+                return c.consumeBatch(values);
+            });
+        }
+
         return Consumer<T>::Status::Ok;
     }
 
 private:
-    static typename Consumer<T>::Status exceptionSafeConsume(std::unique_ptr<Consumer<T>>& consumer,
-                                                             const T& value) noexcept
+    using Snapshot = std::vector<std::shared_ptr<Consumer<T>>>;
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+    // Removes the consumer if it is closed
+    template<typename Fn>
+    void exceptionSafeDeliver(const std::shared_ptr<Consumer<T>>& consumer, Fn deliver)
     {
+        typename Consumer<T>::Status status = Consumer<T>::Status::Ok;
         try {
-            return consumer->consume(value);
+            status = deliver(*consumer);
         } catch (...) {
             // The consumer did not return Closed - we will not delete it
-            return Consumer<T>::Status::Ok;
+        }
+
+        if (status == Consumer<T>::Status::Closed) {
+            this->remove(consumer.get());
         }
     }
 
-    using List = std::list<std::unique_ptr<Consumer<T>>>;
+    [[nodiscard]] SnapshotPtr snapshot() const
+    {
+        return std::atomic_load_explicit(&m_snapshot, std::memory_order_acquire);
+    }
+
+    // Must be called under m_mutex
+    void publish(SnapshotPtr snapshot)
+    {
+        std::atomic_store_explicit(&m_snapshot, std::move(snapshot), std::memory_order_release);
+    }
+
+    void remove(const Consumer<T>* consumer)
+    {
+        std::scoped_lock lock(m_mutex);
+        const auto current = this->snapshot();
+        auto snapshot = std::make_shared<Snapshot>();
+        snapshot->reserve(current->size());
+        std::copy_if(current->begin(), current->end(), std::back_inserter(*snapshot), [consumer](const auto& c) {
+            return c.get() != consumer;
+        });
+
+        // Another producer could have already removed the consumer
+        if (snapshot->size() != current->size()) {
+            this->publish(std::move(snapshot));
+        }
+    }
 
     std::mutex m_mutex;
-    bool m_closed = false;
-    List m_list;
+    std::atomic<bool> m_closed = false;
+    SnapshotPtr m_snapshot;
 };
 
 }   // namespace nhope
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <memory>
+
+#include <gsl/span>
+
 #include "nhope/utils/noncopyable.h"
 
 namespace nhope {
@@ -17,6 +21,44 @@ public:
     virtual ~Consumer() = default;
 
     virtual Status consume(const T& value) = 0;
+
+    /**
+     * @brief Consumes the value taking the ownership of it.
+     *
+     * The default implementation is consume(value). Consumers that store the value
+     * (queues, tasks of executors) override it to move the value instead of copying.
+     */
+    virtual Status consumeOwned(T&& value)
+    {
+        return this->consume(value);
+    }
+
+    /**
+     * @brief Consumes the value that is shared with other consumers and must not be changed.
+     *
+     * The default implementation is consume(*value). Consumers that store the value
+     * override it to keep the pointer instead of copying the value.
+     */
+    virtual Status consumeShared(const std::shared_ptr<const T>& value)
+    {
+        return this->consume(*value);
+    }
+
+    /**
+     * @brief Consumes several values at once.
+     *
+     * The default implementation consumes the values one by one, consumers that can deliver
+     * the whole batch cheaper (e.g. with one queue lock or one executor hop) override it.
+     */
+    virtual Status consumeBatch(gsl::span<const T> values)
+    {
+        for (const auto& value : values) {
+            if (this->consume(value) == Status::Closed) {
+                return Status::Closed;
+            }
+        }
+        return Status::Ok;
+    }
 };
 
 }   // namespace nhope
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstring>
 #include <optional>
@@ -9,26 +11,38 @@
 #include <gsl/span>
 #include <gsl/assert>
 
+#include "nhope/utils/detail/compiler.h"
+
 namespace nhope {
 
+namespace detail {
+
+template<std::size_t Value>
+constexpr std::size_t nextPowerOf2()
+{
+    static_assert(Value > 0);
+    std::size_t v = Value;
+    std::size_t power = 2;
+    --v;
+    while ((v >>= 1) != 0U) {
+        power <<= 1;
+    }
+    return power;
+}
+
+template<typename T>
+void fifoCopy(gsl::span<T> dst, gsl::span<const T> src) noexcept
+{
+    std::memcpy(dst.data(), src.data(), src.size() * sizeof(T));
+}
+
+}   // namespace detail
+
 template<typename T, std::size_t Size>
 class Fifo final
 {
     static_assert(std::is_standard_layout_v<T> && std::is_trivial_v<T>);
 
-    template<std::size_t Value>
-    static constexpr std::size_t nextPowerOf2()
-    {
-        static_assert(Value > 0);
-        std::size_t v = Value;
-        int power = 2;
-        --v;
-        while ((v >>= 1) != 0U) {
-            power <<= 1;
-        }
-        return power;
-    }
-
 public:
     [[nodiscard]] std::size_t size() const noexcept
     {
@@ -108,17 +122,247 @@ public:
         return val;
     }
 
+    /*!
+     * @brief Free space of the fifo for direct writing (e.g. by a device read)
+     *
+     * @param count maximum number of elements
+     * @return up to two spans (the second one is empty if the free space does not wrap around)
+     */
+    [[nodiscard]] std::array<gsl::span<T>, 2> prepare(std::size_t count) noexcept
+    {
+        count = std::min(count, Size - m_count);
+        const auto firstPartCount = std::min(count, capacity - m_head);
+        auto buf = gsl::span(m_buffer);
+        return {buf.subspan(m_head, firstPartCount), buf.first(count - firstPartCount)};
+    }
+
+    /*!
+     * @brief Appends count elements written to the spans returned by prepare
+     */
+    void commit(std::size_t count) noexcept
+    {
+        Expects(count <= Size - m_count);
+        m_head = (m_head + count) & (capacity - 1);
+        m_count += count;
+    }
+
+    /*!
+     * @brief Contents of the fifo without copying
+     *
+     * @return up to two spans (the second one is empty if the data does not wrap around)
+     */
+    [[nodiscard]] std::array<gsl::span<const T>, 2> data() const noexcept
+    {
+        const auto firstPartCount = std::min(m_count, capacity - m_tail);
+        auto buf = gsl::span(m_buffer);
+        return {buf.subspan(m_tail, firstPartCount), buf.first(m_count - firstPartCount)};
+    }
+
+    /*!
+     * @brief Removes count elements from the beginning of the fifo
+     */
+    void consume(std::size_t count) noexcept
+    {
+        Expects(count <= m_count);
+        m_tail = (m_tail + count) & (capacity - 1);
+        m_count -= count;
+    }
+
 private:
     static void copy(gsl::span<T> dst, gsl::span<const T> src) noexcept
     {
-        std::memcpy(dst.data(), src.data(), src.size() * sizeof(T));
+        detail::fifoCopy(dst, src);
     }
 
-    static constexpr std::size_t capacity = nextPowerOf2<Size>();
+    static constexpr std::size_t capacity = detail::nextPowerOf2<Size>();
 
     std::array<T, capacity> m_buffer{};
     std::size_t m_head{};
     std::size_t m_tail{};
     std::size_t m_count{};
 };
+
+/*!
+ * @brief Lock-free Fifo for one producer thread and one consumer thread.
+ *
+ * Has the same push/pop semantics as Fifo. The write and read indices are atomic
+ * and live on separate cache lines, every side keeps a cached copy of the index of
+ * the other side and reloads it (acquire) only when the cached value is not enough.
+ *
+ * push, reserveContiguous and publish must be called only by the producer,
+ * pop, data, consume and clear - only by the consumer.
+ */
+template<typename T, std::size_t Size>
+class SpscFifo final
+{
+    static_assert(std::is_standard_layout_v<T> && std::is_trivial_v<T>);
+
+public:
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        // The tail never passes the head, so it is loaded first
+        const auto tail = m_tail.load(std::memory_order_acquire);
+        const auto head = m_head.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return this->size() == 0;
+    }
+
+    std::size_t push(gsl::span<const T> data) noexcept
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        const auto count = std::min(data.size(), this->freeSpace(head, data.size()));
+        if (GSL_UNLIKELY(count == 0)) {
+            return 0;
+        }
+
+        const auto pos = head & (capacity - 1);
+        const auto firstPartCount = std::min(count, capacity - pos);
+        auto dst = gsl::span(m_buffer);
+        copy(dst.subspan(pos, firstPartCount), data.first(firstPartCount));
+        if (GSL_UNLIKELY(firstPartCount < count)) {
+            copy(dst.first(count - firstPartCount), data.subspan(firstPartCount, count - firstPartCount));
+        }
+
+        m_head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    std::size_t push(const T& value) noexcept
+    {
+        return push(gsl::span<const T, 1>(&value, 1));
+    }
+
+    /*!
+     * @brief pop from fifo to data
+     *
+     * @param data
+     * @return size_t really popped size from fifo
+     */
+    std::size_t pop(gsl::span<T> data) noexcept
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        const auto count = std::min(data.size(), this->available(tail, data.size()));
+        if (GSL_UNLIKELY(count == 0)) {
+            return 0;
+        }
+
+        const auto pos = tail & (capacity - 1);
+        const auto firstPartCount = std::min(count, capacity - pos);
+        auto src = gsl::span(m_buffer);
+        copy(data, src.subspan(pos, firstPartCount));
+        if (GSL_UNLIKELY(firstPartCount < count)) {
+            copy(data.subspan(firstPartCount), src.first(count - firstPartCount));
+        }
+
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    [[nodiscard]] std::optional<T> pop() noexcept
+    {
+        T val{};
+        if (pop(gsl::span<T, 1>(&val, 1)) == 0) {
+            return std::nullopt;
+        }
+        return val;
+    }
+
+    /*!
+     * @brief Contents of the fifo without copying, unlike Fifo::data only the contiguous part
+     * (may be less than size() if the data wraps around).
+     *
+     * The data stays in the fifo until consume is called.
+     */
+    [[nodiscard]] gsl::span<const T> data() noexcept
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        const auto pos = tail & (capacity - 1);
+        const auto contiguous = capacity - pos;
+        const auto count = std::min(this->available(tail, contiguous), contiguous);
+        return gsl::span<const T>(m_buffer).subspan(pos, count);
+    }
+
+    /*!
+     * @brief Removes count elements obtained by data from the beginning of the fifo
+     */
+    void consume(std::size_t count) noexcept
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        Expects(count <= m_cachedHead - tail);
+        m_tail.store(tail + count, std::memory_order_release);
+    }
+
+    /*!
+     * @brief Writable contiguous free space of the fifo.
+     *
+     * The data written there becomes available to the consumer after publish.
+     */
+    [[nodiscard]] gsl::span<T> reserveContiguous() noexcept
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        const auto pos = head & (capacity - 1);
+        const auto contiguous = capacity - pos;
+        const auto count = std::min(this->freeSpace(head, contiguous), contiguous);
+        return gsl::span<T>(m_buffer).subspan(pos, count);
+    }
+
+    /*!
+     * @brief Makes count elements written into reserveContiguous() available to the consumer.
+     */
+    void publish(std::size_t count) noexcept
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        Expects(count <= Size - (head - m_cachedTail));
+        m_head.store(head + count, std::memory_order_release);
+    }
+
+    void clear() noexcept
+    {
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+        m_tail.store(m_cachedHead, std::memory_order_release);
+    }
+
+private:
+    static void copy(gsl::span<T> dst, gsl::span<const T> src) noexcept
+    {
+        detail::fifoCopy(dst, src);
+    }
+
+    std::size_t freeSpace(std::size_t head, std::size_t wanted) noexcept
+    {
+        auto result = Size - (head - m_cachedTail);
+        if (result < wanted) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            result = Size - (head - m_cachedTail);
+        }
+        return result;
+    }
+
+    std::size_t available(std::size_t tail, std::size_t wanted) noexcept
+    {
+        auto result = m_cachedHead - tail;
+        if (result < wanted) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            result = m_cachedHead - tail;
+        }
+        return result;
+    }
+
+    static constexpr std::size_t capacity = detail::nextPowerOf2<Size>();
+
+    // Producer side
+    alignas(cacheLineSize) std::atomic<std::size_t> m_head{};
+    std::size_t m_cachedTail{};
+
+    // Consumer side
+    alignas(cacheLineSize) std::atomic<std::size_t> m_tail{};
+    std::size_t m_cachedHead{};
+
+    alignas(cacheLineSize) std::array<T, capacity> m_buffer{};
+};
+
 }   // namespace nhope
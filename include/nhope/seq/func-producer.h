@@ -2,11 +2,14 @@
 
 #include <cassert>
 
+#include <cstddef>
+
 #include <functional>
 #include <memory>
 #include <thread>
 #include <utility>
 #include <atomic>
+#include <vector>
 
 #include "consumer-list.h"
 #include "producer.h"
@@ -17,6 +20,11 @@ template<typename T>
 class FuncProducer final : public Producer<T>
 {
 public:
+    /**
+     * Produces the next value into its argument, returns false when the sequence is finished.
+     * The argument is a value-initialized T on every call, so func cannot build on the previous value
+     * and must keep such state itself (e.g. in the lambda captures).
+     */
     using Function = std::function<bool(T&)>;
     enum class State
     {
@@ -26,11 +34,18 @@ public:
         Finished
     };
 
-    explicit FuncProducer(Function&& func)
+    /**
+     * @param batchSize the values are collected into batches of this size and passed to consumers
+     *                  by Consumer::consumeBatch (the last batch may be smaller).
+     *                  1 - every value is passed to consumers as soon as it is produced.
+     */
+    explicit FuncProducer(Function&& func, std::size_t batchSize = 1)
       : m_func(std::move(func))
+      , m_batchSize(batchSize)
       , m_state(State::ReadyToStart)
     {
         assert(m_func);
+        assert(m_batchSize > 0);   // NOLINT
     }
 
     ~FuncProducer() override
@@ -74,16 +89,45 @@ public:
 private:
     void run()
     {
-        T value;
-        while (m_state == State::Running && m_func(value)) {
-            m_consumerList.consume(value);
+        if (m_batchSize == 1) {
+            while (m_state == State::Running) {
+                T value{};
+                if (!m_func(value)) {
+                    break;
+                }
+                m_consumerList.consumeOwned(std::move(value));
+            }
+        } else {
+            this->runBatches();
         }
 
         m_consumerList.close();
     }
 
+    void runBatches()
+    {
+        std::vector<T> batch(m_batchSize);
+        std::size_t count = 0;
+        while (m_state == State::Running) {
+            // The slot still holds a value of the previous batch
+            batch[count] = T{};
+            if (!m_func(batch[count])) {
+                break;
+            }
+            if (++count == m_batchSize) {
+                m_consumerList.consumeBatch(batch);
+                count = 0;
+            }
+        }
+
+        if (count > 0) {
+            m_consumerList.consumeBatch(gsl::span<const T>(batch).first(count));
+        }
+    }
+
     std::thread m_workThread;
     const Function m_func;
+    const std::size_t m_batchSize;
     std::atomic<State> m_state;
     ConsumerList<T> m_consumerList;
 };
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <utility>
+#include <vector>
+
+#include <gsl/span>
 
 #include <nhope/async/ao-context.h>
 #include <nhope/async/executor.h>
-#include <nhope/async/safe-callback.h>
 #include <nhope/seq/consumer.h>
 #include <nhope/seq/producer.h>
 
@@ -18,11 +24,23 @@ class Notifier final
 public:
     using Handler = std::function<void(const T&)>;
 
+    enum class Mode
+    {
+        // Every value is passed to the handler
+        EveryValue,
+
+        /* Only one delivery is queued at a time. Values produced while it is waiting for
+           the AOContext replace the pending one, so a slow AOContext gets only the latest values
+           and the memory does not grow under overload. */
+        LatestValue,
+    };
+
     Notifier(const Notifier&) = delete;
     Notifier& operator=(const Notifier&) = delete;
 
-    Notifier(AOContext& parentAOCtx, Handler handler)
+    Notifier(AOContext& parentAOCtx, Handler handler, Mode mode = Mode::EveryValue)
       : m_handler(std::move(handler))
+      , m_latestSlot(mode == Mode::LatestValue ? std::make_shared<LatestSlot>() : nullptr)
       , m_aoCtx(parentAOCtx)
     {}
 
@@ -39,33 +57,165 @@ public:
 
     std::unique_ptr<Consumer<T>> makeInput()
     {
-        auto safeHandler = makeSafeCallback(m_aoCtx, m_handler);
-        return std::make_unique<Input>(std::move(safeHandler));
+        auto handler = std::make_shared<const Handler>(m_handler);
+        if (m_latestSlot != nullptr) {
+            return std::make_unique<LatestInput>(m_aoCtx, std::move(handler), m_latestSlot);
+        }
+        return std::make_unique<Input>(m_aoCtx, std::move(handler));
+    }
+
+    /**
+     * @brief Number of values replaced by newer ones before delivery (Mode::LatestValue)
+     */
+    [[nodiscard]] std::size_t droppedCount() const noexcept
+    {
+        return m_latestSlot != nullptr ? m_latestSlot->dropped.load(std::memory_order_relaxed) : 0;
     }
 
 private:
+    struct LatestSlot
+    {
+        std::mutex mutex;
+        std::optional<T> value;
+        bool scheduled = false;
+        std::atomic<std::size_t> dropped = 0;
+    };
+
+    /* Every value (or batch) is delivered by one AOContext hop.
+       The value is moved into the task if the producer gives up the ownership of it,
+       a shared value is passed to the task without copying. */
     class Input final : public Consumer<T>
     {
     public:
-        explicit Input(Handler safeHandler)
-          : m_safeHandler(std::move(safeHandler))
+        Input(AOContext& aoCtx, std::shared_ptr<const Handler> handler)
+          : m_aoCtx(aoCtx)
+          , m_handler(std::move(handler))
         {}
 
         typename Consumer<T>::Status consume(const T& value) override
         {
-            try {
-                m_safeHandler(value);
-                return Consumer<T>::Status::Ok;
-            } catch (const AOContextClosed&) {
+            return this->deliver([handler = m_handler, value] {
+                (*handler)(value);
+            });
+        }
+
+        typename Consumer<T>::Status consumeOwned(T&& value) override
+        {
+            return this->deliver([handler = m_handler, value = std::move(value)] {
+                (*handler)(value);
+            });
+        }
+
+        typename Consumer<T>::Status consumeShared(const std::shared_ptr<const T>& value) override
+        {
+            return this->deliver([handler = m_handler, value] {
+                (*handler)(*value);
+            });
+        }
+
+        typename Consumer<T>::Status consumeBatch(gsl::span<const T> values) override
+        {
+            std::vector<T> batch(values.begin(), values.end());
+            return this->deliver([handler = m_handler, aoCtx = m_aoCtx, batch = std::move(batch)] {
+                for (const auto& value : batch) {
+                    // The handler could destroy the notifier
+                    if (!aoCtx.isOpen()) {
+                        return;
+                    }
+                    (*handler)(value);
+                }
+            });
+        }
+
+    private:
+        template<typename Work>
+        typename Consumer<T>::Status deliver(Work&& work)
+        {
+            if (!m_aoCtx.isOpen()) {
                 return Consumer<T>::Status::Closed;
             }
+
+            m_aoCtx.exec(std::forward<Work>(work));
+            return Consumer<T>::Status::Ok;
+        }
+
+        AOContextRef m_aoCtx;
+        std::shared_ptr<const Handler> m_handler;
+    };
+
+    class LatestInput final : public Consumer<T>
+    {
+    public:
+        LatestInput(AOContext& aoCtx, std::shared_ptr<const Handler> handler, std::shared_ptr<LatestSlot> slot)
+          : m_aoCtx(aoCtx)
+          , m_handler(std::move(handler))
+          , m_slot(std::move(slot))
+        {}
+
+        typename Consumer<T>::Status consume(const T& value) override
+        {
+            return this->store(value);
+        }
+
+        typename Consumer<T>::Status consumeOwned(T&& value) override
+        {
+            return this->store(std::move(value));
+        }
+
+        typename Consumer<T>::Status consumeShared(const std::shared_ptr<const T>& value) override
+        {
+            return this->store(*value);
+        }
+
+        typename Consumer<T>::Status consumeBatch(gsl::span<const T> values) override
+        {
+            if (values.empty()) {
+                return Consumer<T>::Status::Ok;
+            }
+
+            m_slot->dropped.fetch_add(values.size() - 1, std::memory_order_relaxed);
+            return this->store(values.back());
         }
 
     private:
-        Handler m_safeHandler;
+        template<typename V>
+        typename Consumer<T>::Status store(V&& value)
+        {
+            if (!m_aoCtx.isOpen()) {
+                return Consumer<T>::Status::Closed;
+            }
+
+            bool schedule = false;
+            {
+                std::scoped_lock lock(m_slot->mutex);
+                if (m_slot->value.has_value()) {
+                    m_slot->dropped.fetch_add(1, std::memory_order_relaxed);
+                }
+                m_slot->value = std::forward<V>(value);
+                schedule = !std::exchange(m_slot->scheduled, true);
+            }
+
+            if (schedule) {
+                m_aoCtx.exec([handler = m_handler, slot = m_slot] {
+                    std::optional<T> latest;
+                    {
+                        std::scoped_lock lock(slot->mutex);
+                        latest.swap(slot->value);
+                        slot->scheduled = false;
+                    }
+                    (*handler)(*latest);
+                });
+            }
+            return Consumer<T>::Status::Ok;
+        }
+
+        AOContextRef m_aoCtx;
+        std::shared_ptr<const Handler> m_handler;
+        std::shared_ptr<LatestSlot> m_slot;
     };
 
     Handler m_handler;
+    std::shared_ptr<LatestSlot> m_latestSlot;
     AOContext m_aoCtx;
 };
 
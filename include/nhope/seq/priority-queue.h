@@ -2,14 +2,23 @@
 
 #include <algorithm>
 #include <cstddef>
-#include <list>
+#include <cstdint>
+#include <limits>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "nhope/utils/type.h"
 
 namespace nhope {
 
+/**
+ * @brief Queue of values with priorities.
+ *
+ * The value with the highest priority is popped first, values with equal priorities
+ * are popped in the order of pushing. Binary heap over a contiguous array:
+ * push and pop take O(log n), remove_if takes O(n).
+ */
 template<typename T>
 class PriorityQueue
 {
@@ -17,12 +26,8 @@ public:
     template<typename V>
     void push(V&& value, int priority = 0)
     {
-        Storage val{priority, std::forward<V>(value)};
-        const auto it =
-          std::lower_bound(m_queue.begin(), m_queue.end(), val, [&](const Storage& lhs, const Storage& rhs) {
-              return lhs.first < rhs.first;
-          });
-        m_queue.emplace(it, std::move(val));
+        m_heap.push_back(Entry{priority, m_seq++, std::forward<V>(value)});
+        std::push_heap(m_heap.begin(), m_heap.end(), Less{});
     }
 
     template<typename Fn>
@@ -30,47 +35,354 @@ public:
     {
         static_assert(checkFunctionSignatureV<Fn, bool, const T&, int>, "expect bool(const T&, int) signature");
 
-        const auto end = m_queue.end();
-        auto it = m_queue.begin();
-        while (it != end) {
-            if (fn(it->second, it->first)) {
-                it = m_queue.erase(it);
-                continue;
-            }
-            it++;
+        const auto it = std::remove_if(m_heap.begin(), m_heap.end(), [&fn](const Entry& e) {
+            return fn(e.value, e.priority);
+        });
+        if (it != m_heap.end()) {
+            m_heap.erase(it, m_heap.end());
+            std::make_heap(m_heap.begin(), m_heap.end(), Less{});
         }
     }
 
     void clear()
     {
-        m_queue.clear();
+        m_heap.clear();
     }
 
     std::optional<T> pop()
     {
         std::optional<T> result = std::nullopt;
 
-        if (m_queue.empty()) {
+        if (m_heap.empty()) {
             return result;
         }
-        result = std::move(m_queue.back().second);
-        m_queue.pop_back();
+        std::pop_heap(m_heap.begin(), m_heap.end(), Less{});
+        result = std::move(m_heap.back().value);
+        m_heap.pop_back();
         return result;
     }
 
     [[nodiscard]] std::size_t size() const noexcept
     {
-        return m_queue.size();
+        return m_heap.size();
     }
 
     [[nodiscard]] bool empty() const noexcept
     {
-        return m_queue.empty();
+        return m_heap.empty();
     }
 
 private:
-    using Storage = std::pair<int, T>;
-    std::list<Storage> m_queue;
+    struct Entry
+    {
+        int priority;
+        std::uint64_t seq;
+        T value;
+    };
+
+    // The top of the heap is the greatest element: the highest priority, then the earliest push
+    struct Less
+    {
+        bool operator()(const Entry& lhs, const Entry& rhs) const noexcept
+        {
+            if (lhs.priority != rhs.priority) {
+                return lhs.priority < rhs.priority;
+            }
+            return lhs.seq > rhs.seq;
+        }
+    };
+
+    std::vector<Entry> m_heap;
+    std::uint64_t m_seq = 0;
+};
+
+/**
+ * @brief PriorityQueue with access to the queued values by handles.
+ *
+ * push returns a handle, which allows to remove the value or to change its priority
+ * in O(log n). The handle becomes invalid when the value leaves the queue.
+ */
+template<typename T>
+class IndexedPriorityQueue
+{
+public:
+    class Handle final
+    {
+        friend class IndexedPriorityQueue;
+
+    public:
+        Handle() = default;
+
+        bool operator==(const Handle& other) const noexcept
+        {
+            return m_slot == other.m_slot && m_seq == other.m_seq;
+        }
+
+        bool operator!=(const Handle& other) const noexcept
+        {
+            return !(*this == other);
+        }
+
+    private:
+        Handle(std::size_t slot, std::uint64_t seq)
+          : m_slot(slot)
+          , m_seq(seq)
+        {}
+
+        std::size_t m_slot = npos;
+        std::uint64_t m_seq = 0;
+    };
+
+    template<typename V>
+    Handle push(V&& value, int priority = 0)
+    {
+        return this->pushWithSeq(std::forward<V>(value), priority, m_seq++);
+    }
+
+    /**
+     * @brief Pushes the value before the values with the same priority
+     */
+    template<typename V>
+    Handle pushFront(V&& value, int priority = 0)
+    {
+        return this->pushWithSeq(std::forward<V>(value), priority, m_frontSeq--);
+    }
+
+    std::optional<T> pop()
+    {
+        if (m_heap.empty()) {
+            return std::nullopt;
+        }
+        return this->removeAt(0);
+    }
+
+    [[nodiscard]] bool contains(const Handle& handle) const noexcept
+    {
+        return this->position(handle) != npos;
+    }
+
+    /**
+     * @return the priority of the value, which will be popped next
+     */
+    [[nodiscard]] std::optional<int> topPriority() const noexcept
+    {
+        if (m_heap.empty()) {
+            return std::nullopt;
+        }
+        return m_heap.front().priority;
+    }
+
+    [[nodiscard]] std::optional<int> priority(const Handle& handle) const noexcept
+    {
+        const auto pos = this->position(handle);
+        if (pos == npos) {
+            return std::nullopt;
+        }
+        return m_heap[pos].priority;
+    }
+
+    /**
+     * @return the removed value, std::nullopt if the handle is invalid
+     */
+    std::optional<T> remove(const Handle& handle)
+    {
+        const auto pos = this->position(handle);
+        if (pos == npos) {
+            return std::nullopt;
+        }
+        return this->removeAt(pos);
+    }
+
+    /**
+     * @brief Changes the priority of the value. Among the values with the new priority
+     *        it keeps the FIFO order of the original push (not the order of a new push).
+     * @return false if the handle is invalid
+     */
+    bool changePriority(const Handle& handle, int priority)
+    {
+        const auto pos = this->position(handle);
+        if (pos == npos) {
+            return false;
+        }
+
+        const auto oldPriority = std::exchange(m_heap[pos].priority, priority);
+        if (priority > oldPriority) {
+            this->siftUp(pos);
+        } else {
+            this->siftDown(pos);
+        }
+        return true;
+    }
+
+    template<typename Fn>
+    void remove_if(Fn fn)
+    {
+        static_assert(checkFunctionSignatureV<Fn, bool, const T&, int>, "expect bool(const T&, int) signature");
+
+        std::size_t count = 0;
+        for (auto& entry : m_heap) {
+            if (fn(entry.value, entry.priority)) {
+                this->releaseSlot(entry.slot);
+            } else {
+                if (&m_heap[count] != &entry) {
+                    m_heap[count] = std::move(entry);
+                }
+                ++count;
+            }
+        }
+        m_heap.erase(m_heap.begin() + static_cast<std::ptrdiff_t>(count), m_heap.end());
+
+        for (std::size_t i = m_heap.size() / 2; i-- > 0;) {
+            this->siftDown(i);
+        }
+        for (std::size_t i = 0; i < m_heap.size(); ++i) {
+            m_slots[m_heap[i].slot].pos = i;
+        }
+    }
+
+    void clear()
+    {
+        m_heap.clear();
+        m_slots.clear();
+        m_freeSlots.clear();
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_heap.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return m_heap.empty();
+    }
+
+private:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    struct Entry
+    {
+        int priority;
+        std::uint64_t seq;
+        std::size_t slot;
+        T value;
+    };
+
+    // Position of the entry in the heap, seq tells whether the slot still belongs to the handle
+    struct Slot
+    {
+        std::size_t pos = npos;
+        std::uint64_t seq = 0;
+    };
+
+    static bool before(const Entry& lhs, const Entry& rhs) noexcept
+    {
+        if (lhs.priority != rhs.priority) {
+            return lhs.priority > rhs.priority;
+        }
+        return lhs.seq < rhs.seq;
+    }
+
+    template<typename V>
+    Handle pushWithSeq(V&& value, int priority, std::uint64_t seq)
+    {
+        std::size_t slot = 0;
+        if (m_freeSlots.empty()) {
+            slot = m_slots.size();
+            m_slots.push_back(Slot{});
+        } else {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+
+        m_slots[slot] = Slot{m_heap.size(), seq};
+        m_heap.push_back(Entry{priority, seq, slot, std::forward<V>(value)});
+        this->siftUp(m_heap.size() - 1);
+        return Handle(slot, seq);
+    }
+
+    [[nodiscard]] std::size_t position(const Handle& handle) const noexcept
+    {
+        if (handle.m_slot >= m_slots.size() || m_slots[handle.m_slot].seq != handle.m_seq) {
+            return npos;
+        }
+        return m_slots[handle.m_slot].pos;
+    }
+
+    void releaseSlot(std::size_t slot)
+    {
+        m_slots[slot].pos = npos;
+        m_freeSlots.push_back(slot);
+    }
+
+    T removeAt(std::size_t pos)
+    {
+        T value = std::move(m_heap[pos].value);
+        this->releaseSlot(m_heap[pos].slot);
+
+        const auto last = m_heap.size() - 1;
+        if (pos != last) {
+            m_heap[pos] = std::move(m_heap[last]);
+            m_slots[m_heap[pos].slot].pos = pos;
+        }
+        m_heap.pop_back();
+
+        if (pos < m_heap.size()) {
+            this->siftUp(pos);
+            this->siftDown(pos);
+        }
+        return value;
+    }
+
+    void siftUp(std::size_t pos)
+    {
+        Entry entry = std::move(m_heap[pos]);
+        while (pos > 0) {
+            const auto parent = (pos - 1) / 2;
+            if (!before(entry, m_heap[parent])) {
+                break;
+            }
+            this->place(pos, std::move(m_heap[parent]));
+            pos = parent;
+        }
+        this->place(pos, std::move(entry));
+    }
+
+    void siftDown(std::size_t pos)
+    {
+        const auto size = m_heap.size();
+        Entry entry = std::move(m_heap[pos]);
+        while (true) {
+            auto child = 2 * pos + 1;
+            if (child >= size) {
+                break;
+            }
+            if (child + 1 < size && before(m_heap[child + 1], m_heap[child])) {
+                ++child;
+            }
+            if (!before(m_heap[child], entry)) {
+                break;
+            }
+            this->place(pos, std::move(m_heap[child]));
+            pos = child;
+        }
+        this->place(pos, std::move(entry));
+    }
+
+    void place(std::size_t pos, Entry&& entry)
+    {
+        m_heap[pos] = std::move(entry);
+        m_slots[m_heap[pos].slot].pos = pos;
+    }
+
+    std::vector<Entry> m_heap;
+    std::vector<Slot> m_slots;
+    std::vector<std::size_t> m_freeSlots;
+
+    // Values pushed to the front get decreasing sequence numbers below the ones of the other values
+    static constexpr std::uint64_t firstSeq = std::uint64_t(1) << 63;
+    std::uint64_t m_seq = firstSeq;
+    std::uint64_t m_frontSeq = firstSeq - 1;
 };
 
 }   // namespace nhope
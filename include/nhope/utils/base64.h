@@ -1,6 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -15,7 +18,108 @@ public:
     explicit Base64ParseError(std::string_view msg);
 };
 
+/**
+ * @brief Size of the base64 text for size bytes (with padding)
+ */
+constexpr std::size_t base64EncodedSize(std::size_t size) noexcept
+{
+    return (size + 2) / 3 * 4;
+}
+
+/**
+ * @brief Upper bound of the number of bytes decoded from size characters of base64 text
+ */
+constexpr std::size_t base64DecodedMaxSize(std::size_t size) noexcept
+{
+    return (size + 3) / 4 * 3;
+}
+
 std::vector<std::uint8_t> fromBase64(std::string_view str, bool skipSpaces = true);
 std::string toBase64(gsl::span<const std::uint8_t> plainSeq);
 
+/**
+ * @brief Decodes str into out, which must have at least base64DecodedMaxSize(str.size()) bytes.
+ * @return number of decoded bytes
+ * @throw Base64ParseError
+ */
+std::size_t fromBase64(std::string_view str, gsl::span<std::uint8_t> out, bool skipSpaces = true);
+
+/**
+ * @brief Encodes plainSeq into out, which must have at least base64EncodedSize(plainSeq.size()) characters.
+ * @return number of written characters
+ */
+std::size_t toBase64(gsl::span<const std::uint8_t> plainSeq, gsl::span<char> out);
+
+/**
+ * @brief Incremental base64 encoder.
+ *
+ * update() encodes whole 3-byte groups and keeps the rest for the next call,
+ * finish() writes the last group with padding.
+ */
+class Base64Encoder final
+{
+public:
+    static constexpr std::size_t maxFinishSize = 4;
+
+    /**
+     * @brief Number of characters update() writes for the next size bytes
+     */
+    [[nodiscard]] std::size_t updateSize(std::size_t size) const noexcept;
+
+    /**
+     * @param out must have at least updateSize(data.size()) characters
+     * @return number of written characters
+     */
+    std::size_t update(gsl::span<const std::uint8_t> data, gsl::span<char> out);
+
+    /**
+     * @param out must have at least maxFinishSize characters
+     * @return number of written characters, the encoder is ready for a new text
+     */
+    std::size_t finish(gsl::span<char> out);
+
+private:
+    std::array<std::uint8_t, 3> m_tail{};
+    std::size_t m_tailSize = 0;
+};
+
+/**
+ * @brief Incremental base64 decoder.
+ *
+ * The text may be split between update() calls at any position. Whitespaces are skipped
+ * in the same pass, if skipSpaces is set.
+ */
+class Base64Decoder final
+{
+public:
+    explicit Base64Decoder(bool skipSpaces = true);
+
+    /**
+     * @brief Upper bound of the number of bytes update() writes for the next size characters
+     */
+    [[nodiscard]] std::size_t updateMaxSize(std::size_t size) const noexcept;
+
+    /**
+     * @param out must have at least updateMaxSize(text.size()) bytes
+     * @return number of written bytes
+     * @throw Base64ParseError
+     */
+    std::size_t update(std::string_view text, gsl::span<std::uint8_t> out);
+
+    /**
+     * @brief Checks that the text is complete, the decoder is ready for a new text
+     * @throw Base64ParseError
+     */
+    void finish();
+
+private:
+    std::size_t decodeScalar(std::string_view text, std::uint8_t* out, std::size_t& written);
+
+    std::array<std::uint8_t, 4> m_quantum{};
+    std::size_t m_quantumSize = 0;
+    std::size_t m_paddingSize = 0;
+    bool m_finished = false;
+    bool m_skipSpaces;
+};
+
 }   // namespace nhope
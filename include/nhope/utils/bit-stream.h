@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include <gsl/assert>
+#include <gsl/span>
+
+#include "nhope/utils/bits.h"
+#include "nhope/utils/bytes.h"
+
+namespace nhope {
+
+/**
+ * @brief Reads bit fields from bytes.
+ *
+ * Each read takes an unaligned 64-bit window at the byte of the current position, so read(n) for
+ * n <= maxFastBits is a load and two shifts without data dependent branches. Bits past the end of the data
+ * are read as zeros, use bitsLeft() to detect the end.
+ */
+template<BitOrder Order = BitOrder::MsbFirst>
+class BitReader final
+{
+public:
+    // The window has at least 57 bits after any bit offset within a byte
+    static constexpr std::size_t maxFastBits = 57;
+
+    explicit BitReader(gsl::span<const std::uint8_t> data) noexcept
+      : m_data(data)
+    {}
+
+    /**
+     * @return next n bits (n <= maxFastBits), the first read bit is the highest bit of the result
+     *         for MsbFirst and the lowest one for LsbFirst
+     */
+    std::uint64_t read(std::size_t n) noexcept
+    {
+        assert(n <= maxFastBits);   // NOLINT
+
+        const auto window = this->window();
+        const auto offset = m_pos % byteBits;
+        m_pos += n;
+
+        if constexpr (Order == BitOrder::MsbFirst) {
+            return ((window << offset) >> 1) >> (wordBits - 1 - n);
+        } else {
+            return (window >> offset) & ((std::uint64_t(1) << n) - 1);
+        }
+    }
+
+    /**
+     * @return next n bits (n <= 64)
+     */
+    std::uint64_t readLong(std::size_t n) noexcept
+    {
+        Expects(n <= wordBits);
+
+        if (n <= maxFastBits) {
+            return this->read(n);
+        }
+
+        if constexpr (Order == BitOrder::MsbFirst) {
+            const auto high = this->read(n - halfWordBits);
+            return high << halfWordBits | this->read(halfWordBits);
+        } else {
+            const auto low = this->read(halfWordBits);
+            return low | this->read(n - halfWordBits) << halfWordBits;
+        }
+    }
+
+    bool readBit() noexcept
+    {
+        return this->read(1) != 0;
+    }
+
+    void skip(std::size_t n) noexcept
+    {
+        m_pos += n;
+    }
+
+    void alignToByte() noexcept
+    {
+        m_pos = (m_pos + byteBits - 1) / byteBits * byteBits;
+    }
+
+    // Number of read bits
+    [[nodiscard]] std::size_t position() const noexcept
+    {
+        return m_pos;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_data.size() * byteBits;
+    }
+
+    [[nodiscard]] std::size_t bitsLeft() const noexcept
+    {
+        return m_pos < this->size() ? this->size() - m_pos : 0;
+    }
+
+private:
+    static constexpr std::size_t byteBits = 8;
+    static constexpr std::size_t wordBits = 64;
+    static constexpr std::size_t halfWordBits = 32;
+    static constexpr Endian windowOrder = Order == BitOrder::MsbFirst ? Endian::Big : Endian::Little;
+
+    [[nodiscard]] std::uint64_t window() const noexcept
+    {
+        const auto index = m_pos / byteBits;
+        if (index + sizeof(std::uint64_t) <= m_data.size()) {
+            return fromBytes<std::uint64_t>(m_data.subspan(index, sizeof(std::uint64_t)), windowOrder);
+        }
+        return this->tailWindow(index);
+    }
+
+    [[nodiscard]] std::uint64_t tailWindow(std::size_t index) const noexcept
+    {
+        std::array<std::uint8_t, sizeof(std::uint64_t)> bytes{};
+        if (index < m_data.size()) {
+            const auto tail = m_data.subspan(index);
+            std::copy(tail.begin(), tail.end(), bytes.begin());
+        }
+        return fromBytes<std::uint64_t>(bytes, windowOrder);
+    }
+
+    gsl::span<const std::uint8_t> m_data;
+    std::size_t m_pos = 0;
+};
+
+/**
+ * @brief Writes bit fields to bytes.
+ *
+ * Bits are collected in a 64-bit buffer, whole bytes of it are stored by one unaligned 8-byte store,
+ * so write may overwrite up to 7 bytes after the written bits (but never past the end of the span).
+ * The last incomplete byte is written by flush.
+ */
+template<BitOrder Order = BitOrder::MsbFirst>
+class BitWritter final
+{
+public:
+    static constexpr std::size_t maxFastBits = 56;
+
+    explicit BitWritter(gsl::span<std::uint8_t> out) noexcept
+      : m_begin(out.data())
+      , m_ptr(out.data())
+      , m_end(out.data() + out.size())
+    {}
+
+    /**
+     * @brief Writes n low bits of value (n <= 64), the highest of them is written first for MsbFirst
+     *        and the lowest one for LsbFirst
+     */
+    void write(std::uint64_t value, std::size_t n)
+    {
+        Expects(n <= wordBits);
+
+        if (n > maxFastBits) {
+            const auto low = value & ((std::uint64_t(1) << halfWordBits) - 1);
+            const auto high = value >> halfWordBits;
+            if constexpr (Order == BitOrder::MsbFirst) {
+                this->write(high, n - halfWordBits);
+                this->write(low, halfWordBits);
+            } else {
+                this->write(low, halfWordBits);
+                this->write(high, n - halfWordBits);
+            }
+            return;
+        }
+
+        value &= (std::uint64_t(1) << n) - 1;
+        if constexpr (Order == BitOrder::MsbFirst) {
+            m_bits |= (value << (wordBits - 1 - m_count - n)) << 1;
+        } else {
+            m_bits |= value << m_count;
+        }
+        m_count += n;
+
+        this->storeBytes();
+    }
+
+    void writeBit(bool bit)
+    {
+        this->write(bit ? 1 : 0, 1);
+    }
+
+    /**
+     * @brief Writes the last incomplete byte padded with zero bits. Writing can be continued after it.
+     * @return number of bytes with written bits
+     */
+    std::size_t flush()
+    {
+        if (m_count > 0) {
+            Expects(m_ptr != m_end);
+            if constexpr (Order == BitOrder::MsbFirst) {
+                *m_ptr = static_cast<std::uint8_t>(m_bits >> (wordBits - byteBits));
+            } else {
+                *m_ptr = static_cast<std::uint8_t>(m_bits);
+            }
+        }
+        return static_cast<std::size_t>(m_ptr - m_begin) + (m_count > 0 ? 1 : 0);
+    }
+
+    // Number of written bits
+    [[nodiscard]] std::size_t position() const noexcept
+    {
+        return static_cast<std::size_t>(m_ptr - m_begin) * byteBits + m_count;
+    }
+
+private:
+    static constexpr std::size_t byteBits = 8;
+    static constexpr std::size_t wordBits = 64;
+    static constexpr std::size_t halfWordBits = 32;
+    static constexpr Endian windowOrder = Order == BitOrder::MsbFirst ? Endian::Big : Endian::Little;
+
+    // Leaves less than 8 bits in the buffer
+    void storeBytes()
+    {
+        const auto bytes = m_count / byteBits;
+        if (static_cast<std::size_t>(m_end - m_ptr) >= sizeof(std::uint64_t)) {
+            toBytes(m_bits, gsl::span<std::uint8_t, sizeof(std::uint64_t)>(m_ptr, sizeof(std::uint64_t)), windowOrder);
+        } else {
+            Expects(static_cast<std::size_t>(m_end - m_ptr) >= bytes);
+            for (std::size_t i = 0; i < bytes; ++i) {
+                if constexpr (Order == BitOrder::MsbFirst) {
+                    m_ptr[i] = static_cast<std::uint8_t>(m_bits >> (wordBits - byteBits - i * byteBits));
+                } else {
+                    m_ptr[i] = static_cast<std::uint8_t>(m_bits >> (i * byteBits));
+                }
+            }
+        }
+
+        m_ptr += bytes;
+        if constexpr (Order == BitOrder::MsbFirst) {
+            m_bits <<= bytes * byteBits;
+        } else {
+            m_bits >>= bytes * byteBits;
+        }
+        m_count %= byteBits;
+    }
+
+    std::uint8_t* m_begin;
+    std::uint8_t* m_ptr;
+    std::uint8_t* m_end;
+
+    std::uint64_t m_bits = 0;
+    std::size_t m_count = 0;
+};
+
+}   // namespace nhope
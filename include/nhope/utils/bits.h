@@ -8,4 +8,17 @@ enum class Endian
     Big,
 };
 
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+inline constexpr Endian nativeEndian = Endian::Big;
+#else
+inline constexpr Endian nativeEndian = Endian::Little;
+#endif
+
+// Order of bits in a byte of a bit stream
+enum class BitOrder
+{
+    MsbFirst,
+    LsbFirst,
+};
+
 }   // namespace nhope
@@ -1,15 +1,29 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
+#include <type_traits>
 
+#include <gsl/assert>
 #include <gsl/span>
 
 #include <nhope/utils/bits.h>
 
 namespace nhope {
 
+namespace detail {
+
+/**
+ * @brief Copies count values of width bytes (2, 4 or 8) from in to out, reversing the byte order of each value.
+ *        Uses SSSE3/AVX2 shuffles when the CPU has them. in and out may be the same buffer.
+ */
+void copyBytesSwapped(const std::uint8_t* in, std::uint8_t* out, std::size_t count, std::size_t width) noexcept;
+
+}   // namespace detail
+
 inline constexpr void toBytes(std::uint16_t val, gsl::span<std::uint8_t, 2> bytes, Endian byteOrder)
 {
     switch (byteOrder) {
@@ -157,12 +171,70 @@ constexpr Int fromBytes(gsl::span<const std::uint8_t> bytes, Endian byteOrder)
 template<typename Int>
 inline constexpr Int bytesSwap(Int value)
 {
-    Int result{};
-    constexpr auto digits = std::numeric_limits<Int>::digits - 8;
+    static_assert(std::is_integral_v<Int>, "expect integer type");
+    using UInt = std::make_unsigned_t<Int>;
+
+#if defined(__GNUC__) || defined(__clang__)
+    if constexpr (sizeof(Int) == 2) {
+        return static_cast<Int>(__builtin_bswap16(static_cast<UInt>(value)));
+    } else if constexpr (sizeof(Int) == 4) {
+        return static_cast<Int>(__builtin_bswap32(static_cast<UInt>(value)));
+    } else if constexpr (sizeof(Int) == 8) {   // NOLINT(readability-magic-numbers)
+        return static_cast<Int>(__builtin_bswap64(static_cast<UInt>(value)));
+    }
+#endif
+
+    const auto v = static_cast<UInt>(value);
+    UInt result{};
+    constexpr auto digits = std::numeric_limits<UInt>::digits - 8;
     for (int i = digits; i >= 0; i -= 8) {
-        result |= ((value >> i) & 0xFF) << digits - i;
+        result |= static_cast<UInt>(((v >> i) & 0xFF) << (digits - i));
+    }
+    return static_cast<Int>(result);
+}
+
+/**
+ * @brief Reads values.size() integers of byteOrder from bytes, which must have at least
+ *        values.size() * sizeof(Int) bytes. Whole buffers are byte swapped by SIMD shuffles.
+ */
+template<typename Int>
+void fromBytes(gsl::span<const std::uint8_t> bytes, gsl::span<Int> values, Endian byteOrder)
+{
+    static_assert(std::is_integral_v<Int>, "expect integer type");
+    Expects(bytes.size() >= values.size_bytes());
+
+    if (values.empty()) {
+        return;
+    }
+
+    auto* out = reinterpret_cast<std::uint8_t*>(values.data());   // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    if (sizeof(Int) == 1 || byteOrder == nativeEndian) {
+        std::memcpy(out, bytes.data(), values.size_bytes());
+    } else {
+        detail::copyBytesSwapped(bytes.data(), out, values.size(), sizeof(Int));
+    }
+}
+
+/**
+ * @brief Writes values as integers of byteOrder to bytes, which must have at least
+ *        values.size() * sizeof(Int) bytes.
+ */
+template<typename Int>
+void toBytes(gsl::span<const Int> values, gsl::span<std::uint8_t> bytes, Endian byteOrder)
+{
+    static_assert(std::is_integral_v<Int>, "expect integer type");
+    Expects(bytes.size() >= values.size_bytes());
+
+    if (values.empty()) {
+        return;
+    }
+
+    const auto* in = reinterpret_cast<const std::uint8_t*>(values.data());   // NOLINT
+    if (sizeof(Int) == 1 || byteOrder == nativeEndian) {
+        std::memcpy(bytes.data(), in, values.size_bytes());
+    } else {
+        detail::copyBytesSwapped(in, bytes.data(), values.size(), sizeof(Int));
     }
-    return result;
 }
 
 }   // namespace nhope
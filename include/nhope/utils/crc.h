@@ -0,0 +1,229 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include <gsl/span>
+
+namespace nhope {
+
+namespace detail {
+
+template<typename T, std::size_t N>
+using CrcTables = std::array<std::array<T, 256>, N>;
+
+template<typename T>
+constexpr T reflectBits(T value) noexcept
+{
+    T result = 0;
+    for (int i = 0; i < std::numeric_limits<T>::digits; ++i) {
+        result = static_cast<T>((result << 1) | (value & 1));
+        value = static_cast<T>(value >> 1);
+    }
+    return result;
+}
+
+inline std::uint64_t loadLittleEndian64(const std::uint8_t* p) noexcept
+{
+    return std::uint64_t(p[0]) | std::uint64_t(p[1]) << 8 | std::uint64_t(p[2]) << 16 | std::uint64_t(p[3]) << 24 |
+           std::uint64_t(p[4]) << 32 | std::uint64_t(p[5]) << 40 | std::uint64_t(p[6]) << 48 |
+           std::uint64_t(p[7]) << 56;
+}
+
+inline std::uint64_t loadBigEndian64(const std::uint8_t* p) noexcept
+{
+    return std::uint64_t(p[0]) << 56 | std::uint64_t(p[1]) << 48 | std::uint64_t(p[2]) << 40 |
+           std::uint64_t(p[3]) << 32 | std::uint64_t(p[4]) << 24 | std::uint64_t(p[5]) << 16 |
+           std::uint64_t(p[6]) << 8 | std::uint64_t(p[7]);
+}
+
+/**
+ * @brief Slicing-by-8: 8 bytes per step through tables built by makeCrcTables<T, 8>.
+ *        crc is the register value (without the final xor).
+ */
+template<typename T, bool Reflected>
+T crcUpdate(T crc, const CrcTables<T, 8>& t, const std::uint8_t* data, std::size_t size) noexcept
+{
+    constexpr int width = std::numeric_limits<T>::digits;
+
+    for (; size >= 8; size -= 8, data += 8) {
+        if constexpr (Reflected) {
+            const auto w = loadLittleEndian64(data) ^ crc;
+            crc = t[7][w & 0xff] ^ t[6][(w >> 8) & 0xff] ^ t[5][(w >> 16) & 0xff] ^ t[4][(w >> 24) & 0xff] ^
+                  t[3][(w >> 32) & 0xff] ^ t[2][(w >> 40) & 0xff] ^ t[1][(w >> 48) & 0xff] ^ t[0][w >> 56];
+        } else {
+            const auto w = loadBigEndian64(data) ^ (std::uint64_t(crc) << (64 - width));
+            crc = t[7][w >> 56] ^ t[6][(w >> 48) & 0xff] ^ t[5][(w >> 40) & 0xff] ^ t[4][(w >> 32) & 0xff] ^
+                  t[3][(w >> 24) & 0xff] ^ t[2][(w >> 16) & 0xff] ^ t[1][(w >> 8) & 0xff] ^ t[0][w & 0xff];
+        }
+    }
+
+    for (; size > 0; --size, ++data) {
+        if constexpr (Reflected) {
+            crc = static_cast<T>(t[0][(crc ^ *data) & 0xff] ^ (crc >> 8));
+        } else {
+            crc = static_cast<T>(t[0][((crc >> (width - 8)) ^ *data) & 0xff] ^ (crc << 8));
+        }
+    }
+    return crc;
+}
+
+}   // namespace detail
+
+/**
+ * @brief Lookup tables for a CRC with any polynomial of 8, 16, 32 or 64 bits.
+ *
+ * Table 0 is the classic byte-at-a-time table, table k gives the CRC of a byte followed by k zero bytes
+ * (slicing-by-N). polynomial is in the normal notation (e.g. 0x04c11db7 for CRC-32), reflected selects
+ * the LSB-first algorithm.
+ */
+template<typename T, std::size_t N = 8>
+constexpr detail::CrcTables<T, N> makeCrcTables(T polynomial, bool reflected) noexcept
+{
+    static_assert(std::is_unsigned_v<T> && std::numeric_limits<T>::digits >= 8, "expect unsigned type of 8+ bits");
+    constexpr int width = std::numeric_limits<T>::digits;
+    constexpr auto topBit = static_cast<T>(T(1) << (width - 1));
+
+    const auto poly = reflected ? detail::reflectBits(polynomial) : polynomial;
+
+    detail::CrcTables<T, N> tables{};
+    for (std::size_t i = 0; i < 256; ++i) {   // NOLINT(readability-magic-numbers)
+        auto crc = reflected ? static_cast<T>(i) : static_cast<T>(T(i) << (width - 8));
+        for (int bit = 0; bit < 8; ++bit) {
+            if (reflected) {
+                crc = static_cast<T>((crc >> 1) ^ ((crc & 1) != 0 ? poly : 0));
+            } else {
+                crc = static_cast<T>((crc << 1) ^ ((crc & topBit) != 0 ? poly : 0));
+            }
+        }
+        tables[0][i] = crc;
+    }
+
+    for (std::size_t k = 1; k < N; ++k) {
+        for (std::size_t i = 0; i < 256; ++i) {   // NOLINT(readability-magic-numbers)
+            const auto prev = tables[k - 1][i];
+            if (reflected) {
+                tables[k][i] = static_cast<T>((prev >> 8) ^ tables[0][prev & 0xff]);
+            } else {
+                tables[k][i] = static_cast<T>((prev << 8) ^ tables[0][(prev >> (width - 8)) & 0xff]);
+            }
+        }
+    }
+    return tables;
+}
+
+template<typename T>
+constexpr std::array<T, 256> makeCrcTable(T polynomial, bool reflected) noexcept
+{
+    return makeCrcTables<T, 1>(polynomial, reflected)[0];
+}
+
+/**
+ * @brief CRC with parameters of the Rocksoft model: Polynomial and Init in the normal notation,
+ *        Reflected input and output, XorOut applied to the result.
+ *
+ * Tables are built at compile time, the data is processed by slicing-by-8. Has the same interface as MD5,
+ * so it can be used with digest() and hashing adapters.
+ */
+template<typename T, T Polynomial, T Init, bool Reflected, T XorOut>
+class Crc final
+{
+public:
+    using Digest = T;
+
+    void reset() noexcept
+    {
+        m_crc = initValue;
+    }
+
+    Crc& update(gsl::span<const std::uint8_t> data) noexcept
+    {
+        m_crc = detail::crcUpdate<T, Reflected>(m_crc, tables, data.data(), data.size());
+        return *this;
+    }
+
+    /**
+     * @return CRC of the data passed to update since the last reset, the state is reset
+     */
+    Digest digest() noexcept
+    {
+        const auto result = static_cast<T>(m_crc ^ XorOut);
+        this->reset();
+        return result;
+    }
+
+    static Digest digest(gsl::span<const std::uint8_t> data) noexcept
+    {
+        return static_cast<T>(detail::crcUpdate<T, Reflected>(initValue, tables, data.data(), data.size()) ^ XorOut);
+    }
+
+private:
+    static constexpr T initValue = Reflected ? detail::reflectBits(Init) : Init;
+    static constexpr auto tables = makeCrcTables<T>(Polynomial, Reflected);
+
+    T m_crc = initValue;
+};
+
+// Checksums of serial protocols
+using CRC16Modbus = Crc<std::uint16_t, 0x8005, 0xffff, true, 0>;
+using CRC16CcittFalse = Crc<std::uint16_t, 0x1021, 0xffff, false, 0>;
+using CRC16Xmodem = Crc<std::uint16_t, 0x1021, 0, false, 0>;
+
+/**
+ * @brief CRC-32 (ISO-HDLC), the checksum of zlib, PNG and Ethernet.
+ *
+ * Folds 64 bytes per step with carry-less multiplication (PCLMULQDQ) when the CPU has it,
+ * otherwise uses slicing-by-8.
+ */
+class CRC32 final
+{
+public:
+    using Digest = std::uint32_t;
+
+    void reset();
+    CRC32& update(gsl::span<const std::uint8_t> data);
+
+    /**
+     * @return CRC of the data passed to update since the last reset, the state is reset
+     */
+    Digest digest();
+
+    static Digest digest(gsl::span<const std::uint8_t> data);
+
+private:
+    static constexpr std::uint32_t initValue = 0xffffffff;
+
+    std::uint32_t m_crc = initValue;
+};
+
+/**
+ * @brief CRC-32C (Castagnoli), the checksum of iSCSI, ext4 and SCTP.
+ *
+ * Uses the crc32 instructions of SSE4.2 (three interleaved streams, joined with PCLMULQDQ) or ARMv8 CRC
+ * when the CPU has them, otherwise slicing-by-8.
+ */
+class CRC32C final
+{
+public:
+    using Digest = std::uint32_t;
+
+    void reset();
+    CRC32C& update(gsl::span<const std::uint8_t> data);
+
+    /**
+     * @return CRC of the data passed to update since the last reset, the state is reset
+     */
+    Digest digest();
+
+    static Digest digest(gsl::span<const std::uint8_t> data);
+
+private:
+    static constexpr std::uint32_t initValue = 0xffffffff;
+
+    std::uint32_t m_crc = initValue;
+};
+
+}   // namespace nhope
@@ -1,5 +1,17 @@
 #pragma once
 
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NHOPE_X86 1   // NOLINT
+#else
+#define NHOPE_X86 0   // NOLINT
+#endif
+
+#if NHOPE_X86
+#include <immintrin.h>
+#endif
+
 namespace nhope {
 
 #if __clang__
@@ -26,4 +38,38 @@ constexpr auto isThreadSanitizer = true;
 constexpr auto isThreadSanitizer = false;
 #endif
 
+/* Enables instruction sets for one function, so SIMD kernels can live in common translation units
+   and be selected at runtime (see detail/cpu-features.h). MSVC allows the intrinsics without it. */
+#if defined(__GNUC__) || defined(__clang__)
+#define NHOPE_TARGET(features) __attribute__((target(features)))   // NOLINT
+#else
+#define NHOPE_TARGET(features)   // NOLINT
+#endif
+
+/* Forces inlining. A helper with a narrower NHOPE_TARGET (e.g. SSE4.1) inlined into a wider kernel (e.g. AVX2)
+   gets the encoding of the kernel, so one body serves both. */
+#if defined(__GNUC__) || defined(__clang__)
+#define NHOPE_ALWAYS_INLINE inline __attribute__((always_inline))   // NOLINT
+#elif defined(_MSC_VER)
+#define NHOPE_ALWAYS_INLINE __forceinline   // NOLINT
+#else
+#define NHOPE_ALWAYS_INLINE inline   // NOLINT
+#endif
+
+#if NHOPE_X86
+
+/* Must end an AVX kernel before it calls a function with the legacy SSE encoding (e.g. an SSE4.1 kernel
+   for the tail) or returns. Compilers do not clear the upper halves of the ymm registers before such a call,
+   and the AVX-SSE transition penalty costs more than a whole block. */
+NHOPE_ALWAYS_INLINE NHOPE_TARGET("avx") void leaveAvx() noexcept
+{
+    _mm256_zeroupper();
+}
+
+#endif
+
+/* Used to separate data modified by different threads (avoids false sharing).
+   std::hardware_destructive_interference_size is not supported by all of our compilers. */
+constexpr std::size_t cacheLineSize = 64;
+
 }   // namespace nhope
@@ -0,0 +1,36 @@
+#pragma once
+
+namespace nhope::detail {
+
+/**
+ * @brief Instruction sets used by the vectorized kernels, from the weakest to the strongest
+ */
+enum class SimdLevel
+{
+    Scalar,
+    Sse41,   // SSSE3 and SSE4.1
+    Avx2,
+};
+
+/**
+ * @brief The best level supported by the CPU and the OS (limited by setSimdLevelLimit)
+ */
+SimdLevel simdLevel() noexcept;
+
+/**
+ * @brief Limits the level returned by simdLevel(), so tests and benchmarks can check every kernel
+ */
+void setSimdLevelLimit(SimdLevel level) noexcept;
+
+/**
+ * @brief Whether the CPU has SSE4.2 crc32 instructions (always false if the level is limited to Scalar)
+ */
+bool hasCrc32Instructions() noexcept;
+
+/**
+ * @brief Whether the CPU has carry-less multiplication (PCLMULQDQ) and SSE4.1 (always false if the level
+ *        is limited to Scalar)
+ */
+bool hasClmulInstructions() noexcept;
+
+}   // namespace nhope::detail
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
 #include <string>
@@ -16,8 +17,37 @@ public:
     explicit HexParseError(std::string_view msg);
 };
 
+/**
+ * @brief Result of decoding into a caller-provided buffer
+ */
+struct HexDecodeResult
+{
+    static constexpr std::size_t npos = std::string_view::npos;
+
+    // Number of decoded bytes, the bytes before the error are decoded as well
+    std::size_t size = 0;
+    // Position of the first invalid character, size of the text if the last digit is missing
+    std::size_t errorPos = npos;
+
+    [[nodiscard]] bool ok() const noexcept
+    {
+        return errorPos == npos;
+    }
+};
+
 std::uint8_t fromHex(char hi, char lo);
 std::vector<uint8_t> fromHex(std::string_view hex);
 std::string toHex(gsl::span<const uint8_t> bytes);
 
+/**
+ * @brief Decodes hex into out, which must have at least hex.size() / 2 bytes. Whitespaces are skipped.
+ */
+HexDecodeResult fromHex(std::string_view hex, gsl::span<uint8_t> out) noexcept;
+
+/**
+ * @brief Encodes bytes into out, which must have at least 2 * bytes.size() characters.
+ * @return number of written characters
+ */
+std::size_t toHex(gsl::span<const uint8_t> bytes, gsl::span<char> out) noexcept;
+
 }   // namespace nhope
@@ -7,6 +7,7 @@
 #include <array>
 #include <filesystem>
 #include <istream>
+#include <vector>
 
 #include <gsl/span>
 
@@ -33,7 +34,24 @@ public:
     static Digest digest(std::istream& stream);
     static Digest fileDigest(const std::filesystem::path& filePath);
 
+    /**
+     * @brief Digests of independent messages.
+     *
+     * Blocks of several messages are transformed at once in SIMD lanes (8 with AVX2, 4 with SSE4.1),
+     * which is several times faster than hashing the messages one by one. One message can't be
+     * parallelized: each block depends on the previous one.
+     * The messages must be in memory, streams (e.g. files) are hashed in lanes by MultiMD5.
+     */
+    static std::vector<Digest> digestMany(gsl::span<const gsl::span<const std::uint8_t>> messages);
+
+    /**
+     * @brief Number of messages digestMany hashes at once on this CPU
+     */
+    static std::size_t laneCount() noexcept;
+
 private:
+    friend class MultiMD5;
+
     using Block = std::array<std::uint8_t, blockSize>;
     using State = std::array<std::uint32_t, 4>;
 
@@ -49,4 +67,32 @@ private:
     Context m_context;
 };
 
+/**
+ * @brief MD5 of several independent streams, which are fed portion by portion.
+ *
+ * The full blocks of different streams are transformed at once in the SIMD lanes of MD5::digestMany,
+ * so the streams (e.g. files read by nhope::digestMany) are never held in memory.
+ * The lanes are busy when the streams get portions of the same size at once.
+ */
+class MultiMD5 final
+{
+public:
+    explicit MultiMD5(std::size_t streamCount);
+
+    [[nodiscard]] std::size_t streamCount() const noexcept;
+
+    /**
+     * @brief Appends portions[i] to the stream i, the portions may be empty.
+     */
+    void update(gsl::span<const gsl::span<const std::uint8_t>> portions);
+
+    /**
+     * @brief Digest of the stream, the stream starts from scratch after that.
+     */
+    MD5::Digest digest(std::size_t stream);
+
+private:
+    std::vector<MD5> m_streams;
+};
+
 }   // namespace nhope
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <utility>
 #include "nhope/utils/noncopyable.h"
 
@@ -21,8 +24,11 @@ namespace nhope {
  *     assert(*ptr, 100);
  * }
  * @endcode
- * 
- * @tparam K key type
+ *
+ * Records are indexed by a thread-local open-addressed hash table,
+ * so get, contains and count take constant time regardless of the stack depth.
+ *
+ * @tparam K key type (default constructible, copyable and supported by std::hash)
  * @tparam V value type
  */
 template<typename K, typename V>
@@ -41,14 +47,16 @@ public:
         Record(Kp&& key, Vp&& value)
           : m_key(std::forward<Kp>(key))
           , m_value(std::forward<Vp>(value))
-          , m_pred(StackStorage::first)
         {
-            StackStorage::first = this;
+            Slot& slot = StackStorage::index.acquire(m_key);
+            m_pred = slot.top;
+            slot.top = this;
+            ++slot.count;
         }
 
         ~Record()
         {
-            StackStorage::first = m_pred;
+            StackStorage::index.release(m_key, m_pred);
         }
 
         Value& value() noexcept
@@ -60,42 +68,175 @@ public:
         const Key m_key;
         Value m_value;
 
-        Record* m_pred;
+        // Previous record with the same key
+        Record* m_pred = nullptr;
     };
 
     static Value* get(const Key& key) noexcept
     {
-        for (Record* cur = first; cur != nullptr; cur = cur->m_pred) {
-            if (key == cur->m_key) {
-                return &cur->m_value;
-            }
-        }
-        return nullptr;
+        Slot* slot = index.find(key);
+        return slot != nullptr ? &slot->top->m_value : nullptr;
     }
 
     static bool contains(const Key& key) noexcept
     {
-        return StackStorage::get(key) != nullptr;
+        return index.find(key) != nullptr;
     }
 
     static std::size_t count(const Key& key) noexcept
     {
-        std::size_t result = 0;
-        for (Record* cur = first; cur != nullptr; cur = cur->m_pred) {
-            if (key == cur->m_key) {
-                ++result;
-            }
-        }
-        return result;
+        Slot* slot = index.find(key);
+        return slot != nullptr ? slot->count : 0;
     }
 
 private:
+    struct Slot final
+    {
+        Key key{};
+        Record* top = nullptr;   // nullptr - the slot is free
+        std::size_t count = 0;
+    };
+
+    /* Linear probing hash table: key -> the most recent record with the key */
+    class Index final : Noncopyable
+    {
+    public:
+        Slot* find(const Key& key) noexcept
+        {
+            if (m_size == 0) {
+                return nullptr;
+            }
+
+            for (std::size_t i = this->home(key);; i = (i + 1) & m_mask) {
+                Slot& slot = m_slots[i];
+                if (slot.top == nullptr) {
+                    return nullptr;
+                }
+                if (slot.key == key) {
+                    return &slot;
+                }
+            }
+        }
+
+        Slot& acquire(const Key& key)
+        {
+            if ((m_size + 1) * 2 > this->capacity()) {
+                this->rehash(this->capacity() == 0 ? initCapacity : this->capacity() * 2);
+            }
+
+            // There are no tombstones, so the first free slot terminates the probe sequence
+            std::size_t i = this->home(key);
+            for (; m_slots[i].top != nullptr; i = (i + 1) & m_mask) {
+                if (m_slots[i].key == key) {
+                    return m_slots[i];
+                }
+            }
+
+            ++m_size;
+            m_slots[i].key = key;
+            return m_slots[i];
+        }
+
+        void release(const Key& key, Record* pred) noexcept
+        {
+            Slot* slot = this->find(key);
+            slot->top = pred;
+            if (--slot->count == 0) {
+                this->erase(static_cast<std::size_t>(slot - m_slots));
+            }
+        }
+
+    private:
+        static constexpr std::size_t initCapacity = 16;
+        static constexpr std::uint64_t fibonacciMul = 0x9E3779B97F4A7C15ULL;
+
+        [[nodiscard]] std::size_t capacity() const noexcept
+        {
+            return m_slots == nullptr ? 0 : m_mask + 1;
+        }
+
+        [[nodiscard]] std::size_t home(const Key& key) const noexcept
+        {
+            const auto hash = static_cast<std::uint64_t>(std::hash<Key>{}(key));
+            return static_cast<std::size_t>((hash * fibonacciMul) >> m_shift);
+        }
+
+        Slot& freeSlotFor(const Key& key) noexcept
+        {
+            std::size_t i = this->home(key);
+            while (m_slots[i].top != nullptr) {
+                i = (i + 1) & m_mask;
+            }
+            return m_slots[i];
+        }
+
+        void rehash(std::size_t newCapacity)
+        {
+            const auto oldCapacity = this->capacity();
+            auto newSlots = std::make_unique<Slot[]>(newCapacity);   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+            const std::unique_ptr<Slot[]> oldSlots(std::exchange(m_slots, newSlots.release()));
+
+            m_mask = newCapacity - 1;
+            m_shift = 64;
+            for (auto c = newCapacity; c > 1; c >>= 1) {
+                --m_shift;
+            }
+
+            for (std::size_t i = 0; i < oldCapacity; ++i) {
+                if (oldSlots[i].top != nullptr) {
+                    this->freeSlotFor(oldSlots[i].key) = oldSlots[i];
+                }
+            }
+
+            /* The Index is trivially destructible to keep access to it cheap,
+               so the slots are freed by a separate object at thread exit. */
+            thread_local const SlotsReleaser releaser(*this);
+        }
+
+        // Backward shift deletion, keeps probe sequences without tombstones
+        void erase(std::size_t hole) noexcept
+        {
+            for (std::size_t i = (hole + 1) & m_mask; m_slots[i].top != nullptr; i = (i + 1) & m_mask) {
+                const auto h = this->home(m_slots[i].key);
+                const bool stays = hole <= i ? (hole < h && h <= i) : (hole < h || h <= i);
+                if (!stays) {
+                    m_slots[hole] = m_slots[i];
+                    hole = i;
+                }
+            }
+
+            m_slots[hole] = Slot{};
+            --m_size;
+        }
+
+        struct SlotsReleaser final
+        {
+            explicit SlotsReleaser(Index& index) noexcept
+              : index(index)
+            {}
+
+            ~SlotsReleaser()
+            {
+                delete[] index.m_slots;   // NOLINT(cppcoreguidelines-owning-memory)
+                index.m_slots = nullptr;
+                index.m_size = 0;
+            }
+
+            Index& index;
+        };
+
+        Slot* m_slots = nullptr;
+        std::size_t m_mask = 0;
+        unsigned m_shift = 64;
+        std::size_t m_size = 0;
+    };
+
     // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
-    static thread_local Record* first;
+    static thread_local Index index;
 };
 
 template<typename K, typename V>
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
-thread_local typename StackStorage<K, V>::Record* StackStorage<K, V>::first = nullptr;
+thread_local typename StackStorage<K, V>::Index StackStorage<K, V>::index;
 
 }   // namespace nhope
@@ -1,12 +1,24 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <string_view>
 
+#include <gsl/span>
+
 namespace nhope {
 
+/**
+ * @brief Removes whitespaces, the same set as isspace in the "C" locale: ' ', '\t', '\n', '\v', '\f', '\r'
+ */
 std::string removeWhitespaces(std::string_view s);
 
+/**
+ * @brief Writes s without whitespaces to out, which must have at least s.size() characters.
+ * @return number of written characters
+ */
+std::size_t removeWhitespaces(std::string_view s, gsl::span<char> out) noexcept;
+
 /*!
  * @brief Converts a plain text string to an HTML string with HTML
  * metacharacters <, >, &, and " replaced by HTML entities.
@@ -17,4 +29,15 @@ std::string removeWhitespaces(std::string_view s);
  */
 std::string toHtmlEscaped(std::string_view s);
 
+/**
+ * @brief Size of toHtmlEscaped(s)
+ */
+std::size_t htmlEscapedSize(std::string_view s) noexcept;
+
+/**
+ * @brief Writes the escaped s to out, which must have at least htmlEscapedSize(s) characters.
+ * @return number of written characters
+ */
+std::size_t toHtmlEscaped(std::string_view s, gsl::span<char> out) noexcept;
+
 }   // namespace nhope
@@ -1,7 +1,10 @@
 #include <cassert>
+#include <chrono>
 
 #include <condition_variable>
+#include <deque>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <utility>
@@ -9,9 +12,68 @@
 #include "nhope/async/future.h"
 #include "nhope/async/reverse-lock.h"
 #include "nhope/async/manageable-task.h"
+#include "nhope/async/detail/thread-name.h"
 
 namespace {
 using namespace nhope;
+using namespace std::literals;
+
+/* Потоки для выполнения задач. Задача на паузе занимает поток, поэтому пул не ограничен:
+   если свободного потока нет, создается новый. Свободный поток завершается через idleTimeout. */
+class TaskThreadPool final
+{
+public:
+    static TaskThreadPool& instance()
+    {
+        static TaskThreadPool pool;
+        return pool;
+    }
+
+    void run(std::function<void()> job)
+    {
+        std::scoped_lock lock(m_state->mutex);
+        m_state->jobs.push_back(std::move(job));
+        if (m_state->jobs.size() > m_state->idleCount) {
+            // поток отсоединяется и владеет состоянием пула, поэтому пул можно разрушить раньше потоков
+            std::thread(worker, m_state).detach();
+            ++m_state->idleCount;
+        }
+        m_state->jobAdded.notify_one();
+    }
+
+private:
+    static constexpr auto idleTimeout = 10s;
+
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable jobAdded;
+        std::deque<std::function<void()>> jobs;
+        std::size_t idleCount = 0;
+    };
+
+    static void worker(const std::shared_ptr<State>& state)
+    {
+        detail::setThreadName("ManageableTask");
+
+        std::unique_lock lock(state->mutex);
+        while (state->jobAdded.wait_for(lock, idleTimeout, [&state] {
+            return !state->jobs.empty();
+        })) {
+            auto job = std::move(state->jobs.front());
+            state->jobs.pop_front();
+            --state->idleCount;
+            {
+                ReverseLock unlock(lock);
+                job();
+            }
+            ++state->idleCount;
+        }
+        --state->idleCount;
+    }
+
+    std::shared_ptr<State> m_state = std::make_shared<State>();
+};
 
 class ManageableTaskImpl final
   : public ManageableTask
@@ -21,32 +83,39 @@ public:
     ~ManageableTaskImpl() override
     {
         this->asyncStop();
-        m_workThread.join();
+
+        std::unique_lock lock(m_mutex);
+        m_runFinishedCV.wait(lock, [this] {
+            return m_runFinished;
+        });
     }
 
     explicit ManageableTaskImpl(TaskFunction&& function)
-      : m_workThread([this, function = std::move(function)]() mutable {
-          this->run(std::move(function));
-      })
+      : m_function(std::move(function))
     {}
 
-    void run(TaskFunction&& function)
+    void startRun()
+    {
+        TaskThreadPool::instance().run([this] {
+            this->run();
+        });
+    }
+
+    void run()
     {
-        {
-            std::unique_lock lock(m_mutex);
-            m_stateChangedCV.wait(lock, [this] {
-                return m_state == State::Running || m_state == State::Stopping || m_state == State::Pausing;
-            });
-        }
         std::exception_ptr error;
         try {
             if (checkPoint()) {
-                function(*this);
+                m_function(*this);
             }
         } catch (...) {
             error = std::current_exception();
         }
         stopped(std::move(error));
+
+        std::scoped_lock lock(m_mutex);
+        m_runFinished = true;
+        m_runFinishedCV.notify_all();
     }
 
     void stopped(std::exception_ptr&& error)
@@ -140,7 +209,7 @@ public:
             case State::WaitForStart:
                 ret = makeReadyFuture();
                 m_state = State::Running;
-                m_stateChangedCV.notify_one();
+                this->startRun();
                 break;
 
             case State::Paused:
@@ -161,6 +230,11 @@ public:
 
         switch (m_state) {
         case State::WaitForStart:
+            // задача завершается в потоке пула, как и запущенная
+            m_state = State::Stopping;
+            this->startRun();
+            return;
+
         case State::Running:
         case State::Pausing:
         case State::Resuming:
@@ -290,7 +364,9 @@ private:
     std::list<Promise<void>> m_resumePromises;
     std::list<Promise<void>> m_stopPromises;
     std::exception_ptr m_error;
-    std::thread m_workThread;
+    TaskFunction m_function;
+    std::condition_variable m_runFinishedCV;
+    bool m_runFinished = false;
 };
 
 }   // namespace
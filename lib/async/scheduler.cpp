@@ -1,20 +1,39 @@
 #include <algorithm>
+#include <cassert>
+#include <chrono>
 #include <cstddef>
-#include <list>
+#include <map>
 #include <memory>
 #include <optional>
+#include <unordered_map>
+#include <vector>
 
 #include <nhope/async/async-invoke.h>
 #include <nhope/async/ao-context.h>
 #include <nhope/async/thread-executor.h>
+#include <nhope/async/timer.h>
 #include <nhope/async/scheduler.h>
 #include <nhope/async/future.h>
+#include <nhope/seq/priority-queue.h>
 #include <nhope/utils/noncopyable.h>
 
 namespace nhope {
 
 class Scheduler::Impl
 {
+    using Clock = std::chrono::steady_clock;
+
+    // Идентификаторы задач, ожидающих запуска, упорядоченные по приоритету
+    using WaitQueue = IndexedPriorityQueue<TaskId>;
+
+    enum class Location
+    {
+        Active,
+        Waited,    // в очереди на запуск
+        Delayed,   // на паузе, пока задачу не активируют
+        Removed,   // очередь очищается, задача будет остановлена
+    };
+
     struct Task final : Noncopyable
     {
         Task(TaskId id, std::unique_ptr<ManageableTask> ptr, int pr) noexcept
@@ -41,10 +60,15 @@ class Scheduler::Impl
         int priority{};
         bool isAlreadyStarted{};
 
-        std::list<Promise<void>> pausePromises;
-        std::list<Promise<void>> resumePromises;
-        std::list<Promise<void>> stopPromises;
-        std::list<Promise<void>> waitPromises;
+        Location location{Location::Waited};
+        Clock::time_point locationTime{Clock::now()};
+        WaitQueue::Handle queueHandle;
+        TaskStats stats;
+
+        std::vector<Promise<void>> pausePromises;
+        std::vector<Promise<void>> resumePromises;
+        std::vector<Promise<void>> stopPromises;
+        std::vector<Promise<void>> waitPromises;
 
         void resume()
         {
@@ -73,26 +97,51 @@ class Scheduler::Impl
             return !pausePromises.empty();
         }
 
-        bool operator<(const Task& r) const noexcept
+        Future<void> cancelLater()
+        {
+            return stopPromises.emplace_back().future();
+        }
+
+        void moveTo(Location newLocation, Clock::time_point now = Clock::now())
         {
-            return priority < r.priority;
+            stats = currentStats(now);
+            location = newLocation;
+            locationTime = now;
         }
 
-        Future<void> cancelLater()
+        [[nodiscard]] TaskStats currentStats(Clock::time_point now) const
         {
-            return stopPromises.emplace_back().future();
+            TaskStats result = stats;
+            if (location == Location::Waited) {
+                result.waitTime += now - locationTime;
+            } else if (location == Location::Active) {
+                result.runTime += now - locationTime;
+            }
+            return result;
         }
     };
 
 public:
-    Impl() noexcept
-      : m_ao(m_executor)
-    {}
+    explicit Impl(const Options& options)
+      : m_options(options)
+      , m_ao(m_executor)
+    {
+        assert(m_options.concurrency > 0);   // NOLINT
+
+        if (m_options.timeSlice.has_value()) {
+            setInterval(m_ao, *m_options.timeSlice, [this](const std::error_code& err) {
+                if (!err) {
+                    this->rotateActiveTasks();
+                }
+                return !err;
+            });
+        }
+    }
 
     ~Impl()
     {
-        assert(m_waitedTasks.empty());    // NOLINT
-        assert(m_delayedTasks.empty());   // NOLINT
+        assert(m_waitedTasks.empty());   // NOLINT
+        assert(m_delayedCount == 0);     // NOLINT
     };
 
     TaskId push(int priority, ManageableTask::TaskFunction task)
@@ -100,22 +149,35 @@ public:
         auto newTask = createTask(priority, std::move(task));
         auto res{newTask->id};
 
-        schedule(std::move(newTask));
+        schedule(*m_tasks.emplace(res, std::move(newTask)).first->second);
 
         return res;
     }
 
     [[nodiscard]] std::optional<TaskId> getActiveTaskId() const noexcept
     {
-        if (m_activeTask == nullptr) {
+        const auto it = std::max_element(m_activeTasks.begin(), m_activeTasks.end(), [](Task* lhs, Task* rhs) {
+            return lhs->priority < rhs->priority;
+        });
+        if (it == m_activeTasks.end()) {
             return std::nullopt;
         }
-        return m_activeTask->id;
+        return (*it)->id;
+    }
+
+    [[nodiscard]] std::vector<TaskId> getActiveTaskIds() const
+    {
+        std::vector<TaskId> ids;
+        ids.reserve(m_activeTasks.size());
+        for (const Task* task : m_activeTasks) {
+            ids.push_back(task->id);
+        }
+        return ids;
     }
 
     Future<void> makeWaitAllPromise()
     {
-        if (m_activeTask == nullptr) {
+        if (m_activeTasks.empty()) {
             return makeReadyFuture();
         }
         return m_waitStopPromises.emplace_back().future();
@@ -123,13 +185,7 @@ public:
 
     Future<void> waitTask(TaskId id)
     {
-        if (m_activeTask != nullptr && m_activeTask->id == id) {
-            return m_activeTask->waitPromises.emplace_back().future();
-        }
-        if (auto&& [task, _it] = findTaskById(m_waitedTasks, id); task != nullptr) {
-            return task->waitPromises.emplace_back().future();
-        }
-        if (auto&& [task, _it] = findTaskById(m_delayedTasks, id); task != nullptr) {
+        if (Task* task = findTaskById(id); task != nullptr) {
             return task->waitPromises.emplace_back().future();
         }
         return makeReadyFuture();
@@ -137,51 +193,74 @@ public:
 
     Future<void> cancelTask(TaskId id)
     {
-        if (m_activeTask != nullptr && m_activeTask->id == id) {
-            m_activeTask->taskController->asyncStop();
-            return m_activeTask->taskController->asyncWaitForStopped();
+        Task* task = findTaskById(id);
+        if (task == nullptr) {
+            return makeReadyFuture();
         }
-        if (auto&& [task, wIt] = findTaskById(m_waitedTasks, id); task != nullptr) {
+
+        switch (task->location) {
+        case Location::Active:
+            task->taskController->asyncStop();
+            return task->taskController->asyncWaitForStopped();
+        case Location::Waited: {
             auto future = task->cancelLater();
-            // если задача находится в списке на запуск и еще не запускалась, она сразу удаляется
+            // если задача находится в очереди на запуск и еще не запускалась, она сразу удаляется
             if (!task->isAlreadyStarted) {
-                m_waitedTasks.erase(wIt);
+                m_waitedTasks.remove(task->queueHandle);
+                dropTask(id);
             }
             return future;
         }
-        if (auto&& [task, it] = findTaskById(m_delayedTasks, id); task != nullptr) {
-            auto cancellingTask = std::move(task);
-            m_delayedTasks.erase(it);
-            auto future = cancellingTask->cancelLater();
-            schedule(std::move(cancellingTask));
-
+        case Location::Delayed: {
+            --m_delayedCount;
+            auto future = task->cancelLater();
+            schedule(*task);
             return future;
         }
-        return makeReadyFuture();
+        case Location::Removed:
+            break;
+        }
+        return task->taskController->asyncWaitForStopped();
     }
 
     Future<void> clear()
     {
-        Future<void> future = makeReadyFuture();
-        if (m_activeTask != nullptr) {
-            future = m_activeTask->taskController->asyncWaitForStopped();
-            m_activeTask->taskController->asyncStop();
+        // Активные задачи останавливаются сразу, ожидающие - по очереди после них
+        std::vector<TaskId> removedIds = getActiveTaskIds();
+        for (Task* task : m_activeTasks) {
+            task->taskController->asyncStop();
         }
+        const auto activeCount = removedIds.size();
 
-        while (!m_delayedTasks.empty()) {
-            queueTask(std::move(m_delayedTasks.back()));
-            m_delayedTasks.pop_back();
+        for (auto& [id, task] : m_tasks) {
+            if (task->location == Location::Delayed) {
+                queueTask(*task);
+            }
         }
+        m_delayedCount = 0;
 
-        for (auto it = m_waitedTasks.rbegin(); it != m_waitedTasks.rend(); it++) {
-            std::unique_ptr<ManageableTask>& task = (*it)->taskController;
-            future = future.then(m_ao, [&task]() mutable {
-                task->asyncStop();
-                return task->asyncWaitForStopped();
+        while (auto id = m_waitedTasks.pop()) {
+            findTaskById(*id)->moveTo(Location::Removed);
+            removedIds.push_back(*id);
+        }
+
+        Future<void> future = makeReadyFuture();
+        for (std::size_t i = 0; i < removedIds.size(); ++i) {
+            future = future.then(m_ao, [this, id = removedIds[i], isActive = i < activeCount] {
+                if (Task* task = findTaskById(id); task != nullptr) {
+                    if (!isActive) {
+                        task->taskController->asyncStop();
+                    }
+                    return task->taskController->asyncWaitForStopped();
+                }
+                return makeReadyFuture();
             });
         };
-        future = future.then(m_ao, [this] {
-            m_waitedTasks.clear();
+        future = future.then(m_ao, [this, removedIds = std::move(removedIds), activeCount] {
+            for (auto it = removedIds.begin() + static_cast<std::ptrdiff_t>(activeCount); it != removedIds.end();
+                 ++it) {
+                dropTask(*it);
+            }
         });
 
         return future;
@@ -190,30 +269,40 @@ public:
     Future<void> pause(TaskId id)
     {
         auto future = makeReadyFuture();
-        if (m_activeTask != nullptr && m_activeTask->id == id) {
-            m_activeTask->pause();
-            m_delayedTasks.emplace_back(std::move(m_activeTask));
-            m_activeTask = nullptr;
+        Task* task = findTaskById(id);
+        if (task == nullptr) {
+            return future;
+        }
 
-            resumeNextTask();
+        if (task->location == Location::Active) {
+            removeActive(*task);
+            task->pause();
+            task->moveTo(Location::Delayed);
+            ++m_delayedCount;
 
-        } else if (auto&& [waitedTask, _itw] = findTaskById(m_waitedTasks, id); waitedTask != nullptr) {
-            future = waitedTask->pausePromises.emplace_back().future();
+            resumeNextTasks();
+
+        } else if (task->location == Location::Waited) {
+            future = task->pausePromises.emplace_back().future();
         }
         return future;
     }
 
     Future<void> resume(TaskId id)
     {
-        if (auto&& [task, _it] = findTaskById(m_waitedTasks, id); task != nullptr) {
+        Task* task = findTaskById(id);
+        if (task == nullptr) {
+            return makeReadyFuture();
+        }
+
+        if (task->location == Location::Waited) {
             return task->resumePromises.emplace_back().future();
         }
 
-        if (auto&& [task, it] = findTaskById(m_delayedTasks, id); task != nullptr) {
-            auto resumingTask = std::move(task);
-            m_delayedTasks.erase(it);
-            auto ret = resumingTask->resumePromises.emplace_back().future();
-            schedule(std::move(resumingTask));
+        if (task->location == Location::Delayed) {
+            --m_delayedCount;
+            auto ret = task->resumePromises.emplace_back().future();
+            schedule(*task);
             return ret;
         }
         return makeReadyFuture();
@@ -221,68 +310,85 @@ public:
 
     [[nodiscard]] std::size_t size() const noexcept
     {
-        return m_waitedTasks.size() + m_delayedTasks.size() + (m_activeTask == nullptr ? 0 : 1);
+        return m_tasks.size();
     }
 
     [[nodiscard]] std::optional<ManageableTask::State> state(TaskId id) const noexcept
     {
-        if (m_activeTask != nullptr && m_activeTask->id == id) {
-            return m_activeTask->state();
-        }
-        if (auto&& [task, _it] = findTaskById(m_waitedTasks, id); task != nullptr) {
+        if (const Task* task = findTaskById(id); task != nullptr) {
             return task->state();
         }
+        return std::nullopt;
+    }
 
-        if (auto&& [task, it] = findTaskById(m_delayedTasks, id); task != nullptr) {
-            return task->state();
+    [[nodiscard]] std::optional<TaskStats> taskStats(TaskId id) const
+    {
+        if (const Task* task = findTaskById(id); task != nullptr) {
+            return task->currentStats(Clock::now());
         }
         return std::nullopt;
     }
 
+    [[nodiscard]] std::map<int, PriorityStats> stats() const
+    {
+        return m_stats;
+    }
+
 private:
     friend class Scheduler;
-    using TaskList = std::list<std::unique_ptr<Task>>;
 
-    static std::pair<std::unique_ptr<Task>&, TaskList::const_iterator> findTaskById(const TaskList& list, TaskId id)
+    [[nodiscard]] Task* findTaskById(TaskId id) const noexcept
     {
-        static std::unique_ptr<Task> nulTask = nullptr;
-        if (const auto it = std::find_if(list.begin(), list.end(),
-                                         [id](const auto& t) {
-                                             return t->id == id;
-                                         });
-            it != list.end()) {
-            //NOLINTNEXTLINE (cppcoreguidelines-pro-type-const-cast)
-            return {const_cast<std::unique_ptr<Task>&>(*it), it};
-        }
-        return {nulTask, list.end()};
+        const auto it = m_tasks.find(id);
+        return it != m_tasks.end() ? it->second.get() : nullptr;
     }
 
-    void schedule(std::unique_ptr<Task> task)
+    void schedule(Task& task)
     {
-        if (m_activeTask == nullptr) {
+        if (m_activeTasks.size() < m_options.concurrency) {
             assert(m_waitedTasks.empty());   // NOLINT
 
-            m_activeTask = std::move(task);
-            m_activeTask->resume();
+            activate(task);
+            return;
+        }
+
+        // Вытесняется активная задача с наименьшим приоритетом, из равных - запущенная последней
+        Task* victim = m_activeTasks.front();
+        for (Task* active : m_activeTasks) {
+            if (active->priority <= victim->priority) {
+                victim = active;
+            }
+        }
 
-        } else if (m_activeTask->priority < task->priority) {
-            m_activeTask->pause();
-            m_waitedTasks.emplace_back(std::move(m_activeTask));
+        if (victim->priority < task.priority) {
+            removeActive(*victim);
+            victim->pause();
+            // вытесненная задача будет запущена первой среди задач с таким же приоритетом
+            victim->moveTo(Location::Waited);
+            victim->queueHandle = m_waitedTasks.pushFront(victim->id, victim->priority);
 
-            m_activeTask = std::move(task);
-            m_activeTask->resume();
+            activate(task);
         } else {
-            queueTask(std::move(task));
+            queueTask(task);
         }
     }
 
-    void queueTask(std::unique_ptr<Task> task)
+    void activate(Task& task)
     {
-        auto taskPtrComparator = [](const std::unique_ptr<Task>& lhs, const std::unique_ptr<Task>& rhs) {
-            return *lhs < *rhs;
-        };
-        auto it = std::lower_bound(m_waitedTasks.begin(), m_waitedTasks.end(), task, taskPtrComparator);
-        m_waitedTasks.insert(it, std::move(task));
+        m_activeTasks.push_back(&task);
+        task.moveTo(Location::Active);
+        task.resume();
+    }
+
+    void removeActive(Task& task)
+    {
+        m_activeTasks.erase(std::find(m_activeTasks.begin(), m_activeTasks.end(), &task));
+    }
+
+    void queueTask(Task& task)
+    {
+        task.moveTo(Location::Waited);
+        task.queueHandle = m_waitedTasks.push(task.id, task.priority);
     }
 
     std::unique_ptr<Task> createTask(int priority, ManageableTask::TaskFunction task)
@@ -292,63 +398,125 @@ private:
         // finished task processing
         auto taskFinished = newTask->taskController->asyncWaitForStopped();
         taskFinished.then(m_ao, [this, finishedId = newTask->id] {
-            if (m_activeTask == nullptr || finishedId != m_activeTask->id) {
-                eraseTask(finishedId);
+            Task* task = findTaskById(finishedId);
+            if (task == nullptr) {
+                return;
+            }
+
+            if (task->location != Location::Active) {
+                eraseTask(*task);
             } else {
-                assert(m_activeTask->taskController->state() == ManageableTask::State::Stopped);   //NOLINT
-                m_activeTask = nullptr;
-                resumeNextTask();
+                assert(task->state() == ManageableTask::State::Stopped);   //NOLINT
+                removeActive(*task);
+                dropTask(finishedId);
+                resumeNextTasks();
             }
         });
         return newTask;
     }
 
-    void eraseTask(TaskId id)
+    void eraseTask(Task& task)
     {
-        auto&& [task, it] = findTaskById(m_waitedTasks, id);
-        if (task != nullptr) {
-            assert(task->state() == ManageableTask::State::Stopped);   // NOLINT
-            m_waitedTasks.erase(it);
+        assert(task.state() == ManageableTask::State::Stopped);   // NOLINT
+        switch (task.location) {
+        case Location::Waited:
+            m_waitedTasks.remove(task.queueHandle);
+            break;
+        case Location::Delayed:
+            --m_delayedCount;
+            break;
+        case Location::Active:
+        case Location::Removed:
+            // удаленные задачи будут удалены после остановки всех задач (clear)
             return;
         }
-        auto&& [delayedTask, delayedIt] = findTaskById(m_delayedTasks, id);
-        if (delayedTask != nullptr) {
-            assert(delayedTask->state() == ManageableTask::State::Stopped);   // NOLINT
-            m_delayedTasks.erase(delayedIt);
-        }
+        dropTask(task.id);
     }
 
-    void resumeNextTask()
+    // Удаляет задачу, учитывая ее время ожидания и выполнения в статистике
+    void dropTask(TaskId id)
     {
-        assert(m_activeTask == nullptr);   // NOLINT
-
-        if (!m_waitedTasks.empty()) {
-            m_activeTask = std::move(m_waitedTasks.back());
-            m_waitedTasks.pop_back();
-            if (m_activeTask->wasPaused()) {
-                m_activeTask->pause();
-                m_delayedTasks.emplace_back(std::move(m_activeTask));
-                m_activeTask = nullptr;
-                resumeNextTask();
-            } else {
-                m_activeTask->resume();
+        const auto it = m_tasks.find(id);
+        const auto taskStats = it->second->currentStats(Clock::now());
+
+        auto& priorityStats = m_stats[it->second->priority];
+        ++priorityStats.finishedCount;
+        priorityStats.waitTime += taskStats.waitTime;
+        priorityStats.runTime += taskStats.runTime;
+
+        m_tasks.erase(it);
+    }
+
+    void resumeNextTasks()
+    {
+        while (m_activeTasks.size() < m_options.concurrency) {
+            const auto id = m_waitedTasks.pop();
+            if (!id.has_value()) {
+                break;
             }
-        } else if (m_delayedTasks.empty()) {
+
+            Task* task = findTaskById(*id);
+            if (!task->wasPaused()) {
+                activate(*task);
+                continue;
+            }
+
+            task->pause();
+            task->moveTo(Location::Delayed);
+            ++m_delayedCount;
+        }
+
+        if (m_activeTasks.empty() && m_delayedCount == 0) {
             resolvePromises(m_waitStopPromises);
         }
     }
 
-    TaskList m_waitedTasks;    // запланированные задачи
-    TaskList m_delayedTasks;   // задачи в состоянии пауза, останутся в этом списке пока их не активируют
-    std::unique_ptr<Task> m_activeTask;
+    // Задачи, отработавшие квант времени, уступают место ожидающим задачам с тем же приоритетом
+    void rotateActiveTasks()
+    {
+        const auto now = Clock::now();
+
+        std::vector<Task*> expired;
+        for (Task* task : m_activeTasks) {
+            if (now - task->locationTime >= *m_options.timeSlice) {
+                expired.push_back(task);
+            }
+        }
+
+        for (Task* task : expired) {
+            const auto nextPriority = m_waitedTasks.topPriority();
+            if (!nextPriority.has_value() || *nextPriority < task->priority) {
+                continue;
+            }
+
+            removeActive(*task);
+            task->pause();
+            queueTask(*task);
+            resumeNextTasks();
+        }
+    }
+
+    const Options m_options;
+
+    std::unordered_map<TaskId, std::unique_ptr<Task>> m_tasks;   // все задачи
+    WaitQueue m_waitedTasks;                                     // запланированные задачи
+    std::size_t m_delayedCount{};                                // задачи в состоянии пауза
+    std::vector<Task*> m_activeTasks;                            // не больше Options::concurrency
     TaskId m_idCounter{0};
-    std::list<Promise<void>> m_waitStopPromises;
+    std::vector<Promise<void>> m_waitStopPromises;
+    std::map<int, PriorityStats> m_stats;
 
     ThreadExecutor m_executor;
     mutable AOContext m_ao;
 };
 
-Scheduler::Scheduler() = default;
+Scheduler::Scheduler()
+  : Scheduler(Options{})
+{}
+
+Scheduler::Scheduler(const Options& options)
+  : m_impl(options)
+{}
 
 Scheduler::~Scheduler()
 {
@@ -441,6 +609,13 @@ void Scheduler::activate(TaskId id)
     asyncActivate(id).get();
 }
 
+std::vector<Scheduler::TaskId> Scheduler::getActiveTaskIds() const
+{
+    return invoke(m_impl->m_ao, [this] {
+        return m_impl->getActiveTaskIds();
+    });
+}
+
 std::size_t Scheduler::size() const noexcept
 {
     return invoke(m_impl->m_ao, [this] {
@@ -455,4 +630,18 @@ std::optional<ManageableTask::State> Scheduler::getState(TaskId id) const noexce
     });
 }
 
+std::optional<Scheduler::TaskStats> Scheduler::getTaskStats(TaskId id) const
+{
+    return invoke(m_impl->m_ao, [this, id] {
+        return m_impl->taskStats(id);
+    });
+}
+
+std::map<int, Scheduler::PriorityStats> Scheduler::getStats() const
+{
+    return invoke(m_impl->m_ao, [this] {
+        return m_impl->stats();
+    });
+}
+
 }   // namespace nhope
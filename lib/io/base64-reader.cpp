@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string_view>
+#include <vector>
+
+#include <gsl/span>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/async/executor.h"
+#include "nhope/io/base64-reader.h"
+#include "nhope/io/io-device.h"
+#include "nhope/utils/base64.h"
+
+namespace nhope {
+
+namespace {
+
+class Base64ReaderImpl final : public Base64Reader
+{
+public:
+    Base64ReaderImpl(AOContext& parent, Reader& reader, bool skipSpaces)
+      : m_originReader(reader)
+      , m_decoder(skipSpaces)
+      , m_aoCtx(parent)
+    {}
+
+    ~Base64ReaderImpl() final
+    {
+        m_aoCtx.close();
+    }
+
+    void read(gsl::span<std::uint8_t> buf, IOHandler handler) final
+    {
+        if (m_decodedPos < m_decoded.size() || m_eof) {
+            const auto size = this->takeDecoded(buf);
+            m_aoCtx.exec([size, handler = std::move(handler)] {
+                handler(nullptr, size);
+            });
+            return;
+        }
+
+        // A chunk of text gives about as many bytes as the caller asked for
+        m_text.resize(std::clamp<std::size_t>(buf.size() / 3 * 4, minChunkSize, maxChunkSize));
+        m_originReader.read(
+          m_text,
+          [this, buf, aoCtx = AOContextRef(m_aoCtx), handler = std::move(handler)](auto err, auto size) mutable {
+              aoCtx.exec(
+                [this, buf, err = std::move(err), size, handler = std::move(handler)]() mutable {
+                    this->onTextRead(buf, std::move(err), size, std::move(handler));
+                },
+                Executor::ExecMode::ImmediatelyIfPossible);
+          });
+    }
+
+private:
+    static constexpr std::size_t minChunkSize = 256;
+    static constexpr std::size_t maxChunkSize = 64 * 1024;
+
+    void onTextRead(gsl::span<std::uint8_t> buf, std::exception_ptr err, std::size_t size, IOHandler handler)
+    {
+        if (err == nullptr) {
+            try {
+                this->decode(size);
+            } catch (...) {
+                err = std::current_exception();
+            }
+        }
+
+        if (err != nullptr) {
+            handler(std::move(err), 0);
+            return;
+        }
+
+        // The chunk may contain only spaces or a part of a group
+        this->read(buf, std::move(handler));
+    }
+
+    void decode(std::size_t size)
+    {
+        if (size == 0) {
+            m_eof = true;
+            m_decoder.finish();
+            return;
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto text = std::string_view(reinterpret_cast<const char*>(m_text.data()), size);
+        m_decoded.resize(m_decoder.updateMaxSize(text.size()));
+        m_decoded.resize(m_decoder.update(text, m_decoded));
+        m_decodedPos = 0;
+    }
+
+    std::size_t takeDecoded(gsl::span<std::uint8_t> buf)
+    {
+        const auto size = std::min(buf.size(), m_decoded.size() - m_decodedPos);
+        std::copy_n(m_decoded.begin() + static_cast<std::ptrdiff_t>(m_decodedPos), size, buf.begin());
+        m_decodedPos += size;
+        return size;
+    }
+
+    Reader& m_originReader;
+    Base64Decoder m_decoder;
+    std::vector<std::uint8_t> m_text;
+    std::vector<std::uint8_t> m_decoded;
+    std::size_t m_decodedPos = 0;
+    bool m_eof = false;
+    AOContext m_aoCtx;
+};
+
+class Base64ReaderOwnerImpl final : public Base64Reader
+{
+public:
+    Base64ReaderOwnerImpl(AOContext& parent, ReaderPtr reader, bool skipSpaces)
+      : m_originReader(std::move(reader))
+      , m_base64Reader(parent, *m_originReader, skipSpaces)
+    {}
+
+    void read(gsl::span<std::uint8_t> buf, IOHandler handler) final
+    {
+        m_base64Reader.read(buf, std::move(handler));
+    }
+
+private:
+    ReaderPtr m_originReader;
+    Base64ReaderImpl m_base64Reader;
+};
+
+}   // namespace
+
+Base64ReaderPtr Base64Reader::create(AOContext& aoCtx, Reader& reader, bool skipSpaces)
+{
+    return std::make_unique<Base64ReaderImpl>(aoCtx, reader, skipSpaces);
+}
+
+Base64ReaderPtr Base64Reader::create(AOContext& aoCtx, ReaderPtr reader, bool skipSpaces)
+{
+    return std::make_unique<Base64ReaderOwnerImpl>(aoCtx, std::move(reader), skipSpaces);
+}
+
+}   // namespace nhope
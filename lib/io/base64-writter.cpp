@@ -0,0 +1,89 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <gsl/span>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/io/base64-writter.h"
+#include "nhope/io/io-device.h"
+#include "nhope/utils/base64.h"
+
+#include "write-encoded.h"
+
+namespace nhope {
+
+namespace {
+
+class Base64WritterImpl final : public Base64Writter
+{
+public:
+    Base64WritterImpl(AOContext& parent, Writter& writter)
+      : m_originWritter(writter)
+      , m_aoCtx(parent)
+    {}
+
+    ~Base64WritterImpl() final
+    {
+        m_aoCtx.close();
+    }
+
+    void write(gsl::span<const std::uint8_t> data, IOHandler handler) final
+    {
+        m_text.resize(m_encoder.updateSize(data.size()));
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        m_text.resize(m_encoder.update(data, gsl::span(reinterpret_cast<char*>(m_text.data()), m_text.size())));
+        detail::writeEncoded(m_aoCtx, m_originWritter, m_text, data.size(), std::move(handler));
+    }
+
+    void finish(IOHandler handler) final
+    {
+        m_text.resize(Base64Encoder::maxFinishSize);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        m_text.resize(m_encoder.finish(gsl::span(reinterpret_cast<char*>(m_text.data()), m_text.size())));
+        detail::writeEncoded(m_aoCtx, m_originWritter, m_text, m_text.size(), std::move(handler));
+    }
+
+private:
+    Writter& m_originWritter;
+    Base64Encoder m_encoder;
+    std::vector<std::uint8_t> m_text;
+    AOContext m_aoCtx;
+};
+
+class Base64WritterOwnerImpl final : public Base64Writter
+{
+public:
+    Base64WritterOwnerImpl(AOContext& parent, WritterPtr writter)
+      : m_originWritter(std::move(writter))
+      , m_base64Writter(parent, *m_originWritter)
+    {}
+
+    void write(gsl::span<const std::uint8_t> data, IOHandler handler) final
+    {
+        m_base64Writter.write(data, std::move(handler));
+    }
+
+    void finish(IOHandler handler) final
+    {
+        m_base64Writter.finish(std::move(handler));
+    }
+
+private:
+    WritterPtr m_originWritter;
+    Base64WritterImpl m_base64Writter;
+};
+
+}   // namespace
+
+Base64WritterPtr Base64Writter::create(AOContext& aoCtx, Writter& writter)
+{
+    return std::make_unique<Base64WritterImpl>(aoCtx, writter);
+}
+
+Base64WritterPtr Base64Writter::create(AOContext& aoCtx, WritterPtr writter)
+{
+    return std::make_unique<Base64WritterOwnerImpl>(aoCtx, std::move(writter));
+}
+
+}   // namespace nhope
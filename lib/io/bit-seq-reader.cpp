@@ -1,24 +1,61 @@
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
 #include "nhope/io/bit-seq-reader.h"
+#include "nhope/utils/bits.h"
+#include "nhope/utils/bytes.h"
 
 namespace nhope {
 
 namespace {
 
+constexpr std::size_t wordBits = std::numeric_limits<std::uint64_t>::digits;
+constexpr std::size_t byteBits = std::numeric_limits<std::uint8_t>::digits;
+
+// Longer periods are generated word by word (e.g. PRBS-23 and longer)
+constexpr std::size_t maxPeriodSize = 1024 * 1024;
+
+// Short periods are repeated to copy at least so many bytes at once
+constexpr std::size_t minPeriodBufferSize = 4096;
+
+/* The pattern is stored packed (LSB first) and followed by its first 64 bits, so any 64 bits
+   of the sequence are read by two word loads without wraparound handling.
+
+   If the output repeats with a period of at most maxPeriodSize bytes (the pattern of n bits repeats
+   in bytes every n / gcd(n, 8) bytes), the period is generated once and read is a memcpy from it. */
 class BitSeqReaderImpl final : public BitSeqReader
 {
 public:
-    BitSeqReaderImpl(AOContext& parent, std::vector<bool> bits)
-      : m_bits(std::move(bits))
+    BitSeqReaderImpl(AOContext& parent, gsl::span<const std::uint8_t> packedBits, std::size_t bitCount)
+      : m_bitCount(bitCount)
       , m_aoCtx(parent)
-    {}
+    {
+        assert(bitCount > 0);   //NOLINT
+
+        m_words.resize((bitCount + wordBits) / wordBits + 2);
+        for (std::size_t i = 0; i < bitCount + wordBits; ++i) {
+            const auto pos = i % bitCount;
+            if (((packedBits[pos / byteBits] >> (pos % byteBits)) & 1) != 0) {
+                m_words[i / wordBits] |= std::uint64_t(1) << (i % wordBits);
+            }
+        }
+
+        const auto periodSize = bitCount / std::gcd(bitCount, byteBits);
+        if (periodSize <= maxPeriodSize) {
+            const auto repeats = (minPeriodBufferSize + periodSize - 1) / periodSize;
+            m_period.resize(periodSize * repeats);
+            this->generate(m_period);
+        }
+    }
 
     ~BitSeqReaderImpl() override
     {
@@ -28,11 +65,10 @@ public:
     void read(gsl::span<std::uint8_t> buf, IOHandler handler) override
     {
         m_aoCtx.exec([this, buf, handler = std::move(handler)] {
-            for (std::uint8_t& byte : buf) {
-                byte = this->nextBit() << 0;
-                for (int n = 1; n < std::numeric_limits<std::uint8_t>::digits; ++n) {
-                    byte |= this->nextBit() << n;
-                }
+            if (m_period.empty()) {
+                this->generate(buf);
+            } else {
+                this->copyPeriod(buf);
             }
 
             handler(nullptr, buf.size());
@@ -40,16 +76,61 @@ public:
     }
 
 private:
-    std::uint8_t nextBit()
+    // 64 bits of the sequence starting at pos
+    [[nodiscard]] std::uint64_t wordAt(std::size_t pos) const noexcept
     {
-        const auto bit = m_bits[m_pos];
-        m_pos = (m_pos + 1) % m_bits.size();
-        return bit ? 1 : 0;
+        const auto index = pos / wordBits;
+        const auto shift = pos % wordBits;
+        if (shift == 0) {
+            return m_words[index];
+        }
+        return (m_words[index] >> shift) | (m_words[index + 1] << (wordBits - shift));
     }
 
-    const std::vector<bool> m_bits;
+    void advance(std::size_t bits) noexcept
+    {
+        m_pos += bits;
+        if (m_pos >= m_bitCount) {
+            m_pos %= m_bitCount;
+        }
+    }
+
+    void generate(gsl::span<std::uint8_t> buf) noexcept
+    {
+        constexpr auto wordSize = sizeof(std::uint64_t);
+
+        auto* out = buf.data();
+        auto size = buf.size();
+        for (; size >= wordSize; size -= wordSize, out += wordSize) {
+            toBytes(this->wordAt(m_pos), gsl::span<std::uint8_t, wordSize>(out, wordSize), Endian::Little);
+            this->advance(wordBits);
+        }
+
+        if (size > 0) {
+            std::array<std::uint8_t, wordSize> tail{};
+            toBytes(this->wordAt(m_pos), tail, Endian::Little);
+            std::memcpy(out, tail.data(), size);
+            this->advance(size * byteBits);
+        }
+    }
+
+    void copyPeriod(gsl::span<std::uint8_t> buf) noexcept
+    {
+        while (!buf.empty()) {
+            const auto size = std::min(buf.size(), m_period.size() - m_offset);
+            std::memcpy(buf.data(), m_period.data() + m_offset, size);
+            buf = buf.subspan(size);
+            m_offset = (m_offset + size) % m_period.size();
+        }
+    }
+
+    const std::size_t m_bitCount;
+    std::vector<std::uint64_t> m_words;
     std::size_t m_pos = 0;
 
+    std::vector<std::uint8_t> m_period;
+    std::size_t m_offset = 0;
+
     AOContext m_aoCtx;
 };
 
@@ -57,28 +138,20 @@ private:
 
 BitSeqReaderPtr BitSeqReader::create(AOContext& aoCtx, std::vector<bool> bits)
 {
-    return std::make_unique<BitSeqReaderImpl>(aoCtx, std::move(bits));
+    std::vector<std::uint8_t> packed((bits.size() + byteBits - 1) / byteBits);
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+        if (bits[i]) {
+            packed[i / byteBits] |= static_cast<std::uint8_t>(1 << (i % byteBits));
+        }
+    }
+    return std::make_unique<BitSeqReaderImpl>(aoCtx, packed, bits.size());
 }
 
 BitSeqReaderPtr BitSeqReader::create(AOContext& aoCtx, gsl::span<const uint8_t> psp, std::size_t bitCount)
 {
-    const auto reserved = psp.size() * std::numeric_limits<uint8_t>::digits;
-
-    assert(bitCount <= reserved);   //NOLINT
+    assert(bitCount <= psp.size() * byteBits);   //NOLINT
 
-    std::vector<bool> temp;
-    temp.reserve(bitCount);
-
-    for (auto byte : psp) {
-        for (int n = 0; n < std::numeric_limits<uint8_t>::digits; ++n) {
-            temp.push_back(((byte >> n) & 1) != 0);
-            if (temp.size() == bitCount) {
-                goto end;
-            }
-        }
-    }
-end:
-    return std::make_unique<BitSeqReaderImpl>(aoCtx, std::move(temp));
+    return std::make_unique<BitSeqReaderImpl>(aoCtx, psp, bitCount);
 }
 
 }   // namespace nhope
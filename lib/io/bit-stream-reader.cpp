@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gsl/assert"
+#include "gsl/span"
+
+#include "nhope/async/ao-context-error.h"
+#include "nhope/async/ao-context.h"
+#include "nhope/async/executor.h"
+#include "nhope/async/future.h"
+#include "nhope/io/bit-stream-reader.h"
+#include "nhope/io/io-device.h"
+#include "nhope/utils/bit-stream.h"
+#include "nhope/utils/detail/ref-ptr.h"
+
+namespace nhope {
+
+namespace {
+
+constexpr std::size_t bufferSize = 4096;
+constexpr std::size_t maxFieldBits = 64;
+constexpr std::size_t byteBits = 8;
+
+template<BitOrder Order>
+class BitStreamReaderImpl final : public BitStreamReader
+{
+public:
+    BitStreamReaderImpl(AOContext& parent, Reader& reader)
+      : m_originReader(reader)
+      , m_buf(bufferSize)
+      , m_bits(gsl::span<const std::uint8_t>())
+      , m_aoCtx(parent)
+    {}
+
+    ~BitStreamReaderImpl() final
+    {
+        m_aoCtx.close();
+    }
+
+    void read(std::size_t bitCount, BitsHandler handler) final
+    {
+        Expects(bitCount <= maxFieldBits);
+
+        if (m_bits.bitsLeft() >= bitCount) {
+            m_aoCtx.exec([value = m_bits.readLong(bitCount), handler = std::move(handler)] {
+                handler(nullptr, value);
+            });
+            return;
+        }
+
+        this->readMore(bitCount, std::move(handler));
+    }
+
+private:
+    // Moves the unread bytes to the beginning of the buffer and appends the next chunk of the origin reader
+    void readMore(std::size_t bitCount, BitsHandler handler)
+    {
+        const auto position = m_bits.position();
+        const auto unread = gsl::span(m_buf).first(m_size).subspan(position / byteBits);
+        std::copy(unread.begin(), unread.end(), m_buf.begin());
+        m_size = unread.size();
+        m_bitOffset = position % byteBits;
+        this->resetBits();
+
+        const auto freeSpace = gsl::span(m_buf).subspan(m_size);
+        m_originReader.read(freeSpace, [this, bitCount, aoCtx = AOContextRef(m_aoCtx),
+                                        handler = std::move(handler)](auto err, auto size) mutable {
+            aoCtx.exec(
+              [this, bitCount, err = std::move(err), size, handler = std::move(handler)]() mutable {
+                  this->readHandler(std::move(err), size, bitCount, std::move(handler));
+              },
+              Executor::ExecMode::ImmediatelyIfPossible);
+        });
+    }
+
+    void readHandler(std::exception_ptr err, std::size_t size, std::size_t bitCount, BitsHandler handler)
+    {
+        if (err) {
+            handler(std::move(err), 0);
+            return;
+        }
+        if (size == 0) {
+            handler(std::make_exception_ptr(UnexpectedEndOfStream()), 0);
+            return;
+        }
+
+        m_size += size;
+        this->resetBits();
+
+        if (m_bits.bitsLeft() >= bitCount) {
+            handler(nullptr, m_bits.readLong(bitCount));
+            return;
+        }
+        this->readMore(bitCount, std::move(handler));
+    }
+
+    void resetBits()
+    {
+        m_bits = BitReader<Order>(gsl::span(m_buf).first(m_size));
+        m_bits.skip(m_bitOffset);
+    }
+
+    Reader& m_originReader;
+    std::vector<std::uint8_t> m_buf;
+    std::size_t m_size = 0;
+    std::size_t m_bitOffset = 0;
+    BitReader<Order> m_bits;
+    AOContext m_aoCtx;
+};
+
+template<BitOrder Order>
+class BitStreamReaderOwnerImpl final : public BitStreamReader
+{
+public:
+    BitStreamReaderOwnerImpl(AOContext& parent, ReaderPtr reader)
+      : m_originReader(std::move(reader))
+      , m_bitStreamReader(parent, *m_originReader)
+    {}
+
+    void read(std::size_t bitCount, BitsHandler handler) final
+    {
+        m_bitStreamReader.read(bitCount, std::move(handler));
+    }
+
+private:
+    ReaderPtr m_originReader;
+    BitStreamReaderImpl<Order> m_bitStreamReader;
+};
+
+class ReadBitsOp final : public detail::BaseRefCounter
+{
+public:
+    explicit ReadBitsOp(BitStreamReader& reader)
+      : m_reader(reader)
+    {}
+
+    ~ReadBitsOp()
+    {
+        if (!m_promise.satisfied()) {
+            m_promise.setException(std::make_exception_ptr(AsyncOperationWasCancelled()));
+        }
+    }
+
+    Future<std::uint64_t> start(std::size_t bitCount)
+    {
+        using detail::refPtrFromRawPtr;
+
+        m_reader.read(bitCount, [self = refPtrFromRawPtr(this)](auto err, auto value) {
+            if (err) {
+                self->m_promise.setException(std::move(err));
+                return;
+            }
+            self->m_promise.setValue(value);
+        });
+        return m_promise.future();
+    }
+
+private:
+    BitStreamReader& m_reader;   // NOLINT cppcoreguidelines-avoid-const-or-ref-data-members
+    Promise<std::uint64_t> m_promise;
+};
+
+}   // namespace
+
+UnexpectedEndOfStream::UnexpectedEndOfStream()
+  : std::runtime_error("Unexpected end of stream")
+{}
+
+BitStreamReaderPtr BitStreamReader::create(AOContext& aoCtx, Reader& reader, BitOrder order)
+{
+    if (order == BitOrder::MsbFirst) {
+        return std::make_unique<BitStreamReaderImpl<BitOrder::MsbFirst>>(aoCtx, reader);
+    }
+    return std::make_unique<BitStreamReaderImpl<BitOrder::LsbFirst>>(aoCtx, reader);
+}
+
+BitStreamReaderPtr BitStreamReader::create(AOContext& aoCtx, ReaderPtr reader, BitOrder order)
+{
+    if (order == BitOrder::MsbFirst) {
+        return std::make_unique<BitStreamReaderOwnerImpl<BitOrder::MsbFirst>>(aoCtx, std::move(reader));
+    }
+    return std::make_unique<BitStreamReaderOwnerImpl<BitOrder::LsbFirst>>(aoCtx, std::move(reader));
+}
+
+Future<std::uint64_t> readBits(BitStreamReader& reader, std::size_t bitCount)
+{
+    auto readOp = detail::makeRefPtr<ReadBitsOp>(reader);
+    return readOp->start(bitCount);
+}
+
+}   // namespace nhope
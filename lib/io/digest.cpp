@@ -0,0 +1,135 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include <gsl/span>
+
+#include "nhope/async/ao-context-error.h"
+#include "nhope/async/future.h"
+#include "nhope/io/digest.h"
+#include "nhope/io/io-device.h"
+#include "nhope/utils/detail/ref-ptr.h"
+#include "nhope/utils/md5.h"
+
+namespace nhope {
+
+namespace {
+
+class DigestManyOp final : public detail::BaseRefCounter
+{
+public:
+    static constexpr std::size_t bufferSize = detail::DigestOp<MD5>::bufferSize;
+
+    explicit DigestManyOp(gsl::span<Reader* const> devs)
+      : m_devs(devs.begin(), devs.end())
+      , m_bufs(devs.size(), std::vector<std::uint8_t>(bufferSize))
+      , m_results(devs.size())
+      , m_finished(devs.size())
+      , m_hash(devs.size())
+    {}
+
+    ~DigestManyOp()
+    {
+        if (!m_promise.satisfied()) {
+            m_promise.setException(std::make_exception_ptr(AsyncOperationWasCancelled()));
+        }
+    }
+
+    Future<std::vector<MD5::Digest>> start()
+    {
+        auto future = m_promise.future();
+        if (m_devs.empty()) {
+            m_promise.setValue(std::vector<MD5::Digest>());
+            return future;
+        }
+        this->readNextPortions();
+        return future;
+    }
+
+private:
+    struct ReadResult
+    {
+        std::exception_ptr err;
+        std::size_t count = 0;
+    };
+
+    // Reads a portion from every device, the last completed read handles the round
+    void readNextPortions()
+    {
+        std::size_t active = 0;
+        for (const bool finished : m_finished) {
+            active += finished ? 0 : 1;
+        }
+        m_pending = active;
+
+        for (std::size_t i = 0; i < m_devs.size(); ++i) {
+            if (m_finished[i]) {
+                continue;
+            }
+            m_devs[i]->read(m_bufs[i], [self = refPtrFromRawPtr(this), i](auto err, auto count) {
+                self->m_results[i] = ReadResult{std::move(err), count};
+                if (self->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    self->roundHandler();
+                }
+            });
+        }
+    }
+
+    void roundHandler()
+    {
+        std::vector<gsl::span<const std::uint8_t>> portions(m_devs.size());
+        bool allFinished = true;
+        for (std::size_t i = 0; i < m_devs.size(); ++i) {
+            if (m_finished[i]) {
+                continue;
+            }
+
+            auto& result = m_results[i];
+            if (result.err) {
+                m_promise.setException(std::move(result.err));
+                return;
+            }
+
+            if (result.count == 0) {
+                // EOF
+                m_finished[i] = true;
+                continue;
+            }
+
+            portions[i] = gsl::span<const std::uint8_t>(m_bufs[i]).first(result.count);
+            allFinished = false;
+        }
+
+        m_hash.update(portions);
+        if (!allFinished) {
+            this->readNextPortions();
+            return;
+        }
+
+        std::vector<MD5::Digest> digests(m_devs.size());
+        for (std::size_t i = 0; i < digests.size(); ++i) {
+            digests[i] = m_hash.digest(i);
+        }
+        m_promise.setValue(std::move(digests));
+    }
+
+    std::vector<Reader*> m_devs;
+    std::vector<std::vector<std::uint8_t>> m_bufs;
+    std::vector<ReadResult> m_results;
+    std::vector<bool> m_finished;
+    std::atomic<std::size_t> m_pending = 0;
+    MultiMD5 m_hash;
+    Promise<std::vector<MD5::Digest>> m_promise;
+};
+
+}   // namespace
+
+Future<std::vector<MD5::Digest>> digestMany(gsl::span<Reader* const> devs)
+{
+    return detail::makeRefPtr<DigestManyOp>(devs)->start();
+}
+
+}   // namespace nhope
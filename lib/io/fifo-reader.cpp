@@ -0,0 +1,140 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include <gsl/span>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/async/executor.h"
+#include "nhope/io/fifo-reader.h"
+#include "nhope/io/io-device.h"
+#include "nhope/seq/fifo.h"
+
+namespace nhope {
+
+namespace {
+
+using ReaderFifo = Fifo<std::uint8_t, FifoReader::bufferSize>;
+
+class FifoReaderImpl final : public FifoReader
+{
+public:
+    explicit FifoReaderImpl(AOContext& parent, Reader& reader)
+      : m_originReader(reader)
+      , m_fifo(std::make_shared<ReaderFifo>())
+      , m_aoCtx(parent)
+    {}
+
+    ~FifoReaderImpl() final
+    {
+        m_aoCtx.close();
+    }
+
+    void read(gsl::span<std::uint8_t> buf, IOHandler handler) final
+    {
+        if (!m_fifo->empty()) {
+            const auto size = this->take(buf);
+            m_aoCtx.exec([size, handler = std::move(handler)] {
+                handler(nullptr, size);
+            });
+            return;
+        }
+
+        if (buf.size() >= bufferSize) {
+            this->readOrigin(buf, std::move(handler));
+            return;
+        }
+
+        this->fill(buf, std::move(handler));
+    }
+
+    [[nodiscard]] std::size_t buffered() const final
+    {
+        return m_fifo->size();
+    }
+
+private:
+    std::size_t take(gsl::span<std::uint8_t> buf)
+    {
+        std::size_t size = 0;
+        for (auto part : m_fifo->data()) {
+            const auto n = std::min(part.size(), buf.size() - size);
+            std::memcpy(buf.data() + size, part.data(), n);
+            size += n;
+        }
+        m_fifo->consume(size);
+        return size;
+    }
+
+    void readOrigin(gsl::span<std::uint8_t> buf, IOHandler handler)
+    {
+        m_originReader.read(
+          buf, [aoCtx = AOContextRef(m_aoCtx), handler = std::move(handler)](auto err, auto size) mutable {
+              aoCtx.exec(
+                [err = std::move(err), size, handler = std::move(handler)] {
+                    handler(std::move(err), size);
+                },
+                Executor::ExecMode::ImmediatelyIfPossible);
+          });
+    }
+
+    void fill(gsl::span<std::uint8_t> buf, IOHandler handler)
+    {
+        // The fifo is empty, clearing moves the head to the beginning, so the whole buffer is contiguous.
+        // The callback holds the fifo, because the origin reader writes there until it calls the callback.
+        m_fifo->clear();
+        const auto space = m_fifo->prepare(bufferSize)[0];
+        m_originReader.read(space, [this, buf, fifo = m_fifo, aoCtx = AOContextRef(m_aoCtx),
+                                    handler = std::move(handler)](auto err, auto size) mutable {
+            aoCtx.exec(
+              [this, buf, err = std::move(err), size, handler = std::move(handler)] {
+                  m_fifo->commit(size);
+                  handler(std::move(err), this->take(buf));
+              },
+              Executor::ExecMode::ImmediatelyIfPossible);
+        });
+    }
+
+    Reader& m_originReader;
+    std::shared_ptr<ReaderFifo> m_fifo;
+    AOContext m_aoCtx;
+};
+
+class FifoReaderOwnerImpl final : public FifoReader
+{
+public:
+    FifoReaderOwnerImpl(AOContext& parent, ReaderPtr reader)
+      : m_originReader(std::move(reader))
+      , m_fifoReader(parent, *m_originReader)
+    {}
+
+    void read(gsl::span<std::uint8_t> buf, IOHandler handler) final
+    {
+        m_fifoReader.read(buf, std::move(handler));
+    }
+
+    [[nodiscard]] std::size_t buffered() const final
+    {
+        return m_fifoReader.buffered();
+    }
+
+private:
+    ReaderPtr m_originReader;
+    FifoReaderImpl m_fifoReader;
+};
+
+}   // namespace
+
+FifoReaderPtr FifoReader::create(AOContext& aoCtx, Reader& reader)
+{
+    return std::make_unique<FifoReaderImpl>(aoCtx, reader);
+}
+
+FifoReaderPtr FifoReader::create(AOContext& aoCtx, ReaderPtr reader)
+{
+    return std::make_unique<FifoReaderOwnerImpl>(aoCtx, std::move(reader));
+}
+
+}   // namespace nhope
@@ -0,0 +1,75 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <gsl/span>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/io/hex-writter.h"
+#include "nhope/io/io-device.h"
+#include "nhope/utils/hex.h"
+
+#include "write-encoded.h"
+
+namespace nhope {
+
+namespace {
+
+class HexWritterImpl final : public HexWritter
+{
+public:
+    HexWritterImpl(AOContext& parent, Writter& writter)
+      : m_originWritter(writter)
+      , m_aoCtx(parent)
+    {}
+
+    ~HexWritterImpl() final
+    {
+        m_aoCtx.close();
+    }
+
+    void write(gsl::span<const std::uint8_t> data, IOHandler handler) final
+    {
+        m_text.resize(data.size() * 2);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        toHex(data, gsl::span(reinterpret_cast<char*>(m_text.data()), m_text.size()));
+        detail::writeEncoded(m_aoCtx, m_originWritter, m_text, data.size(), std::move(handler));
+    }
+
+private:
+    Writter& m_originWritter;
+    std::vector<std::uint8_t> m_text;
+    AOContext m_aoCtx;
+};
+
+class HexWritterOwnerImpl final : public HexWritter
+{
+public:
+    HexWritterOwnerImpl(AOContext& parent, WritterPtr writter)
+      : m_originWritter(std::move(writter))
+      , m_hexWritter(parent, *m_originWritter)
+    {}
+
+    void write(gsl::span<const std::uint8_t> data, IOHandler handler) final
+    {
+        m_hexWritter.write(data, std::move(handler));
+    }
+
+private:
+    WritterPtr m_originWritter;
+    HexWritterImpl m_hexWritter;
+};
+
+}   // namespace
+
+HexWritterPtr HexWritter::create(AOContext& aoCtx, Writter& writter)
+{
+    return std::make_unique<HexWritterImpl>(aoCtx, writter);
+}
+
+HexWritterPtr HexWritter::create(AOContext& aoCtx, WritterPtr writter)
+{
+    return std::make_unique<HexWritterOwnerImpl>(aoCtx, std::move(writter));
+}
+
+}   // namespace nhope
@@ -1,3 +1,4 @@
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -100,6 +101,16 @@ public:
         asioDev.set_option(toAsio(params.flow));
         asioDev.set_option(toAsio(params.databits));
         asioDev.set_option(toAsio(params.stopbits));
+
+        if (params.minReadSize.has_value()) {
+            nhope::detail::setReadThreshold(asioDev, params.minReadSize.value());
+        }
+        if (params.customBaudrate.has_value()) {
+            nhope::detail::setBaudrate(asioDev, params.customBaudrate.value());
+        }
+        if (params.lowLatency.has_value()) {
+            nhope::detail::setLowLatency(asioDev, params.lowLatency.value());
+        }
     }
 
     void setRTS(bool state) override
@@ -116,6 +127,11 @@ public:
     {
         return nhope::detail::getModemControl(asioDev);
     }
+
+    std::size_t bytesAvailable() override
+    {
+        return nhope::detail::bytesAvailable(asioDev);
+    }
 };
 
 }   // namespace
@@ -0,0 +1,39 @@
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+#include <gsl/span>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/async/executor.h"
+#include "nhope/io/io-device.h"
+
+#include "write-encoded.h"
+
+namespace nhope::detail {
+
+void writeEncoded(AOContextRef aoCtx, Writter& origin, gsl::span<const std::uint8_t> text, std::size_t sourceSize,
+                  IOHandler handler)
+{
+    if (text.empty()) {
+        aoCtx.exec([sourceSize, handler = std::move(handler)] {
+            handler(nullptr, sourceSize);
+        });
+        return;
+    }
+
+    origin.write(text, [&origin, text, sourceSize, aoCtx, handler = std::move(handler)](auto err, auto size) mutable {
+        aoCtx.exec(
+          [aoCtx, &origin, text, sourceSize, err = std::move(err), size, handler = std::move(handler)]() mutable {
+              if (err != nullptr) {
+                  handler(std::move(err), 0);
+                  return;
+              }
+              writeEncoded(aoCtx, origin, text.subspan(size), sourceSize, std::move(handler));
+          },
+          Executor::ExecMode::ImmediatelyIfPossible);
+    });
+}
+
+}   // namespace nhope::detail
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <gsl/span>
+
+#include "nhope/async/ao-context.h"
+#include "nhope/io/io-device.h"
+
+namespace nhope::detail {
+
+/**
+ * @brief Writes the whole text produced by an encoding writter to the origin writter,
+ * then reports sourceSize (the size of the written source data) to the handler.
+ *
+ * The text must stay valid until the handler is called.
+ */
+void writeEncoded(AOContextRef aoCtx, Writter& origin, gsl::span<const std::uint8_t> text, std::size_t sourceSize,
+                  IOHandler handler);
+
+}   // namespace nhope::detail
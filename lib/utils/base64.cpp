@@ -1,84 +1,312 @@
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "fmt/format.h"
+#include "gsl/assert"
 #include "gsl/span"
 
 #include "nhope/utils/base64.h"
-#include "nhope/utils/string-utils.h"
+#include "nhope/utils/detail/compiler.h"
+#include "nhope/utils/detail/cpu-features.h"
+
+#if NHOPE_X86
+#include <immintrin.h>
+#endif
 
 namespace nhope {
 
 namespace {
 using namespace std::literals;
 
-std::uint8_t decode(char c)
+constexpr auto encodeTable = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                             "abcdefghijklmnopqrstuvwxyz"
+                             "0123456789+/"sv;
+
+constexpr std::uint8_t invalidCode = 0xff;
+constexpr std::uint8_t spaceCode = 0xfe;
+constexpr std::uint8_t paddingCode = 0xfd;
+
+constexpr std::array<std::uint8_t, 256> makeDecodeTable()
 {
-    if (c >= 'A' && c <= 'Z') {
-        return static_cast<std::uint8_t>(c - 'A');
+    std::array<std::uint8_t, 256> table{};
+    for (auto& code : table) {
+        code = invalidCode;
+    }
+    for (std::size_t i = 0; i < encodeTable.size(); ++i) {
+        table[static_cast<std::uint8_t>(encodeTable[i])] = static_cast<std::uint8_t>(i);
     }
+    // the same set as isspace in the "C" locale
+    for (const char c : " \t\n\v\f\r"sv) {
+        table[static_cast<std::uint8_t>(c)] = spaceCode;
+    }
+    table['='] = paddingCode;
+    return table;
+}
+
+constexpr auto decodeTable = makeDecodeTable();
 
-    if (c >= 'a' && c <= 'z') {
-        return static_cast<std::uint8_t>(c - 'a' + 26);
+[[noreturn]] void throwInvalidSymbol(char c)
+{
+    throw Base64ParseError(fmt::format("'{}': invalid symbol", c));
+}
+
+void encodeGroup(const std::uint8_t* in, char* out)
+{
+    out[0] = encodeTable[in[0] >> 2];
+    out[1] = encodeTable[((in[0] & 0x3) << 4) | (in[1] >> 4)];
+    out[2] = encodeTable[((in[1] & 0xf) << 2) | (in[2] >> 6)];
+    out[3] = encodeTable[in[2] & 0x3f];
+}
+
+void decodeGroup(const std::uint8_t* codes, std::uint8_t* out)
+{
+    out[0] = static_cast<std::uint8_t>((codes[0] << 2) | (codes[1] >> 4));
+    out[1] = static_cast<std::uint8_t>((codes[1] << 4) | (codes[2] >> 2));
+    out[2] = static_cast<std::uint8_t>((codes[2] << 6) | codes[3]);
+}
+
+/* Kernels process only whole groups: 3 bytes when encoding, 4 characters without spaces and padding
+   when decoding. They return the number of consumed input bytes, the rest is handled by the caller. */
+
+std::size_t encodeScalar(const std::uint8_t* in, std::size_t size, char* out)
+{
+    std::size_t i = 0;
+    for (; i + 3 <= size; i += 3, out += 4) {
+        encodeGroup(in + i, out);
     }
+    return i;
+}
 
-    if (c >= '0' && c <= '9') {
-        return static_cast<std::uint8_t>(c - '0' + 52);
+std::size_t decodeScalar(const char* in, std::size_t size, std::uint8_t* out)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= size; i += 4, out += 3) {
+        const std::array<std::uint8_t, 4> codes{
+          decodeTable[static_cast<std::uint8_t>(in[i])],
+          decodeTable[static_cast<std::uint8_t>(in[i + 1])],
+          decodeTable[static_cast<std::uint8_t>(in[i + 2])],
+          decodeTable[static_cast<std::uint8_t>(in[i + 3])],
+        };
+        // any special code has the high bits set
+        if (((codes[0] | codes[1] | codes[2] | codes[3]) & 0xc0) != 0) {
+            break;
+        }
+        decodeGroup(codes.data(), out);
     }
+    return i;
+}
+
+#if NHOPE_X86
 
-    if (c == '+') {
-        return 62;
+/* Vectorized codec by W. Mula and D. Lemire, "Faster Base64 Encoding and Decoding using AVX2 Instructions".
+   Encoding: the shuffle spreads 3 bytes to a 32-bit lane, multiplications move the four 6-bit fields
+   to separate bytes, the lookup adds the offset of the character range to each field.
+   Decoding: the high nibble gives the offset of the range, the pair of nibbles is checked against
+   the bitmask of valid characters, multiply-adds pack four 6-bit fields back to 3 bytes. */
+
+NHOPE_TARGET("ssse3,sse4.1") inline __m128i encodeLookup(__m128i indices)
+{
+    const auto shiftLut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+
+    auto result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const auto less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+    return _mm_add_epi8(_mm_shuffle_epi8(shiftLut, result), indices);
+}
+
+NHOPE_TARGET("ssse3,sse4.1") inline __m128i encodeSplit(__m128i in)
+{
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const auto t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const auto t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const auto t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const auto t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+NHOPE_TARGET("ssse3,sse4.1") std::size_t encodeSse41(const std::uint8_t* in, std::size_t size, char* out)
+{
+    std::size_t i = 0;
+    // 16 bytes are loaded, 12 of them are encoded
+    for (; i + 16 <= size; i += 12, out += 16) {
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));   // NOLINT
+        const auto chars = encodeLookup(encodeSplit(bytes));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);   // NOLINT
     }
+    return i + encodeScalar(in + i, size - i, out);
+}
 
-    if (c == '/') {
-        return 63;
+// Returns the offsets of the characters or a zero mask if some character is not base64
+NHOPE_TARGET("ssse3,sse4.1") inline bool decodeLookup(__m128i chars, __m128i& values)
+{
+    const auto shiftLut = _mm_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const auto maskLut = _mm_setr_epi8(                                       //
+      static_cast<char>(0xa8),                                                // 0
+      static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),   // 1..3
+      static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),   // 4..6
+      static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),   // 7..9
+      static_cast<char>(0xf0),                                                // 10
+      0x54,                                                                   // 11
+      0x50, 0x50, 0x50,                                                       // 12..14
+      0x54);                                                                  // 15
+    const auto bitposLut = _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80), 0, 0, 0,
+                                         0, 0, 0, 0, 0);
+
+    const auto hiNibbles = _mm_and_si128(_mm_srli_epi32(chars, 4), _mm_set1_epi8(0x0f));
+    const auto loNibbles = _mm_and_si128(chars, _mm_set1_epi8(0x0f));
+
+    const auto mask = _mm_shuffle_epi8(maskLut, loNibbles);
+    const auto bit = _mm_shuffle_epi8(bitposLut, hiNibbles);
+    const auto nonMatch = _mm_cmpeq_epi8(_mm_and_si128(mask, bit), _mm_setzero_si128());
+    if (_mm_movemask_epi8(nonMatch) != 0) {
+        return false;
     }
 
-    throw Base64ParseError(fmt::format("'{}': invalid symbol", c));
+    // '/' shares the high nibble with '+', but its offset is 16 instead of 19
+    const auto isSlash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('/'));
+    const auto shift = _mm_add_epi8(_mm_shuffle_epi8(shiftLut, hiNibbles), _mm_and_si128(isSlash, _mm_set1_epi8(-3)));
+    values = _mm_add_epi8(chars, shift);
+    return true;
 }
 
-std::vector<std::uint8_t> fromBase64Impl(std::string_view str)
+NHOPE_TARGET("ssse3,sse4.1") inline __m128i decodePack(__m128i values)
 {
-    const auto strLen = str.length();
+    const auto merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const auto packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
 
-    if (strLen == 0) {
-        return {};
+NHOPE_TARGET("ssse3,sse4.1") std::size_t decodeSse41(const char* in, std::size_t size, std::uint8_t* out)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16, out += 12) {
+        __m128i values;
+        if (!decodeLookup(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), values)) {   // NOLINT
+            break;
+        }
+        const auto bytes = decodePack(values);
+
+        // exactly 12 bytes are stored: the output may end right after them
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);   // NOLINT
+        const auto last = static_cast<std::uint32_t>(_mm_extract_epi32(bytes, 2));
+        std::memcpy(out + 8, &last, sizeof(last));
     }
+    return i + decodeScalar(in + i, size - i, out);
+}
 
-    if (strLen % 4 != 0) {
-        throw Base64ParseError("Illegal input length");
-    }
+NHOPE_TARGET("avx2") std::size_t encodeAvx2(const std::uint8_t* in, std::size_t size, char* out)
+{
+    const auto shuffle = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,   //
+                                         10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const auto shiftLut = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                                           'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
 
-    const auto totalBytes = strLen * 3 / 4 + 1;
-    std::vector<std::uint8_t> retval;
-    retval.reserve(totalBytes);
+    std::size_t i = 0;
+    // each 128-bit lane gets 12 bytes, the second load reads 16 bytes from i + 12
+    for (; i + 28 <= size; i += 24, out += 32) {
+        const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));        // NOLINT
+        const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12));   // NOLINT
+        auto bytes = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        bytes = _mm256_shuffle_epi8(bytes, shuffle);
+        const auto t0 = _mm256_and_si256(bytes, _mm256_set1_epi32(0x0fc0fc00));
+        const auto t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        const auto t2 = _mm256_and_si256(bytes, _mm256_set1_epi32(0x003f03f0));
+        const auto t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        const auto indices = _mm256_or_si256(t1, t3);
+
+        auto result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const auto less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        result = _mm256_add_epi8(_mm256_shuffle_epi8(shiftLut, result), indices);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), result);   // NOLINT
+    }
+    leaveAvx();
+    return i + encodeSse41(in + i, size - i, out);
+}
 
-    const auto n = str.back() == '=' ? strLen - 4 : strLen;
-    for (std::size_t i = 0; i < n; i += 4) {
-        const auto by1 = decode(str[i]);
-        const auto by2 = decode(str[i + 1]);
-        const auto by3 = decode(str[i + 2]);
-        const auto by4 = decode(str[i + 3]);
+NHOPE_TARGET("avx2") std::size_t decodeAvx2(const char* in, std::size_t size, std::uint8_t* out)
+{
+    const auto shiftLut = _mm256_setr_epi8(0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,   //
+                                           0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const auto maskLut = _mm256_broadcastsi128_si256(_mm_setr_epi8(
+      static_cast<char>(0xa8), static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf8),
+      static_cast<char>(0xf8), static_cast<char>(0xf8), static_cast<char>(0xf0), 0x54, 0x50, 0x50, 0x50, 0x54));
+    const auto bitposLut = _mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0));
+    const auto packShuffle = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,   //
+                                              2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
 
-        retval.push_back(static_cast<std::uint8_t>(by1 << 2) | (by2 >> 4));
-        retval.push_back(static_cast<std::uint8_t>((by2 & 0xf) << 4) | (by3 >> 2));
-        retval.push_back(static_cast<std::uint8_t>((by3 & 0x3) << 6) | by4);
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32, out += 24) {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));   // NOLINT
+        const auto hiNibbles = _mm256_and_si256(_mm256_srli_epi32(chars, 4), _mm256_set1_epi8(0x0f));
+        const auto loNibbles = _mm256_and_si256(chars, _mm256_set1_epi8(0x0f));
+
+        const auto mask = _mm256_shuffle_epi8(maskLut, loNibbles);
+        const auto bit = _mm256_shuffle_epi8(bitposLut, hiNibbles);
+        const auto nonMatch = _mm256_cmpeq_epi8(_mm256_and_si256(mask, bit), _mm256_setzero_si256());
+        if (_mm256_movemask_epi8(nonMatch) != 0) {
+            break;
+        }
+
+        const auto isSlash = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('/'));
+        const auto shift = _mm256_add_epi8(_mm256_shuffle_epi8(shiftLut, hiNibbles),
+                                           _mm256_and_si256(isSlash, _mm256_set1_epi8(-3)));
+        const auto values = _mm256_add_epi8(chars, shift);
+
+        const auto merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        auto bytes = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+        bytes = _mm256_shuffle_epi8(bytes, packShuffle);
+        bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+
+        // exactly 24 bytes are stored
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(bytes));             // NOLINT
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(bytes, 1));   // NOLINT
     }
+    leaveAvx();
+    return i + decodeSse41(in + i, size - i, out);
+}
+
+#endif
 
-    if (str.substr(strLen - 2) == "=="sv) {
-        const auto by1 = decode(str[strLen - 4]);
-        const auto by2 = decode(str[strLen - 3]);
-        retval.push_back(static_cast<std::uint8_t>(by1 << 2) | (by2 >> 4));
-    } else if (str.back() == '=') {
-        const auto by1 = decode(str[strLen - 4]);
-        const auto by2 = decode(str[strLen - 3]);
-        const auto by3 = decode(str[strLen - 2]);
-        retval.push_back(static_cast<std::uint8_t>(by1 << 2) | (by2 >> 4));
-        retval.push_back(static_cast<std::uint8_t>((by2 & 0xf) << 4) | (by3 >> 2));
+std::size_t encodeBlocks(const std::uint8_t* in, std::size_t size, char* out)
+{
+#if NHOPE_X86
+    switch (detail::simdLevel()) {
+    case detail::SimdLevel::Avx2:
+        return encodeAvx2(in, size, out);
+    case detail::SimdLevel::Sse41:
+        return encodeSse41(in, size, out);
+    case detail::SimdLevel::Scalar:
+        break;
     }
+#endif
+    return encodeScalar(in, size, out);
+}
 
-    return retval;
+std::size_t decodeBlocks(const char* in, std::size_t size, std::uint8_t* out)
+{
+#if NHOPE_X86
+    switch (detail::simdLevel()) {
+    case detail::SimdLevel::Avx2:
+        return decodeAvx2(in, size, out);
+    case detail::SimdLevel::Sse41:
+        return decodeSse41(in, size, out);
+    case detail::SimdLevel::Scalar:
+        break;
+    }
+#endif
+    return decodeScalar(in, size, out);
 }
 
 }   // namespace
@@ -87,59 +315,163 @@ Base64ParseError::Base64ParseError(std::string_view msg)
   : std::runtime_error(fmt::format("Base64 parse error: {}", msg))
 {}
 
-std::vector<std::uint8_t> fromBase64(std::string_view str, bool skipSpaces)
+std::size_t Base64Encoder::updateSize(std::size_t size) const noexcept
+{
+    return (m_tailSize + size) / 3 * 4;
+}
+
+std::size_t Base64Encoder::update(gsl::span<const std::uint8_t> data, gsl::span<char> out)
 {
-    if (skipSpaces) {
-        return fromBase64Impl(removeWhitespaces(str));
+    Expects(out.size() >= this->updateSize(data.size()));
+
+    std::size_t i = 0;
+    std::size_t written = 0;
+    if (m_tailSize > 0) {
+        while (m_tailSize < m_tail.size() && i < data.size()) {
+            m_tail[m_tailSize++] = data[i++];
+        }
+        if (m_tailSize < m_tail.size()) {
+            return 0;
+        }
+        encodeGroup(m_tail.data(), out.data());
+        m_tailSize = 0;
+        written = 4;
     }
 
-    return fromBase64Impl(str);
+    const auto consumed = encodeBlocks(data.data() + i, data.size() - i, out.data() + written);
+    i += consumed;
+    written += consumed / 3 * 4;
+
+    for (; i < data.size(); ++i) {
+        m_tail[m_tailSize++] = data[i];
+    }
+    return written;
 }
 
-std::string toBase64(gsl::span<const std::uint8_t> plainSeq)
+std::size_t Base64Encoder::finish(gsl::span<char> out)
 {
-    constexpr auto table = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-                           "abcdefghijklmnopqrstuvwxyz"
-                           "0123456789+/"sv;
+    Expects(m_tailSize == 0 || out.size() >= maxFinishSize);
+
+    const auto tailSize = std::exchange(m_tailSize, 0);
+    if (tailSize == 0) {
+        return 0;
+    }
 
-    const auto plainSize = plainSeq.size();
+    std::fill(m_tail.begin() + static_cast<std::ptrdiff_t>(tailSize), m_tail.end(), 0);
+    encodeGroup(m_tail.data(), out.data());
+    std::fill(out.begin() + static_cast<std::ptrdiff_t>(tailSize + 1), out.begin() + 4, '=');
+    return 4;
+}
 
-    // Reserve enough space for the returned base64 string
-    const auto base64Bytes = (((plainSeq.size() * 4) / 3) + 1);
-    const auto newlineBytes = (((base64Bytes * 2) / 76) + 1);
-    const auto totalBytes = base64Bytes + newlineBytes;
+Base64Decoder::Base64Decoder(bool skipSpaces)
+  : m_skipSpaces(skipSpaces)
+{}
 
-    std::string retval;
-    retval.reserve(totalBytes);
+std::size_t Base64Decoder::updateMaxSize(std::size_t size) const noexcept
+{
+    return (m_quantumSize + size) / 4 * 3;
+}
 
-    std::size_t i = 0;
-    for (i = 0; i + 2 < plainSize; i += 3) {
-        const auto by1 = plainSeq[i];
-        const auto by2 = plainSeq[i + 1];
-        const auto by3 = plainSeq[i + 2];
+std::size_t Base64Decoder::update(std::string_view text, gsl::span<std::uint8_t> out)
+{
+    Expects(out.size() >= this->updateMaxSize(text.size()));
 
-        retval += table[by1 >> 2];
-        retval += table[((by1 & 0x3) << 4) | (by2 >> 4)];
-        retval += table[((by2 & 0xf) << 2) | (by3 >> 6)];
-        retval += table[by3 & 0x3f];
+    std::size_t i = 0;
+    std::size_t written = 0;
+    while (i < text.size()) {
+        if (m_quantumSize == 0 && m_paddingSize == 0 && !m_finished) {
+            const auto consumed = decodeBlocks(text.data() + i, text.size() - i, out.data() + written);
+            i += consumed;
+            written += consumed / 4 * 3;
+        }
+        i += this->decodeScalar(text.substr(i), out.data(), written);
     }
+    return written;
+}
 
-    if (i + 1 == plainSize) {
-        const auto by1 = plainSeq[i];
+// Decodes by one character until the current group is completed, handles spaces and padding
+std::size_t Base64Decoder::decodeScalar(std::string_view text, std::uint8_t* out, std::size_t& written)
+{
+    std::size_t i = 0;
+    while (i < text.size()) {
+        const char c = text[i++];
+        const auto code = decodeTable[static_cast<std::uint8_t>(c)];
+
+        if (code < 64) {
+            if (m_finished || m_paddingSize > 0) {
+                throwInvalidSymbol(c);
+            }
+            m_quantum[m_quantumSize++] = code;
+            if (m_quantumSize == m_quantum.size()) {
+                decodeGroup(m_quantum.data(), out + written);
+                written += 3;
+                m_quantumSize = 0;
+                break;
+            }
+        } else if (code == spaceCode && m_skipSpaces) {
+            if (m_quantumSize == 0 && m_paddingSize == 0) {
+                break;
+            }
+        } else if (code == paddingCode && !m_finished && m_quantumSize >= 2) {
+            // "xx==" or "xxx=" can only end the text
+            if (m_quantumSize + ++m_paddingSize == m_quantum.size()) {
+                std::fill(m_quantum.begin() + static_cast<std::ptrdiff_t>(m_quantumSize), m_quantum.end(), 0);
+                std::array<std::uint8_t, 3> bytes{};
+                decodeGroup(m_quantum.data(), bytes.data());
+                std::copy_n(bytes.begin(), m_quantumSize - 1, out + written);
+                written += m_quantumSize - 1;
+
+                m_quantumSize = 0;
+                m_paddingSize = 0;
+                m_finished = true;
+            }
+        } else {
+            throwInvalidSymbol(c);
+        }
+    }
+    return i;
+}
 
-        retval += table[by1 >> 2];
-        retval += table[(by1 & 0x3) << 4];
-        retval += "=="sv;
-    } else if (i + 2 == plainSize) {
-        const auto by1 = plainSeq[i];
-        const auto by2 = plainSeq[i + 1];
+void Base64Decoder::finish()
+{
+    const auto incomplete = m_quantumSize + m_paddingSize != 0;
+    m_quantumSize = 0;
+    m_paddingSize = 0;
+    m_finished = false;
 
-        retval += table[by1 >> 2];
-        retval += table[((by1 & 0x3) << 4) | (by2 >> 4)];
-        retval += table[(by2 & 0xf) << 2];
-        retval += "="sv;
+    if (incomplete) {
+        throw Base64ParseError("Illegal input length");
     }
+}
+
+std::size_t fromBase64(std::string_view str, gsl::span<std::uint8_t> out, bool skipSpaces)
+{
+    Base64Decoder decoder(skipSpaces);
+    const auto written = decoder.update(str, out);
+    decoder.finish();
+    return written;
+}
+
+std::vector<std::uint8_t> fromBase64(std::string_view str, bool skipSpaces)
+{
+    std::vector<std::uint8_t> retval(base64DecodedMaxSize(str.size()));
+    retval.resize(fromBase64(str, retval, skipSpaces));
+    return retval;
+}
 
+std::size_t toBase64(gsl::span<const std::uint8_t> plainSeq, gsl::span<char> out)
+{
+    Expects(out.size() >= base64EncodedSize(plainSeq.size()));
+
+    Base64Encoder encoder;
+    const auto written = encoder.update(plainSeq, out);
+    return written + encoder.finish(out.subspan(written));
+}
+
+std::string toBase64(gsl::span<const std::uint8_t> plainSeq)
+{
+    std::string retval(base64EncodedSize(plainSeq.size()), '\0');
+    toBase64(plainSeq, gsl::span<char>(retval.data(), retval.size()));
     return retval;
 }
 
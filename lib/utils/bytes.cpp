@@ -0,0 +1,132 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "nhope/utils/bytes.h"
+#include "nhope/utils/detail/compiler.h"
+#include "nhope/utils/detail/cpu-features.h"
+
+#if NHOPE_X86
+#include <immintrin.h>
+#endif
+
+namespace nhope::detail {
+
+namespace {
+
+template<typename UInt>
+void copySwappedScalar(const std::uint8_t* in, std::uint8_t* out, std::size_t count) noexcept
+{
+    for (std::size_t i = 0; i < count; ++i, in += sizeof(UInt), out += sizeof(UInt)) {
+        UInt value{};
+        std::memcpy(&value, in, sizeof(UInt));
+        value = bytesSwap(value);
+        std::memcpy(out, &value, sizeof(UInt));
+    }
+}
+
+void copySwappedScalar(const std::uint8_t* in, std::uint8_t* out, std::size_t count, std::size_t width) noexcept
+{
+    switch (width) {
+    case sizeof(std::uint16_t):
+        copySwappedScalar<std::uint16_t>(in, out, count);
+        break;
+    case sizeof(std::uint32_t):
+        copySwappedScalar<std::uint32_t>(in, out, count);
+        break;
+    case sizeof(std::uint64_t):
+        copySwappedScalar<std::uint64_t>(in, out, count);
+        break;
+    default:
+        std::memcpy(out, in, count * width);
+        break;
+    }
+}
+
+#if NHOPE_X86
+
+// pshufb masks, which reverse the bytes of 2, 4 and 8 byte values
+using ShuffleMask = std::array<std::uint8_t, 16>;
+constexpr ShuffleMask swap16Mask = {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14};
+constexpr ShuffleMask swap32Mask = {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12};
+constexpr ShuffleMask swap64Mask = {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8};
+
+const ShuffleMask& shuffleMask(std::size_t width) noexcept
+{
+    switch (width) {
+    case sizeof(std::uint16_t):
+        return swap16Mask;
+    case sizeof(std::uint32_t):
+        return swap32Mask;
+    default:
+        return swap64Mask;
+    }
+}
+
+// Returns the number of processed bytes, a multiple of 32
+NHOPE_TARGET("ssse3")
+std::size_t copySwappedSsse3(const std::uint8_t* in, std::uint8_t* out, std::size_t size,
+                             const ShuffleMask& mask) noexcept
+{
+    const auto shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.data()));   // NOLINT
+
+    std::size_t i = 0;
+    for (; i + 2 * sizeof(__m128i) <= size; i += 2 * sizeof(__m128i)) {
+        const auto* src = reinterpret_cast<const __m128i*>(in + i);   // NOLINT
+        auto* dst = reinterpret_cast<__m128i*>(out + i);              // NOLINT
+        const auto v0 = _mm_loadu_si128(src);
+        const auto v1 = _mm_loadu_si128(src + 1);
+        _mm_storeu_si128(dst, _mm_shuffle_epi8(v0, shuffle));
+        _mm_storeu_si128(dst + 1, _mm_shuffle_epi8(v1, shuffle));
+    }
+    return i;
+}
+
+// Returns the number of processed bytes, a multiple of 64
+NHOPE_TARGET("avx2")
+std::size_t copySwappedAvx2(const std::uint8_t* in, std::uint8_t* out, std::size_t size,
+                            const ShuffleMask& mask) noexcept
+{
+    const auto shuffle =
+      _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.data())));   // NOLINT
+
+    std::size_t i = 0;
+    for (; i + 2 * sizeof(__m256i) <= size; i += 2 * sizeof(__m256i)) {
+        const auto* src = reinterpret_cast<const __m256i*>(in + i);   // NOLINT
+        auto* dst = reinterpret_cast<__m256i*>(out + i);              // NOLINT
+        const auto v0 = _mm256_loadu_si256(src);
+        const auto v1 = _mm256_loadu_si256(src + 1);
+        _mm256_storeu_si256(dst, _mm256_shuffle_epi8(v0, shuffle));
+        _mm256_storeu_si256(dst + 1, _mm256_shuffle_epi8(v1, shuffle));
+    }
+    leaveAvx();
+    return i;
+}
+
+#endif
+
+}   // namespace
+
+void copyBytesSwapped(const std::uint8_t* in, std::uint8_t* out, std::size_t count, std::size_t width) noexcept
+{
+    std::size_t done = 0;
+
+#if NHOPE_X86
+    const auto size = count * width;
+    switch (simdLevel()) {
+    case SimdLevel::Avx2:
+        done = copySwappedAvx2(in, out, size, shuffleMask(width));
+        [[fallthrough]];
+    case SimdLevel::Sse41:
+        done += copySwappedSsse3(in + done, out + done, size - done, shuffleMask(width));
+        break;
+    case SimdLevel::Scalar:
+        break;
+    }
+#endif
+
+    copySwappedScalar(in + done, out + done, count - done / width, width);
+}
+
+}   // namespace nhope::detail
@@ -0,0 +1,119 @@
+#include <atomic>
+
+#include "nhope/utils/detail/compiler.h"
+#include "nhope/utils/detail/cpu-features.h"
+
+#if NHOPE_X86 && defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace nhope::detail {
+
+namespace {
+
+SimdLevel detectSimdLevel() noexcept
+{
+#if NHOPE_X86 && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") != 0) {
+        return SimdLevel::Avx2;
+    }
+    if (__builtin_cpu_supports("ssse3") != 0 && __builtin_cpu_supports("sse4.1") != 0) {
+        return SimdLevel::Sse41;
+    }
+    return SimdLevel::Scalar;
+#elif NHOPE_X86 && defined(_MSC_VER)
+    constexpr int ssse3Bit = 1 << 9;
+    constexpr int sse41Bit = 1 << 19;
+    constexpr int osxsaveBit = 1 << 27;
+    constexpr int avxBit = 1 << 28;
+    constexpr int avx2Bit = 1 << 5;
+    constexpr unsigned long long ymmStateMask = 0x6;
+
+    int regs[4] = {};   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    __cpuid(regs, 0);
+    const int maxLeaf = regs[0];
+
+    __cpuid(regs, 1);
+    const int ecx1 = regs[2];
+    if ((ecx1 & ssse3Bit) == 0 || (ecx1 & sse41Bit) == 0) {
+        return SimdLevel::Scalar;
+    }
+
+    // AVX2 also needs the OS to save YMM registers
+    if (maxLeaf >= 7 && (ecx1 & osxsaveBit) != 0 && (ecx1 & avxBit) != 0 &&
+        (_xgetbv(0) & ymmStateMask) == ymmStateMask) {
+        __cpuidex(regs, 7, 0);
+        if ((regs[1] & avx2Bit) != 0) {
+            return SimdLevel::Avx2;
+        }
+    }
+    return SimdLevel::Sse41;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+bool detectCrc32Instructions() noexcept
+{
+#if NHOPE_X86 && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2") != 0;
+#elif NHOPE_X86 && defined(_MSC_VER)
+    constexpr int sse42Bit = 1 << 20;
+
+    int regs[4] = {};   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    __cpuid(regs, 1);
+    return (regs[2] & sse42Bit) != 0;
+#else
+    return false;
+#endif
+}
+
+bool detectClmulInstructions() noexcept
+{
+#if NHOPE_X86 && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("pclmul") != 0 && __builtin_cpu_supports("sse4.1") != 0;
+#elif NHOPE_X86 && defined(_MSC_VER)
+    constexpr int pclmulBit = 1 << 1;
+    constexpr int sse41Bit = 1 << 19;
+
+    int regs[4] = {};   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    __cpuid(regs, 1);
+    return (regs[2] & pclmulBit) != 0 && (regs[2] & sse41Bit) != 0;
+#else
+    return false;
+#endif
+}
+
+std::atomic<SimdLevel> levelLimit = SimdLevel::Avx2;
+
+}   // namespace
+
+SimdLevel simdLevel() noexcept
+{
+    static const SimdLevel detected = detectSimdLevel();
+    const auto limit = levelLimit.load(std::memory_order_relaxed);
+    return limit < detected ? limit : detected;
+}
+
+void setSimdLevelLimit(SimdLevel level) noexcept
+{
+    levelLimit.store(level, std::memory_order_relaxed);
+}
+
+bool hasCrc32Instructions() noexcept
+{
+    static const bool detected = detectCrc32Instructions();
+    return detected && levelLimit.load(std::memory_order_relaxed) != SimdLevel::Scalar;
+}
+
+bool hasClmulInstructions() noexcept
+{
+    static const bool detected = detectClmulInstructions();
+    return detected && levelLimit.load(std::memory_order_relaxed) != SimdLevel::Scalar;
+}
+
+}   // namespace nhope::detail
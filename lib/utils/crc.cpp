@@ -0,0 +1,345 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <gsl/span>
+
+#include "nhope/utils/crc.h"
+#include "nhope/utils/detail/compiler.h"
+#include "nhope/utils/detail/cpu-features.h"
+
+#if NHOPE_X86
+#include <immintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace nhope {
+
+namespace {
+
+constexpr std::uint32_t crc32Polynomial = 0x04c11db7;
+constexpr std::uint32_t crc32cPolynomial = 0x1edc6f41;
+
+constexpr auto crc32Tables = makeCrcTables<std::uint32_t>(crc32Polynomial, true);
+constexpr auto crc32cTables = makeCrcTables<std::uint32_t>(crc32cPolynomial, true);
+
+/* Constants for the carry-less multiplication kernels, see "Fast CRC Computation for Generic Polynomials
+   Using PCLMULQDQ Instruction" (Intel). Values are in the reflected notation: bit 31 is x^0. */
+
+// x^n mod P
+constexpr std::uint32_t xPowMod(std::size_t n, std::uint32_t polynomial) noexcept
+{
+    const auto poly = detail::reflectBits(polynomial);
+    std::uint32_t result = 0x80000000;
+    for (std::size_t i = 0; i < n; ++i) {
+        result = (result >> 1) ^ ((result & 1) != 0 ? poly : 0);
+    }
+    return result;
+}
+
+// floor(x^64 / P), 33 bits
+constexpr std::uint64_t barrettConstant(std::uint32_t polynomial) noexcept
+{
+    const auto p = (std::uint64_t(1) << 32) | polynomial;
+
+    std::uint64_t remainder = 0;
+    std::uint64_t quotient = 0;
+    for (int i = 64; i >= 0; --i) {
+        remainder = (remainder << 1) | (i == 64 ? 1 : 0);
+        quotient <<= 1;
+        if ((remainder >> 32) != 0) {
+            remainder ^= p;
+            quotient |= 1;
+        }
+    }
+
+    std::uint64_t result = 0;
+    for (int i = 0; i < 33; ++i) {
+        result = (result << 1) | (quotient & 1);
+        quotient >>= 1;
+    }
+    return result;
+}
+
+struct FoldConstants
+{
+    std::uint64_t k1;   // fold by 512 bits
+    std::uint64_t k2;
+    std::uint64_t k3;   // fold by 128 bits
+    std::uint64_t k4;
+    std::uint64_t k5;   // 96 to 64 bits
+    std::uint64_t mu;   // Barrett reduction
+    std::uint64_t poly;
+};
+
+constexpr std::uint64_t foldConstant(std::size_t n, std::uint32_t polynomial) noexcept
+{
+    return std::uint64_t(xPowMod(n, polynomial)) << 1;
+}
+
+constexpr FoldConstants makeFoldConstants(std::uint32_t polynomial) noexcept
+{
+    return {
+      foldConstant(4 * 128 + 32, polynomial),
+      foldConstant(4 * 128 - 32, polynomial),
+      foldConstant(128 + 32, polynomial),
+      foldConstant(128 - 32, polynomial),
+      foldConstant(64, polynomial),
+      barrettConstant(polynomial),
+      (std::uint64_t(detail::reflectBits(polynomial)) << 1) | 1,
+    };
+}
+
+constexpr auto crc32Fold = makeFoldConstants(crc32Polynomial);
+static_assert(crc32Fold.k1 == 0x154442bd4 && crc32Fold.k2 == 0x1c6e41596 && crc32Fold.mu == 0x1f7011641,
+              "fold constants of CRC-32 must match the published ones");
+
+/* crc32c of three independent streams is joined as crc(a) * x^(8 * 2 * block) + crc(b) * x^(8 * block) + crc(c).
+   Multiplication by k = x^(8n - 33): the 64-bit product of the clmul is reduced by the crc32 instruction,
+   which multiplies by x^32, the remaining x comes from the reflected notation of the product. */
+struct StripeConstants
+{
+    std::size_t block;
+    std::uint32_t shift1;
+    std::uint32_t shift2;
+};
+
+constexpr StripeConstants makeStripeConstants(std::size_t block) noexcept
+{
+    return {block, xPowMod(8 * block - 33, crc32cPolynomial), xPowMod(8 * 2 * block - 33, crc32cPolynomial)};
+}
+
+constexpr auto longStripe = makeStripeConstants(1024);
+constexpr auto shortStripe = makeStripeConstants(128);
+
+#if NHOPE_X86
+
+constexpr std::size_t clmulMinSize = 64;
+
+NHOPE_TARGET("sse4.1,pclmul")
+__m128i fold128(__m128i x, __m128i next, __m128i k) noexcept
+{
+    return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x11), _mm_clmulepi64_si128(x, k, 0x00)), next);
+}
+
+// size >= clmulMinSize and is a multiple of 16
+NHOPE_TARGET("sse4.1,pclmul")
+std::uint32_t crc32Clmul(std::uint32_t crc, const std::uint8_t* data, std::size_t size) noexcept
+{
+    const auto* in = reinterpret_cast<const __m128i*>(data);   // NOLINT
+
+    auto x1 = _mm_xor_si128(_mm_loadu_si128(in), _mm_cvtsi32_si128(static_cast<int>(crc)));
+    auto x2 = _mm_loadu_si128(in + 1);
+    auto x3 = _mm_loadu_si128(in + 2);
+    auto x4 = _mm_loadu_si128(in + 3);
+    in += 4;
+    size -= clmulMinSize;
+
+    // Fold 4 x 128 bits by 512 bits
+    auto k = _mm_set_epi64x(static_cast<long long>(crc32Fold.k2), static_cast<long long>(crc32Fold.k1));
+    for (; size >= clmulMinSize; size -= clmulMinSize, in += 4) {
+        const auto x5 = _mm_clmulepi64_si128(x1, k, 0x00);
+        const auto x6 = _mm_clmulepi64_si128(x2, k, 0x00);
+        const auto x7 = _mm_clmulepi64_si128(x3, k, 0x00);
+        const auto x8 = _mm_clmulepi64_si128(x4, k, 0x00);
+        x1 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x11), x5), _mm_loadu_si128(in));
+        x2 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x2, k, 0x11), x6), _mm_loadu_si128(in + 1));
+        x3 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x3, k, 0x11), x7), _mm_loadu_si128(in + 2));
+        x4 = _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x4, k, 0x11), x8), _mm_loadu_si128(in + 3));
+    }
+
+    // Fold into 128 bits, then the rest by 128 bits
+    k = _mm_set_epi64x(static_cast<long long>(crc32Fold.k4), static_cast<long long>(crc32Fold.k3));
+    x1 = fold128(x1, x2, k);
+    x1 = fold128(x1, x3, k);
+    x1 = fold128(x1, x4, k);
+    for (; size >= sizeof(__m128i); size -= sizeof(__m128i), ++in) {
+        x1 = fold128(x1, _mm_loadu_si128(in), k);
+    }
+
+    // 128 to 64 bits
+    const auto mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), _mm_clmulepi64_si128(x1, k, 0x10));
+    k = _mm_set_epi64x(0, static_cast<long long>(crc32Fold.k5));
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00), _mm_srli_si128(x1, 4));
+
+    // Barrett reduction to 32 bits
+    k = _mm_set_epi64x(static_cast<long long>(crc32Fold.mu), static_cast<long long>(crc32Fold.poly));
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask32), k, 0x00);
+    return static_cast<std::uint32_t>(_mm_extract_epi32(_mm_xor_si128(x1, x2), 1));
+}
+
+NHOPE_TARGET("sse4.2")
+std::uint32_t crc32cSse42(std::uint32_t crc, const std::uint8_t* data, std::size_t size) noexcept
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    std::uint64_t crc64 = crc;
+    for (; size >= sizeof(std::uint64_t); size -= sizeof(std::uint64_t), data += sizeof(std::uint64_t)) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = static_cast<std::uint32_t>(crc64);
+#endif
+    for (; size >= sizeof(std::uint32_t); size -= sizeof(std::uint32_t), data += sizeof(std::uint32_t)) {
+        std::uint32_t word = 0;
+        std::memcpy(&word, data, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+    }
+    for (; size > 0; --size, ++data) {
+        crc = _mm_crc32_u8(crc, *data);
+    }
+    return crc;
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+NHOPE_TARGET("sse4.2,pclmul")
+std::uint32_t crc32cShift(std::uint32_t crc, std::uint32_t k) noexcept
+{
+    const auto product =
+      _mm_clmulepi64_si128(_mm_cvtsi32_si128(static_cast<int>(crc)), _mm_cvtsi32_si128(static_cast<int>(k)), 0x00);
+    return static_cast<std::uint32_t>(_mm_crc32_u64(0, static_cast<std::uint64_t>(_mm_cvtsi128_si64(product))));
+}
+
+/* The crc32 instruction has latency 3 and throughput 1, so a single dependency chain uses a third of it.
+   Three streams are computed at once and joined by crc32cShift. */
+NHOPE_TARGET("sse4.2,pclmul")
+std::uint32_t crc32cStripes(std::uint32_t crc, const std::uint8_t*& data, std::size_t& size,
+                            const StripeConstants& stripe) noexcept
+{
+    const auto block = stripe.block;
+    for (; size >= 3 * block; size -= 3 * block, data += 3 * block) {
+        std::uint64_t a = crc;
+        std::uint64_t b = 0;
+        std::uint64_t c = 0;
+        for (std::size_t i = 0; i < block; i += sizeof(std::uint64_t)) {
+            std::uint64_t wa = 0;
+            std::uint64_t wb = 0;
+            std::uint64_t wc = 0;
+            std::memcpy(&wa, data + i, sizeof(wa));
+            std::memcpy(&wb, data + block + i, sizeof(wb));
+            std::memcpy(&wc, data + 2 * block + i, sizeof(wc));
+            a = _mm_crc32_u64(a, wa);
+            b = _mm_crc32_u64(b, wb);
+            c = _mm_crc32_u64(c, wc);
+        }
+        crc = crc32cShift(static_cast<std::uint32_t>(a), stripe.shift2) ^
+              crc32cShift(static_cast<std::uint32_t>(b), stripe.shift1) ^ static_cast<std::uint32_t>(c);
+    }
+    return crc;
+}
+
+NHOPE_TARGET("sse4.2,pclmul")
+std::uint32_t crc32cSse42Clmul(std::uint32_t crc, const std::uint8_t* data, std::size_t size) noexcept
+{
+    crc = crc32cStripes(crc, data, size, longStripe);
+    crc = crc32cStripes(crc, data, size, shortStripe);
+    return crc32cSse42(crc, data, size);
+}
+
+#endif
+
+#elif defined(__ARM_FEATURE_CRC32)
+
+std::uint32_t crc32cArm(std::uint32_t crc, const std::uint8_t* data, std::size_t size) noexcept
+{
+    for (; size >= sizeof(std::uint64_t); size -= sizeof(std::uint64_t), data += sizeof(std::uint64_t)) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32cd(crc, word);
+    }
+    for (; size > 0; --size, ++data) {
+        crc = __crc32cb(crc, *data);
+    }
+    return crc;
+}
+
+#endif
+
+std::uint32_t crc32(std::uint32_t crc, gsl::span<const std::uint8_t> data) noexcept
+{
+    const auto* p = data.data();
+    auto size = data.size();
+
+#if NHOPE_X86
+    if (size >= clmulMinSize && detail::hasClmulInstructions()) {
+        const auto blocksSize = size & ~(sizeof(__m128i) - 1);
+        crc = crc32Clmul(crc, p, blocksSize);
+        p += blocksSize;
+        size -= blocksSize;
+    }
+#endif
+    return detail::crcUpdate<std::uint32_t, true>(crc, crc32Tables, p, size);
+}
+
+std::uint32_t crc32c(std::uint32_t crc, gsl::span<const std::uint8_t> data) noexcept
+{
+#if NHOPE_X86
+    if (detail::hasCrc32Instructions()) {
+#if defined(__x86_64__) || defined(_M_X64)
+        if (data.size() >= 3 * shortStripe.block && detail::hasClmulInstructions()) {
+            return crc32cSse42Clmul(crc, data.data(), data.size());
+        }
+#endif
+        return crc32cSse42(crc, data.data(), data.size());
+    }
+#elif defined(__ARM_FEATURE_CRC32)
+    // The instructions are enabled at compile time (-march=armv8-a+crc)
+    return crc32cArm(crc, data.data(), data.size());
+#endif
+    return detail::crcUpdate<std::uint32_t, true>(crc, crc32cTables, data.data(), data.size());
+}
+
+}   // namespace
+
+void CRC32::reset()
+{
+    m_crc = initValue;
+}
+
+CRC32& CRC32::update(gsl::span<const std::uint8_t> data)
+{
+    m_crc = crc32(m_crc, data);
+    return *this;
+}
+
+CRC32::Digest CRC32::digest()
+{
+    const auto result = ~m_crc;
+    this->reset();
+    return result;
+}
+
+CRC32::Digest CRC32::digest(gsl::span<const std::uint8_t> data)
+{
+    return ~crc32(initValue, data);
+}
+
+void CRC32C::reset()
+{
+    m_crc = initValue;
+}
+
+CRC32C& CRC32C::update(gsl::span<const std::uint8_t> data)
+{
+    m_crc = crc32c(m_crc, data);
+    return *this;
+}
+
+CRC32C::Digest CRC32C::digest()
+{
+    const auto result = ~m_crc;
+    this->reset();
+    return result;
+}
+
+CRC32C::Digest CRC32C::digest(gsl::span<const std::uint8_t> data)
+{
+    return ~crc32c(initValue, data);
+}
+
+}   // namespace nhope
@@ -6,9 +6,15 @@
 #include <string_view>
 
 #include "fmt/format.h"
+#include "gsl/assert"
 
+#include "nhope/utils/detail/compiler.h"
+#include "nhope/utils/detail/cpu-features.h"
 #include "nhope/utils/hex.h"
-#include "nhope/utils/string-utils.h"
+
+#if NHOPE_X86
+#include <immintrin.h>
+#endif
 
 namespace nhope {
 using namespace std::literals;
@@ -19,14 +25,16 @@ HexParseError::HexParseError(const std::string_view msg)
 
 namespace {
 
+constexpr auto hexDigits = "0123456789abcdef"sv;
+
 constexpr std::array<char, 2> byteToHex(uint8_t v)
 {
-    constexpr auto hex = "0123456789abcdef"sv;
     //NOLINTNEXTLINE (readability-magic-numbers)
-    return {hex[v >> 4], hex[v & 0xF]};
+    return {hexDigits[v >> 4], hexDigits[v & 0xF]};
 }
 
 constexpr auto invalidHexValue = 16;
+constexpr auto spaceHexValue = 17;
 
 constexpr auto makeDecodeTable()
 {
@@ -43,6 +51,10 @@ constexpr auto makeDecodeTable()
             table[ch] = invalidHexValue;
         }
     }
+    // the same set as isspace in the "C" locale
+    for (const char ch : " \t\n\v\f\r"sv) {
+        table[static_cast<std::uint8_t>(ch)] = spaceHexValue;
+    }
 
     return table;
 }
@@ -52,13 +64,190 @@ constexpr auto decodeTable = makeDecodeTable();
 std::uint8_t fromHex(char ch)
 {
     const std::uint8_t val = decodeTable[static_cast<std::uint8_t>(ch)];
-    if (val == invalidHexValue) {
+    if (val >= invalidHexValue) {
         throw HexParseError(fmt::format("invalid value {}", ch));
     }
 
     return val;
 }
 
+/* Kernels encode whole input and decode pairs of hex digits without spaces,
+   they return the number of consumed input bytes. */
+
+std::size_t encodeScalar(const std::uint8_t* in, std::size_t size, char* out)
+{
+    for (std::size_t i = 0; i < size; ++i, out += 2) {
+        const auto t = byteToHex(in[i]);
+        out[0] = t[0];
+        out[1] = t[1];
+    }
+    return size;
+}
+
+std::size_t decodeScalar(const char* in, std::size_t size, std::uint8_t* out)
+{
+    std::size_t i = 0;
+    for (; i + 2 <= size; i += 2, ++out) {
+        const auto hi = decodeTable[static_cast<std::uint8_t>(in[i])];
+        const auto lo = decodeTable[static_cast<std::uint8_t>(in[i + 1])];
+        if ((hi | lo) >= invalidHexValue) {
+            break;
+        }
+        *out = static_cast<std::uint8_t>((hi << 4) | lo);
+    }
+    return i;
+}
+
+#if NHOPE_X86
+
+/* Encoding: the nibbles of each byte are looked up in the table of digits by pshufb and interleaved.
+   Decoding: digits and letters (case-folded by | 0x20) are range-checked by unsigned min,
+   pmaddubsw merges each pair of nibbles to hi * 16 + lo, packuswb narrows words to bytes. */
+
+NHOPE_TARGET("ssse3,sse4.1") std::size_t encodeSse41(const std::uint8_t* in, std::size_t size, char* out)
+{
+    const auto digits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hexDigits.data()));   // NOLINT
+    const auto nibbleMask = _mm_set1_epi8(0x0f);
+
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16, out += 32) {
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));   // NOLINT
+        const auto hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibbleMask));
+        const auto lo = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, nibbleMask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(hi, lo));        // NOLINT
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(hi, lo));   // NOLINT
+    }
+    return i + encodeScalar(in + i, size - i, out);
+}
+
+// Returns false if some character is not a hex digit
+NHOPE_TARGET("ssse3,sse4.1") inline bool decodeNibbles(__m128i chars, __m128i& values)
+{
+    const auto digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const auto isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits);
+    const auto letters = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const auto isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letters, _mm_set1_epi8(5)), letters);
+    if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xffff) {
+        return false;
+    }
+
+    values = _mm_or_si128(_mm_and_si128(isDigit, digits),
+                          _mm_and_si128(isLetter, _mm_add_epi8(letters, _mm_set1_epi8(10))));
+    return true;
+}
+
+NHOPE_TARGET("ssse3,sse4.1") std::size_t decodeSse41(const char* in, std::size_t size, std::uint8_t* out)
+{
+    const auto weights = _mm_set1_epi16(0x0110);
+
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32, out += 16) {
+        __m128i v0;
+        __m128i v1;
+        if (!decodeNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), v0) ||         // NOLINT
+            !decodeNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 16)), v1)) {   // NOLINT
+            break;
+        }
+        const auto words0 = _mm_maddubs_epi16(v0, weights);
+        const auto words1 = _mm_maddubs_epi16(v1, weights);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(words0, words1));   // NOLINT
+    }
+    return i + decodeScalar(in + i, size - i, out);
+}
+
+NHOPE_TARGET("avx2") std::size_t encodeAvx2(const std::uint8_t* in, std::size_t size, char* out)
+{
+    const auto digits = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(hexDigits.data())));   // NOLINT
+    const auto nibbleMask = _mm256_set1_epi8(0x0f);
+
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32, out += 64) {
+        const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));   // NOLINT
+        const auto hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibbleMask));
+        const auto lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, nibbleMask));
+
+        // unpack works inside 128-bit lanes, the lanes are put back in order
+        const auto first = _mm256_unpacklo_epi8(hi, lo);
+        const auto second = _mm256_unpackhi_epi8(hi, lo);
+        const auto firstHalf = _mm256_permute2x128_si256(first, second, 0x20);
+        const auto secondHalf = _mm256_permute2x128_si256(first, second, 0x31);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), firstHalf);         // NOLINT
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), secondHalf);   // NOLINT
+    }
+    leaveAvx();
+    return i + encodeSse41(in + i, size - i, out);
+}
+
+NHOPE_TARGET("avx2") inline bool decodeNibbles(__m256i chars, __m256i& values)
+{
+    const auto digits = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    const auto isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digits, _mm256_set1_epi8(9)), digits);
+    const auto letters = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    const auto isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letters, _mm256_set1_epi8(5)), letters);
+    if (_mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter)) != -1) {
+        return false;
+    }
+
+    values = _mm256_or_si256(_mm256_and_si256(isDigit, digits),
+                             _mm256_and_si256(isLetter, _mm256_add_epi8(letters, _mm256_set1_epi8(10))));
+    return true;
+}
+
+NHOPE_TARGET("avx2") std::size_t decodeAvx2(const char* in, std::size_t size, std::uint8_t* out)
+{
+    const auto weights = _mm256_set1_epi16(0x0110);
+
+    std::size_t i = 0;
+    for (; i + 64 <= size; i += 64, out += 32) {
+        __m256i v0;
+        __m256i v1;
+        if (!decodeNibbles(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), v0) ||         // NOLINT
+            !decodeNibbles(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 32)), v1)) {   // NOLINT
+            break;
+        }
+        const auto words0 = _mm256_maddubs_epi16(v0, weights);
+        const auto words1 = _mm256_maddubs_epi16(v1, weights);
+        // pack works inside 128-bit lanes: 64-bit quarters come as 0, 2, 1, 3
+        const auto bytes = _mm256_permute4x64_epi64(_mm256_packus_epi16(words0, words1), 0xd8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), bytes);   // NOLINT
+    }
+    leaveAvx();
+    return i + decodeSse41(in + i, size - i, out);
+}
+
+#endif
+
+std::size_t encodeBlocks(const std::uint8_t* in, std::size_t size, char* out)
+{
+#if NHOPE_X86
+    switch (detail::simdLevel()) {
+    case detail::SimdLevel::Avx2:
+        return encodeAvx2(in, size, out);
+    case detail::SimdLevel::Sse41:
+        return encodeSse41(in, size, out);
+    case detail::SimdLevel::Scalar:
+        break;
+    }
+#endif
+    return encodeScalar(in, size, out);
+}
+
+std::size_t decodeBlocks(const char* in, std::size_t size, std::uint8_t* out)
+{
+#if NHOPE_X86
+    switch (detail::simdLevel()) {
+    case detail::SimdLevel::Avx2:
+        return decodeAvx2(in, size, out);
+    case detail::SimdLevel::Sse41:
+        return decodeSse41(in, size, out);
+    case detail::SimdLevel::Scalar:
+        break;
+    }
+#endif
+    return decodeScalar(in, size, out);
+}
+
 }   // namespace
 
 std::uint8_t fromHex(char hi, char lo)
@@ -66,31 +255,89 @@ std::uint8_t fromHex(char hi, char lo)
     return (fromHex(hi) << 4) | fromHex(lo);
 }
 
-std::vector<uint8_t> fromHex(std::string_view hex)
+HexDecodeResult fromHex(std::string_view hex, gsl::span<uint8_t> out) noexcept
 {
-    std::vector<uint8_t> res;
-    res.reserve(hex.size() / 2);
-    const auto stripped = removeWhitespaces(hex);
-    const auto strippedSize = stripped.size();
-    if ((strippedSize & 0x1) != 0U) {
-        throw HexParseError(fmt::format("incorrect size {}: must be even", hex.size()));
+    Expects(out.size() >= hex.size() / 2);
+
+    // Text with spaces (e.g. "a6 e7 d3") would stop the kernels at each byte
+    constexpr std::size_t scalarRunSize = 64;
+
+    const auto value = [&hex](std::size_t pos) {
+        return decodeTable[static_cast<std::uint8_t>(hex[pos])];
+    };
+
+    HexDecodeResult result;
+    std::size_t i = 0;
+    std::size_t scalarEnd = 0;
+    while (i < hex.size()) {
+        if (i >= scalarEnd) {
+            const auto consumed = decodeBlocks(hex.data() + i, hex.size() - i, out.data() + result.size);
+            i += consumed;
+            result.size += consumed / 2;
+            if (i == hex.size()) {
+                break;
+            }
+            scalarEnd = i + scalarRunSize;
+        }
+
+        // Spaces and bytes split by spaces are decoded by one byte
+        const auto hi = value(i);
+        if (hi == spaceHexValue) {
+            ++i;
+            continue;
+        }
+        if (hi == invalidHexValue) {
+            result.errorPos = i;
+            return result;
+        }
+
+        auto j = i + 1;
+        while (j < hex.size() && value(j) == spaceHexValue) {
+            ++j;
+        }
+        if (j == hex.size()) {
+            result.errorPos = j;
+            return result;
+        }
+        const auto lo = value(j);
+        if (lo == invalidHexValue) {
+            result.errorPos = j;
+            return result;
+        }
+
+        out[result.size++] = static_cast<std::uint8_t>((hi << 4) | lo);
+        i = j + 1;
     }
-    for (std::size_t i = 0; i < strippedSize; i += 2) {
-        const auto byte = fromHex(stripped[i], stripped[i + 1]);
-        res.push_back(byte);
+    return result;
+}
+
+std::vector<uint8_t> fromHex(std::string_view hex)
+{
+    std::vector<uint8_t> res(hex.size() / 2);
+    const auto result = fromHex(hex, res);
+    if (!result.ok()) {
+        if (result.errorPos == hex.size()) {
+            throw HexParseError(fmt::format("incorrect size {}: must be even", hex.size()));
+        }
+        throw HexParseError(fmt::format("invalid value {} at {}", hex[result.errorPos], result.errorPos));
     }
 
+    res.resize(result.size);
     return res;
 }
 
+std::size_t toHex(gsl::span<const uint8_t> bytes, gsl::span<char> out) noexcept
+{
+    Expects(out.size() >= bytes.size() * 2);
+
+    encodeBlocks(bytes.data(), bytes.size(), out.data());
+    return bytes.size() * 2;
+}
+
 std::string toHex(gsl::span<const uint8_t> bytes)
 {
-    std::string hexStr;
-    hexStr.reserve(bytes.size() * 2);
-    for (auto v : bytes) {
-        const auto t = byteToHex(v);
-        hexStr.append(t.data(), t.size());
-    }
+    std::string hexStr(bytes.size() * 2, '\0');
+    toHex(bytes, gsl::span<char>(hexStr.data(), hexStr.size()));
     return hexStr;
 }
 
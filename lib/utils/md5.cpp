@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cerrno>
@@ -7,6 +8,7 @@
 #include <fstream>
 
 #include <fmt/format.h>
+#include <gsl/assert>
 #include <gsl/span>
 
 #include <ios>
@@ -15,10 +17,17 @@
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <vector>
 
 #include <nhope/utils/bytes.h>
+#include <nhope/utils/detail/compiler.h>
+#include <nhope/utils/detail/cpu-features.h>
 #include <nhope/utils/md5.h>
 
+#if NHOPE_X86
+#include <immintrin.h>
+#endif
+
 namespace {
 
 using namespace nhope;
@@ -231,6 +240,347 @@ constexpr void transform(gsl::span<std::uint32_t, 4> state, gsl::span<const std:
     state[3] += d;
 }
 
+/* Multi-buffer MD5: each 32-bit lane of a SIMD register holds the state of its own message,
+   so one pass over the 64 steps transforms a block of every message. */
+
+using LaneState = std::array<std::uint32_t, 4>;
+
+constexpr std::size_t maxLaneCount = 8;
+
+// Additive constants of the 64 steps (the same as in transform)
+constexpr std::array<std::uint32_t, 64> stepConstants = {
+  0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+  0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+  0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+  0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+  0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+  0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+  0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+  0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+};
+
+// Rotations of the steps: 4 per round, repeated
+constexpr std::array<std::uint32_t, 16> stepShifts = {
+  s11, s12, s13, s14, s21, s22, s23, s24, s31, s32, s33, s34, s41, s42, s43, s44,
+};
+
+// Index of the message word used by the step
+constexpr std::size_t wordIndex(std::size_t step)
+{
+    constexpr std::size_t wordCount = 16;
+    switch (step / wordCount) {
+    case 0:
+        return step;
+    case 1:
+        return (5 * step + 1) % wordCount;
+    case 2:
+        return (3 * step + 5) % wordCount;
+    default:
+        return (7 * step) % wordCount;
+    }
+}
+
+constexpr std::uint32_t stepShift(std::size_t step)
+{
+    return stepShifts[(step / 16) * 4 + step % 4];
+}
+
+/* Transforms blockCount consecutive blocks of data[lane] into *states[lane] for each lane.
+   The number of lanes is fixed by the kernel. */
+using LanesTransform = void (*)(LaneState* const* states, const std::uint8_t* const* data, std::size_t blockCount);
+
+void transformLanesScalar(LaneState* const* states, const std::uint8_t* const* data, std::size_t blockCount)
+{
+    for (std::size_t k = 0; k < blockCount; ++k) {
+        transform(*states[0], gsl::span<const std::uint8_t, MD5::blockSize>(data[0] + k * MD5::blockSize,
+                                                                             MD5::blockSize));
+    }
+}
+
+#if NHOPE_X86
+
+NHOPE_TARGET("ssse3,sse4.1") inline __m128i rotateLeft(__m128i x, std::uint32_t n)
+{
+    const auto left = _mm_sll_epi32(x, _mm_cvtsi32_si128(static_cast<int>(n)));
+    const auto right = _mm_srl_epi32(x, _mm_cvtsi32_si128(static_cast<int>(32 - n)));
+    return _mm_or_si128(left, right);
+}
+
+// a = b + ((a + f + x + ac) <<< s), then the registers are renamed: (a, b, c, d) = (d, a', b, c)
+NHOPE_TARGET("ssse3,sse4.1")
+inline void step(__m128i& a, __m128i& b, __m128i& c, __m128i& d, __m128i f, __m128i x, std::size_t i)
+{
+    const auto sum = _mm_add_epi32(_mm_add_epi32(a, f),
+                                   _mm_add_epi32(x, _mm_set1_epi32(static_cast<int>(stepConstants[i]))));
+    const auto newB = _mm_add_epi32(b, rotateLeft(sum, stepShift(i)));
+    a = d;
+    d = c;
+    c = b;
+    b = newB;
+}
+
+// The words of 4 lanes are transposed, so x[i] holds word i of every lane
+NHOPE_TARGET("ssse3,sse4.1") inline void loadWords(const std::uint8_t* const* data, std::size_t offset, __m128i* x)
+{
+    for (std::size_t w = 0; w < 16; w += 4) {
+        const auto r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data[0] + offset + w * 4));   // NOLINT
+        const auto r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data[1] + offset + w * 4));   // NOLINT
+        const auto r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data[2] + offset + w * 4));   // NOLINT
+        const auto r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data[3] + offset + w * 4));   // NOLINT
+
+        const auto t0 = _mm_unpacklo_epi32(r0, r1);
+        const auto t1 = _mm_unpacklo_epi32(r2, r3);
+        const auto t2 = _mm_unpackhi_epi32(r0, r1);
+        const auto t3 = _mm_unpackhi_epi32(r2, r3);
+        x[w] = _mm_unpacklo_epi64(t0, t1);
+        x[w + 1] = _mm_unpackhi_epi64(t0, t1);
+        x[w + 2] = _mm_unpacklo_epi64(t2, t3);
+        x[w + 3] = _mm_unpackhi_epi64(t2, t3);
+    }
+}
+
+NHOPE_TARGET("ssse3,sse4.1")
+void transformLanesSse41(LaneState* const* states, const std::uint8_t* const* data, std::size_t blockCount)
+{
+    constexpr std::size_t lanes = 4;
+
+    __m128i state[4];   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    for (std::size_t j = 0; j < 4; ++j) {
+        state[j] = _mm_setr_epi32(static_cast<int>((*states[0])[j]), static_cast<int>((*states[1])[j]),
+                                  static_cast<int>((*states[2])[j]), static_cast<int>((*states[3])[j]));
+    }
+
+    const auto ones = _mm_set1_epi32(-1);
+    __m128i x[16];   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    for (std::size_t k = 0; k < blockCount; ++k) {
+        loadWords(data, k * MD5::blockSize, x);
+
+        auto a = state[0];
+        auto b = state[1];
+        auto c = state[2];
+        auto d = state[3];
+        for (std::size_t i = 0; i < 16; ++i) {
+            const auto f = _mm_xor_si128(d, _mm_and_si128(b, _mm_xor_si128(c, d)));
+            step(a, b, c, d, f, x[wordIndex(i)], i);
+        }
+        for (std::size_t i = 16; i < 32; ++i) {
+            const auto g = _mm_xor_si128(c, _mm_and_si128(d, _mm_xor_si128(b, c)));
+            step(a, b, c, d, g, x[wordIndex(i)], i);
+        }
+        for (std::size_t i = 32; i < 48; ++i) {
+            const auto h = _mm_xor_si128(_mm_xor_si128(b, c), d);
+            step(a, b, c, d, h, x[wordIndex(i)], i);
+        }
+        for (std::size_t i = 48; i < 64; ++i) {
+            const auto ii = _mm_xor_si128(c, _mm_or_si128(b, _mm_xor_si128(d, ones)));
+            step(a, b, c, d, ii, x[wordIndex(i)], i);
+        }
+
+        state[0] = _mm_add_epi32(state[0], a);
+        state[1] = _mm_add_epi32(state[1], b);
+        state[2] = _mm_add_epi32(state[2], c);
+        state[3] = _mm_add_epi32(state[3], d);
+    }
+
+    for (std::size_t j = 0; j < 4; ++j) {
+        std::array<std::uint32_t, lanes> values{};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values.data()), state[j]);   // NOLINT
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            (*states[lane])[j] = values[lane];
+        }
+    }
+}
+
+NHOPE_TARGET("avx2") inline __m256i rotateLeft(__m256i x, std::uint32_t n)
+{
+    const auto left = _mm256_sll_epi32(x, _mm_cvtsi32_si128(static_cast<int>(n)));
+    const auto right = _mm256_srl_epi32(x, _mm_cvtsi32_si128(static_cast<int>(32 - n)));
+    return _mm256_or_si256(left, right);
+}
+
+NHOPE_TARGET("avx2")
+inline void step(__m256i& a, __m256i& b, __m256i& c, __m256i& d, __m256i f, __m256i x, std::size_t i)
+{
+    const auto sum = _mm256_add_epi32(_mm256_add_epi32(a, f),
+                                      _mm256_add_epi32(x, _mm256_set1_epi32(static_cast<int>(stepConstants[i]))));
+    const auto newB = _mm256_add_epi32(b, rotateLeft(sum, stepShift(i)));
+    a = d;
+    d = c;
+    c = b;
+    b = newB;
+}
+
+// 8x8 transpose of 32-bit words: unpack inside 128-bit lanes, then exchange the lanes
+NHOPE_TARGET("avx2") inline void loadWords(const std::uint8_t* const* data, std::size_t offset, __m256i* x)
+{
+    for (std::size_t w = 0; w < 16; w += 8) {
+        __m256i r[8];   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+        for (std::size_t lane = 0; lane < 8; ++lane) {
+            r[lane] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data[lane] + offset + w * 4));   // NOLINT
+        }
+
+        const auto t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+        const auto t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+        const auto t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+        const auto t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+        const auto t4 = _mm256_unpacklo_epi32(r[4], r[5]);
+        const auto t5 = _mm256_unpackhi_epi32(r[4], r[5]);
+        const auto t6 = _mm256_unpacklo_epi32(r[6], r[7]);
+        const auto t7 = _mm256_unpackhi_epi32(r[6], r[7]);
+
+        const auto u0 = _mm256_unpacklo_epi64(t0, t2);   // words 0 and 4 of lanes 0..3
+        const auto u1 = _mm256_unpackhi_epi64(t0, t2);   // words 1 and 5
+        const auto u2 = _mm256_unpacklo_epi64(t1, t3);   // words 2 and 6
+        const auto u3 = _mm256_unpackhi_epi64(t1, t3);   // words 3 and 7
+        const auto u4 = _mm256_unpacklo_epi64(t4, t6);   // the same for lanes 4..7
+        const auto u5 = _mm256_unpackhi_epi64(t4, t6);
+        const auto u6 = _mm256_unpacklo_epi64(t5, t7);
+        const auto u7 = _mm256_unpackhi_epi64(t5, t7);
+
+        x[w] = _mm256_permute2x128_si256(u0, u4, 0x20);
+        x[w + 1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+        x[w + 2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+        x[w + 3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+        x[w + 4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+        x[w + 5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+        x[w + 6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+        x[w + 7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+    }
+}
+
+NHOPE_TARGET("avx2")
+void transformLanesAvx2(LaneState* const* states, const std::uint8_t* const* data, std::size_t blockCount)
+{
+    constexpr std::size_t lanes = 8;
+
+    __m256i state[4];   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    for (std::size_t j = 0; j < 4; ++j) {
+        std::array<std::uint32_t, lanes> values{};
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            values[lane] = (*states[lane])[j];
+        }
+        state[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values.data()));   // NOLINT
+    }
+
+    const auto ones = _mm256_set1_epi32(-1);
+    __m256i x[16];   // NOLINT(cppcoreguidelines-avoid-c-arrays)
+    for (std::size_t k = 0; k < blockCount; ++k) {
+        loadWords(data, k * MD5::blockSize, x);
+
+        auto a = state[0];
+        auto b = state[1];
+        auto c = state[2];
+        auto d = state[3];
+        for (std::size_t i = 0; i < 16; ++i) {
+            const auto f = _mm256_xor_si256(d, _mm256_and_si256(b, _mm256_xor_si256(c, d)));
+            step(a, b, c, d, f, x[wordIndex(i)], i);
+        }
+        for (std::size_t i = 16; i < 32; ++i) {
+            const auto g = _mm256_xor_si256(c, _mm256_and_si256(d, _mm256_xor_si256(b, c)));
+            step(a, b, c, d, g, x[wordIndex(i)], i);
+        }
+        for (std::size_t i = 32; i < 48; ++i) {
+            const auto h = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+            step(a, b, c, d, h, x[wordIndex(i)], i);
+        }
+        for (std::size_t i = 48; i < 64; ++i) {
+            const auto ii = _mm256_xor_si256(c, _mm256_or_si256(b, _mm256_xor_si256(d, ones)));
+            step(a, b, c, d, ii, x[wordIndex(i)], i);
+        }
+
+        state[0] = _mm256_add_epi32(state[0], a);
+        state[1] = _mm256_add_epi32(state[1], b);
+        state[2] = _mm256_add_epi32(state[2], c);
+        state[3] = _mm256_add_epi32(state[3], d);
+    }
+
+    for (std::size_t j = 0; j < 4; ++j) {
+        std::array<std::uint32_t, lanes> values{};
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values.data()), state[j]);   // NOLINT
+        for (std::size_t lane = 0; lane < lanes; ++lane) {
+            (*states[lane])[j] = values[lane];
+        }
+    }
+    leaveAvx();
+}
+
+#endif
+
+struct LanesKernel
+{
+    LanesTransform transform;
+    std::size_t laneCount;
+};
+
+LanesKernel lanesKernel() noexcept
+{
+#if NHOPE_X86
+    switch (detail::simdLevel()) {
+    case detail::SimdLevel::Avx2:
+        return {transformLanesAvx2, 8};
+    case detail::SimdLevel::Sse41:
+        return {transformLanesSse41, 4};
+    case detail::SimdLevel::Scalar:
+        break;
+    }
+#endif
+    return {transformLanesScalar, 1};
+}
+
+/* Transforms the full blocks of data[i] into *states[i] for each of count streams, the streams are taken by groups
+   of kernel.laneCount. data[i] is advanced to its tail. */
+void transformFullBlocks(const LanesKernel& kernel, LaneState* const* states, gsl::span<const std::uint8_t>* data,
+                         std::size_t count)
+{
+    LaneState scratchState{};
+    for (std::size_t first = 0; first < count; first += kernel.laneCount) {
+        const auto groupSize = std::min(kernel.laneCount, count - first);
+        while (true) {
+            std::size_t activeCount = 0;
+            std::size_t firstActive = 0;
+            std::size_t blockCount = static_cast<std::size_t>(-1);
+            for (std::size_t l = groupSize; l-- > 0;) {
+                const auto blocks = data[first + l].size() / MD5::blockSize;
+                if (blocks > 0) {
+                    ++activeCount;
+                    firstActive = first + l;
+                    blockCount = std::min(blockCount, blocks);
+                }
+            }
+
+            if (activeCount == 0) {
+                break;
+            }
+
+            if (activeCount == 1) {
+                auto& rest = data[firstActive];
+                const auto size = rest.size() / MD5::blockSize * MD5::blockSize;
+                transformLanesScalar(&states[firstActive], std::array{rest.data()}.data(), size / MD5::blockSize);
+                rest = rest.subspan(size);
+                continue;
+            }
+
+            // Idle lanes repeat the data of an active one and write to the scratch state
+            std::array<LaneState*, maxLaneCount> laneStates{};
+            std::array<const std::uint8_t*, maxLaneCount> laneData{};
+            for (std::size_t l = 0; l < kernel.laneCount; ++l) {
+                const auto active = l < groupSize && data[first + l].size() >= MD5::blockSize;
+                laneStates[l] = active ? states[first + l] : &scratchState;
+                laneData[l] = active ? data[first + l].data() : data[firstActive].data();
+            }
+
+            kernel.transform(laneStates.data(), laneData.data(), blockCount);
+
+            for (std::size_t l = 0; l < groupSize; ++l) {
+                auto& rest = data[first + l];
+                if (rest.size() >= MD5::blockSize) {
+                    rest = rest.subspan(blockCount * MD5::blockSize);
+                }
+            }
+        }
+    }
+}
+
 std::size_t read(std::istream& stream, gsl::span<std::uint8_t> buf)
 {
     // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
@@ -353,3 +703,158 @@ MD5::Digest MD5::fileDigest(const std::filesystem::path& filePath)
 
     return MD5::digest(stream);
 }
+
+std::vector<MD5::Digest> MD5::digestMany(gsl::span<const gsl::span<const std::uint8_t>> messages)
+{
+    static constexpr auto npos = static_cast<std::size_t>(-1);
+
+    // A lane hashes the full blocks of one message, the tail is hashed when the lane is released
+    struct Lane
+    {
+        std::size_t message = npos;
+        std::size_t offset = 0;
+        LaneState state{};
+    };
+
+    const auto kernel = lanesKernel();
+    std::vector<Digest> digests(messages.size());
+    std::array<Lane, maxLaneCount> lanes{};
+    LaneState scratchState{};
+
+    const auto fullBlocksLeft = [&](const Lane& lane) {
+        return (messages[lane.message].size() - lane.offset) / blockSize;
+    };
+    const auto finish = [&](Lane& lane) {
+        MD5 md5;
+        md5.m_context.state = lane.state;
+        md5.m_context.count = static_cast<std::uint64_t>(lane.offset) << 3;
+        md5.update(messages[lane.message].subspan(lane.offset));
+        digests[lane.message] = md5.digest();
+        lane.message = npos;
+    };
+
+    std::size_t next = 0;
+    while (true) {
+        std::size_t activeCount = 0;
+        Lane* firstActive = nullptr;
+        for (std::size_t l = 0; l < kernel.laneCount; ++l) {
+            auto& lane = lanes[l];
+            while (lane.message == npos && next < messages.size()) {
+                const auto m = next++;
+                if (messages[m].size() < blockSize) {
+                    // Nothing to parallelize: the message is hashed with padding only
+                    digests[m] = MD5::digest(messages[m]);
+                    continue;
+                }
+                lane.message = m;
+                lane.offset = 0;
+                lane.state = Context().state;
+            }
+            if (lane.message != npos) {
+                ++activeCount;
+                firstActive = firstActive == nullptr ? &lane : firstActive;
+            }
+        }
+
+        if (activeCount == 0) {
+            break;
+        }
+
+        // The last message is not worth the idle lanes
+        if (activeCount == 1 && next == messages.size()) {
+            auto& lane = *firstActive;
+            const auto size = fullBlocksLeft(lane) * blockSize;
+            const auto data = messages[lane.message].subspan(lane.offset, size);
+            transformLanesScalar(std::array{&lane.state}.data(), std::array{data.data()}.data(), size / blockSize);
+            lane.offset += size;
+            finish(lane);
+            continue;
+        }
+
+        // Idle lanes repeat the data of an active one and write to the scratch state
+        std::array<LaneState*, maxLaneCount> states{};
+        std::array<const std::uint8_t*, maxLaneCount> data{};
+        std::size_t blockCount = static_cast<std::size_t>(-1);
+        for (std::size_t l = 0; l < kernel.laneCount; ++l) {
+            auto& lane = lanes[l];
+            if (lane.message == npos) {
+                states[l] = &scratchState;
+                data[l] = messages[firstActive->message].data() + firstActive->offset;
+            } else {
+                states[l] = &lane.state;
+                data[l] = messages[lane.message].data() + lane.offset;
+                blockCount = std::min(blockCount, fullBlocksLeft(lane));
+            }
+        }
+
+        kernel.transform(states.data(), data.data(), blockCount);
+
+        for (std::size_t l = 0; l < kernel.laneCount; ++l) {
+            auto& lane = lanes[l];
+            if (lane.message == npos) {
+                continue;
+            }
+            lane.offset += blockCount * blockSize;
+            if (fullBlocksLeft(lane) == 0) {
+                finish(lane);
+            }
+        }
+    }
+
+    return digests;
+}
+
+std::size_t MD5::laneCount() noexcept
+{
+    return lanesKernel().laneCount;
+}
+
+MultiMD5::MultiMD5(std::size_t streamCount)
+  : m_streams(streamCount)
+{}
+
+std::size_t MultiMD5::streamCount() const noexcept
+{
+    return m_streams.size();
+}
+
+void MultiMD5::update(gsl::span<const gsl::span<const std::uint8_t>> portions)
+{
+    Expects(portions.size() == m_streams.size());
+
+    std::vector<gsl::span<const std::uint8_t>> rest(portions.begin(), portions.end());
+    std::vector<LaneState*> states(m_streams.size());
+    for (std::size_t i = 0; i < m_streams.size(); ++i) {
+        auto& md5 = m_streams[i];
+
+        // The buffered part of a block is completed by the scalar code
+        const auto index = static_cast<std::size_t>((md5.m_context.count >> 3) & 0x3f);   // NOLINT
+        if (index != 0) {
+            const auto size = std::min(MD5::blockSize - index, rest[i].size());
+            md5.update(rest[i].first(size));
+            rest[i] = rest[i].subspan(size);
+        }
+        states[i] = &md5.m_context.state;
+    }
+
+    const auto sizes = [&] {
+        std::vector<std::size_t> result;
+        result.reserve(rest.size());
+        for (const auto& r : rest) {
+            result.push_back(r.size());
+        }
+        return result;
+    }();
+    transformFullBlocks(lanesKernel(), states.data(), rest.data(), rest.size());
+
+    for (std::size_t i = 0; i < m_streams.size(); ++i) {
+        auto& md5 = m_streams[i];
+        md5.m_context.count += static_cast<std::uint64_t>(sizes[i] - rest[i].size()) << 3;
+        md5.update(rest[i]);
+    }
+}
+
+MD5::Digest MultiMD5::digest(std::size_t stream)
+{
+    return m_streams.at(stream).digest();
+}
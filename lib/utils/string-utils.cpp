@@ -1,49 +1,399 @@
-#include <cctype>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 
+#include "gsl/assert"
+#include "gsl/span"
+
+#include "nhope/utils/detail/compiler.h"
+#include "nhope/utils/detail/cpu-features.h"
 #include "nhope/utils/string-utils.h"
 
+#if NHOPE_X86
+#include <immintrin.h>
+#endif
+#if NHOPE_X86 && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
 namespace nhope {
+using namespace std::literals;
 
-std::string removeWhitespaces(std::string_view s)
+namespace {
+
+using CharTable = std::array<std::uint8_t, UCHAR_MAX + 1>;
+
+constexpr CharTable makeSpaceTable()
+{
+    CharTable table{};
+    // the same set as isspace in the "C" locale
+    for (const char ch : " \t\n\v\f\r"sv) {
+        table[static_cast<std::uint8_t>(ch)] = 1;
+    }
+    return table;
+}
+
+constexpr CharTable makeEscapeTable()
+{
+    // Number of characters added by the entity
+    CharTable table{};
+    table['<'] = "&lt;"sv.size() - 1;
+    table['>'] = "&gt;"sv.size() - 1;
+    table['&'] = "&amp;"sv.size() - 1;
+    table['"'] = "&quot;"sv.size() - 1;
+    return table;
+}
+
+constexpr auto spaceTable = makeSpaceTable();
+constexpr auto escapeTable = makeEscapeTable();
+constexpr std::size_t maxEntitySize = "&quot;"sv.size();
+
+/* Kernels return the end of the written output. Whole blocks without whitespaces or HTML metacharacters
+   are copied by one store, the other blocks are processed by scalar code or compacted by pshufb. */
+
+char* removeSpacesScalar(const char* in, std::size_t size, char* out) noexcept
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        *out = in[i];
+        out += 1 - spaceTable[static_cast<std::uint8_t>(in[i])];
+    }
+    return out;
+}
+
+std::size_t escapedExtraScalar(const char* in, std::size_t size) noexcept
+{
+    std::size_t extra = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        extra += escapeTable[static_cast<std::uint8_t>(in[i])];
+    }
+    return extra;
+}
+
+char* appendEntity(std::string_view entity, char* out) noexcept
+{
+    std::memcpy(out, entity.data(), entity.size());
+    return out + entity.size();
+}
+
+char* appendEscaped(char ch, char* out) noexcept
+{
+    switch (ch) {
+    case '<':
+        return appendEntity("&lt;"sv, out);
+    case '>':
+        return appendEntity("&gt;"sv, out);
+    case '&':
+        return appendEntity("&amp;"sv, out);
+    case '"':
+        return appendEntity("&quot;"sv, out);
+    default:
+        *out = ch;
+        return out + 1;
+    }
+}
+
+char* escapeScalar(const char* in, std::size_t size, char* out) noexcept
+{
+    for (std::size_t i = 0; i < size; ++i) {
+        out = appendEscaped(in[i], out);
+    }
+    return out;
+}
+
+#if NHOPE_X86
+
+// Index of the lowest set bit of mask != 0
+inline unsigned lowestBit(unsigned mask) noexcept
 {
-    std::string result;
-    result.reserve(s.size());
-    for (char symbol : s) {
-        if (isspace(symbol) == 0) {
-            result += symbol;
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+// pshufb indices, which move the non-space bytes of 8 bytes (a bit of the mask is set for a space) to the front
+struct CompactTable
+{
+    std::array<std::array<std::uint8_t, 8>, UCHAR_MAX + 1> indices{};
+    std::array<std::uint8_t, UCHAR_MAX + 1> sizes{};
+};
+
+constexpr CompactTable makeCompactTable()
+{
+    CompactTable table{};
+    for (std::size_t mask = 0; mask < table.indices.size(); ++mask) {
+        std::uint8_t size = 0;
+        for (std::uint8_t bit = 0; bit < 8; ++bit) {
+            if (((mask >> bit) & 1) == 0) {
+                table.indices[mask][size++] = bit;
+            }
         }
+        table.sizes[mask] = size;
     }
-    result.shrink_to_fit();
-    return result;
+    return table;
 }
 
-std::string toHtmlEscaped(std::string_view s)
+constexpr auto compactTable = makeCompactTable();
+
+NHOPE_TARGET("ssse3,sse4.1") inline unsigned spaceMask(__m128i chars)
+{
+    // '\t', '\n', '\v', '\f', '\r' are 9..13
+    const auto controls = _mm_sub_epi8(chars, _mm_set1_epi8('\t'));
+    const auto isControl = _mm_cmpeq_epi8(_mm_min_epu8(controls, _mm_set1_epi8('\r' - '\t')), controls);
+    const auto isSpace = _mm_or_si128(isControl, _mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')));
+    return static_cast<unsigned>(_mm_movemask_epi8(isSpace));
+}
+
+// Inlined into the AVX2 kernel too, where it gets the VEX encoding
+NHOPE_ALWAYS_INLINE NHOPE_TARGET("ssse3,sse4.1") char* compact(__m128i chars, unsigned mask, char* out)
+{
+    const auto lo = mask & 0xff;
+    const auto hi = mask >> 8;
+    const auto& table = compactTable.indices;
+    const auto indicesLo = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(table[lo].data()));   // NOLINT
+    const auto indicesHi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(table[hi].data()));   // NOLINT
+    const auto indices = _mm_unpacklo_epi64(indicesLo, _mm_add_epi8(indicesHi, _mm_set1_epi8(8)));
+
+    // Each half is stored by 8 bytes, the garbage after the kept bytes is overwritten by the next stores
+    const auto compacted = _mm_shuffle_epi8(chars, indices);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), compacted);   // NOLINT
+    out += compactTable.sizes[lo];
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_unpackhi_epi64(compacted, compacted));   // NOLINT
+    return out + compactTable.sizes[hi];
+}
+
+NHOPE_TARGET("ssse3,sse4.1") char* removeSpacesSse41(const char* in, std::size_t size, char* out)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));   // NOLINT
+        const auto mask = spaceMask(chars);
+        if (mask == 0) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);   // NOLINT
+            out += 16;
+            continue;
+        }
+        out = compact(chars, mask, out);
+    }
+    return removeSpacesScalar(in + i, size - i, out);
+}
+
+// Byte weights of the metacharacters (the number of added characters), other bytes are 0
+NHOPE_TARGET("ssse3,sse4.1") inline __m128i escapeWeights(__m128i chars)
+{
+    const auto ltGt =
+      _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('<')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('>')));
+    const auto amp = _mm_cmpeq_epi8(chars, _mm_set1_epi8('&'));
+    const auto quot = _mm_cmpeq_epi8(chars, _mm_set1_epi8('"'));
+    return _mm_or_si128(_mm_or_si128(_mm_and_si128(ltGt, _mm_set1_epi8(escapeTable['<'])),
+                                     _mm_and_si128(amp, _mm_set1_epi8(escapeTable['&']))),
+                        _mm_and_si128(quot, _mm_set1_epi8(escapeTable['"'])));
+}
+
+// Also works on 32-bit x86, which has no _mm_extract_epi64
+NHOPE_TARGET("ssse3,sse4.1") inline std::size_t sum64(__m128i sums)
+{
+    std::array<std::uint64_t, 2> parts{};
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(parts.data()), sums);   // NOLINT
+    return static_cast<std::size_t>(parts[0] + parts[1]);
+}
+
+NHOPE_TARGET("ssse3,sse4.1") std::size_t escapedExtraSse41(const char* in, std::size_t size)
 {
-    std::string rich;
-    //NOLINTNEXTLINE (readability-magic-numbers)
-    rich.reserve(int(static_cast<double>(s.size()) * 1.1));
-    for (auto c : s) {
-        switch (c) {
-        case '<':
-            rich += "&lt;";
-            break;
-        case '>':
-            rich += "&gt;";
-            break;
-        case '&':
-            rich += "&amp;";
-            break;
-        case '"':
-            rich += "&quot;";
-
-            break;
-        default:
-            rich += c;
-            break;
+    auto sums = _mm_setzero_si128();
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));   // NOLINT
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(escapeWeights(chars), _mm_setzero_si128()));
+    }
+    return sum64(sums) + escapedExtraScalar(in + i, size - i);
+}
+
+/* The block is stored as is up to the first metacharacter, which is replaced by its entity,
+   the next block starts after it. Output has room for the block, since it is not shorter than the input. */
+NHOPE_TARGET("ssse3,sse4.1") char* escapeSse41(const char* in, std::size_t size, char* out)
+{
+    std::size_t i = 0;
+    while (i + 16 <= size) {
+        const auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));   // NOLINT
+        const auto weights = escapeWeights(chars);
+        const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(weights, _mm_setzero_si128())));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);   // NOLINT
+        if (mask == 0) {
+            i += 16;
+            out += 16;
+            continue;
+        }
+
+        const auto pos = lowestBit(mask);
+        out = appendEscaped(in[i + pos], out + pos);
+        i += pos + 1;
+    }
+    return escapeScalar(in + i, size - i, out);
+}
+
+NHOPE_TARGET("avx2") inline unsigned spaceMask(__m256i chars)
+{
+    const auto controls = _mm256_sub_epi8(chars, _mm256_set1_epi8('\t'));
+    const auto isControl = _mm256_cmpeq_epi8(_mm256_min_epu8(controls, _mm256_set1_epi8('\r' - '\t')), controls);
+    const auto isSpace = _mm256_or_si256(isControl, _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' ')));
+    return static_cast<unsigned>(_mm256_movemask_epi8(isSpace));
+}
+
+NHOPE_TARGET("avx2") char* removeSpacesAvx2(const char* in, std::size_t size, char* out)
+{
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));   // NOLINT
+        const auto mask = spaceMask(chars);
+        if (mask == 0) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chars);   // NOLINT
+            out += 32;
+            continue;
+        }
+        out = compact(_mm256_castsi256_si128(chars), mask & 0xffff, out);
+        out = compact(_mm256_extracti128_si256(chars, 1), mask >> 16, out);
+    }
+    leaveAvx();
+    return removeSpacesSse41(in + i, size - i, out);
+}
+
+NHOPE_TARGET("avx2") inline __m256i escapeWeights(__m256i chars)
+{
+    const auto ltGt =
+      _mm256_or_si256(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('<')), _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('>')));
+    const auto amp = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('&'));
+    const auto quot = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8('"'));
+    return _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(ltGt, _mm256_set1_epi8(escapeTable['<'])),
+                                           _mm256_and_si256(amp, _mm256_set1_epi8(escapeTable['&']))),
+                           _mm256_and_si256(quot, _mm256_set1_epi8(escapeTable['"'])));
+}
+
+NHOPE_TARGET("avx2") std::size_t escapedExtraAvx2(const char* in, std::size_t size)
+{
+    auto sums = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));   // NOLINT
+        sums = _mm256_add_epi64(sums, _mm256_sad_epu8(escapeWeights(chars), _mm256_setzero_si256()));
+    }
+    const auto extra = sum64(_mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1)));
+    leaveAvx();
+    return extra + escapedExtraSse41(in + i, size - i);
+}
+
+// See escapeSse41
+NHOPE_TARGET("avx2") char* escapeAvx2(const char* in, std::size_t size, char* out)
+{
+    std::size_t i = 0;
+    while (i + 32 <= size) {
+        const auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));   // NOLINT
+        const auto weights = escapeWeights(chars);
+        const auto isSpecial = _mm256_cmpgt_epi8(weights, _mm256_setzero_si256());
+        const auto mask = static_cast<unsigned>(_mm256_movemask_epi8(isSpecial));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chars);   // NOLINT
+        if (mask == 0) {
+            i += 32;
+            out += 32;
+            continue;
         }
+
+        const auto pos = lowestBit(mask);
+        out = appendEscaped(in[i + pos], out + pos);
+        i += pos + 1;
+    }
+    leaveAvx();
+    return escapeSse41(in + i, size - i, out);
+}
+
+#endif
+
+char* removeSpaces(const char* in, std::size_t size, char* out) noexcept
+{
+#if NHOPE_X86
+    switch (detail::simdLevel()) {
+    case detail::SimdLevel::Avx2:
+        return removeSpacesAvx2(in, size, out);
+    case detail::SimdLevel::Sse41:
+        return removeSpacesSse41(in, size, out);
+    case detail::SimdLevel::Scalar:
+        break;
+    }
+#endif
+    return removeSpacesScalar(in, size, out);
+}
+
+std::size_t escapedExtra(const char* in, std::size_t size) noexcept
+{
+#if NHOPE_X86
+    switch (detail::simdLevel()) {
+    case detail::SimdLevel::Avx2:
+        return escapedExtraAvx2(in, size);
+    case detail::SimdLevel::Sse41:
+        return escapedExtraSse41(in, size);
+    case detail::SimdLevel::Scalar:
+        break;
     }
-    rich.shrink_to_fit();
+#endif
+    return escapedExtraScalar(in, size);
+}
+
+char* escape(const char* in, std::size_t size, char* out) noexcept
+{
+#if NHOPE_X86
+    switch (detail::simdLevel()) {
+    case detail::SimdLevel::Avx2:
+        return escapeAvx2(in, size, out);
+    case detail::SimdLevel::Sse41:
+        return escapeSse41(in, size, out);
+    case detail::SimdLevel::Scalar:
+        break;
+    }
+#endif
+    return escapeScalar(in, size, out);
+}
+
+}   // namespace
+
+std::size_t removeWhitespaces(std::string_view s, gsl::span<char> out) noexcept
+{
+    Expects(out.size() >= s.size());
+
+    return static_cast<std::size_t>(removeSpaces(s.data(), s.size(), out.data()) - out.data());
+}
+
+std::string removeWhitespaces(std::string_view s)
+{
+    std::string result(s.size(), '\0');
+    result.resize(removeWhitespaces(s, gsl::span<char>(result.data(), result.size())));
+    return result;
+}
+
+std::size_t htmlEscapedSize(std::string_view s) noexcept
+{
+    return s.size() + escapedExtra(s.data(), s.size());
+}
+
+std::size_t toHtmlEscaped(std::string_view s, gsl::span<char> out) noexcept
+{
+    // The size is counted only if the buffer may be too small
+    Expects(out.size() >= s.size() * maxEntitySize || out.size() >= htmlEscapedSize(s));
+
+    return static_cast<std::size_t>(escape(s.data(), s.size(), out.data()) - out.data());
+}
+
+std::string toHtmlEscaped(std::string_view s)
+{
+    // The size is counted first, so the result is allocated once
+    std::string rich(htmlEscapedSize(s), '\0');
+    escape(s.data(), s.size(), rich.data());
     return rich;
 }
 
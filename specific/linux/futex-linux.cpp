@@ -0,0 +1,56 @@
+#include <cerrno>
+#include <climits>
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "nhope/async/detail/futex.h"
+
+namespace nhope::detail {
+
+namespace {
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+long futex(std::atomic<std::uint32_t>& value, int op, std::uint32_t arg, const timespec* timeout)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-type-vararg)
+    return syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&value), op, arg, timeout, nullptr, 0);
+}
+
+}   // namespace
+
+void futexWait(std::atomic<std::uint32_t>& value, std::uint32_t expected)
+{
+    futex(value, FUTEX_WAIT_PRIVATE, expected, nullptr);
+}
+
+bool futexWaitFor(std::atomic<std::uint32_t>& value, std::uint32_t expected, std::chrono::nanoseconds timeout)
+{
+    if (timeout <= std::chrono::nanoseconds::zero()) {
+        return false;
+    }
+
+    const auto secs = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    timespec ts{};
+    ts.tv_sec = static_cast<decltype(ts.tv_sec)>(secs.count());
+    ts.tv_nsec = static_cast<decltype(ts.tv_nsec)>((timeout - secs).count());
+
+    const auto ret = futex(value, FUTEX_WAIT_PRIVATE, expected, &ts);
+    return ret == 0 || errno != ETIMEDOUT;
+}
+
+void futexWakeOne(std::atomic<std::uint32_t>& value)
+{
+    futex(value, FUTEX_WAKE_PRIVATE, 1, nullptr);
+}
+
+void futexWakeAll(std::atomic<std::uint32_t>& value)
+{
+    futex(value, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr);
+}
+
+}   // namespace nhope::detail
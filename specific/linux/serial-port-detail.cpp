@@ -1,11 +1,18 @@
 #include "sys/ioctl.h"
+#include <cerrno>
+#include <cstdint>
 #include <cstdio>
+#include <linux/serial.h>
 #include <stdexcept>
+#include <termios.h>
 
 #include "nhope/io/detail/serial-port-detail.h"
 
 namespace nhope::detail {
 
+// Defined in serial-port-termios2.cpp
+void setTermios2Baudrate(int fd, std::uint32_t baudrate);
+
 void setRTS(asio::serial_port& serialPort, bool state)
 {
     int arg = TIOCM_RTS;
@@ -37,4 +44,61 @@ SerialPortParams::ModemControl getModemControl(asio::serial_port& serialPort)
     return arg;
 }
 
+std::size_t bytesAvailable(asio::serial_port& serialPort)
+{
+    int size = 0;
+    if (ioctl(serialPort.native_handle(), FIONREAD, &size) == -1) {
+        const auto err = std::error_code(errno, std::system_category());
+        throw std::system_error(err, "serial-port: failed to get the number of received bytes");
+    }
+    return static_cast<std::size_t>(size);
+}
+
+void setBaudrate(asio::serial_port& serialPort, std::uint32_t baudrate)
+{
+    setTermios2Baudrate(serialPort.native_handle(), baudrate);
+}
+
+void setLowLatency(asio::serial_port& serialPort, bool state)
+{
+    serial_struct serial{};
+    const auto handle = serialPort.native_handle();
+    if (ioctl(handle, TIOCGSERIAL, &serial) == -1) {
+        if (errno == ENOTTY) {
+            // The driver has no serial settings (e.g. pty)
+            return;
+        }
+        const auto err = std::error_code(errno, std::system_category());
+        throw std::system_error(err, "serial-port: failed to get serial settings");
+    }
+
+    if (state) {
+        serial.flags |= ASYNC_LOW_LATENCY;
+    } else {
+        serial.flags &= ~ASYNC_LOW_LATENCY;
+    }
+    if (ioctl(handle, TIOCSSERIAL, &serial) == -1) {
+        const auto err = std::error_code(errno, std::system_category());
+        throw std::system_error(err, "serial-port: failed to set low latency");
+    }
+}
+
+void setReadThreshold(asio::serial_port& serialPort, std::uint8_t minSize)
+{
+    termios tio{};
+    const auto handle = serialPort.native_handle();
+    if (tcgetattr(handle, &tio) == -1) {
+        const auto err = std::error_code(errno, std::system_category());
+        throw std::system_error(err, "serial-port: failed to get termios");
+    }
+
+    // The port is non-blocking, so VTIME does not time reads out, but any VTIME > 0 makes it readable at once
+    tio.c_cc[VMIN] = minSize;
+    tio.c_cc[VTIME] = 0;
+    if (tcsetattr(handle, TCSANOW, &tio) == -1) {
+        const auto err = std::error_code(errno, std::system_category());
+        throw std::system_error(err, "serial-port: failed to set VMIN");
+    }
+}
+
 }   // namespace nhope::detail
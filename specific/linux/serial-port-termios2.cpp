@@ -0,0 +1,30 @@
+/* termios2 is declared by <asm/termbits.h>, which conflicts with <termios.h> (included by asio),
+   so it is used in a separate translation unit. */
+#include <asm/termbits.h>
+#include <cerrno>
+#include <cstdint>
+#include <sys/ioctl.h>
+#include <system_error>
+
+namespace nhope::detail {
+
+void setTermios2Baudrate(int fd, std::uint32_t baudrate)
+{
+    termios2 tio{};
+    if (ioctl(fd, TCGETS2, &tio) == -1) {
+        const auto err = std::error_code(errno, std::system_category());
+        throw std::system_error(err, "serial-port: failed to get termios2");
+    }
+
+    // The same rate for output and input
+    tio.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    tio.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+    tio.c_ospeed = baudrate;
+    tio.c_ispeed = baudrate;
+    if (ioctl(fd, TCSETS2, &tio) == -1) {
+        const auto err = std::error_code(errno, std::system_category());
+        throw std::system_error(err, "serial-port: failed to set baud rate");
+    }
+}
+
+}   // namespace nhope::detail
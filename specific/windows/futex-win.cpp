@@ -0,0 +1,68 @@
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "nhope/async/detail/futex.h"
+
+namespace nhope::detail {
+
+namespace {
+
+/* WaitOnAddress is not available for Windows 7 (_WIN32_WINNT=0x0601),
+   so the waiters are parked on a striped table of condition variables. */
+struct ParkingSlot final
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+constexpr std::size_t parkingSlotCount = 64;
+
+ParkingSlot& parkingSlot(const std::atomic<std::uint32_t>& value)
+{
+    static std::array<ParkingSlot, parkingSlotCount> slots;
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto addr = reinterpret_cast<std::uintptr_t>(&value);
+    return slots[(addr / sizeof(value)) % parkingSlotCount];
+}
+
+}   // namespace
+
+void futexWait(std::atomic<std::uint32_t>& value, std::uint32_t expected)
+{
+    auto& slot = parkingSlot(value);
+    std::unique_lock lock(slot.mutex);
+    if (value.load() == expected) {
+        slot.cv.wait(lock);
+    }
+}
+
+bool futexWaitFor(std::atomic<std::uint32_t>& value, std::uint32_t expected, std::chrono::nanoseconds timeout)
+{
+    auto& slot = parkingSlot(value);
+    std::unique_lock lock(slot.mutex);
+    if (value.load() != expected) {
+        return true;
+    }
+    return slot.cv.wait_for(lock, timeout) == std::cv_status::no_timeout;
+}
+
+void futexWakeOne(std::atomic<std::uint32_t>& value)
+{
+    // Other addresses can share the slot, so wake everyone
+    futexWakeAll(value);
+}
+
+void futexWakeAll(std::atomic<std::uint32_t>& value)
+{
+    auto& slot = parkingSlot(value);
+    {
+        std::scoped_lock lock(slot.mutex);
+    }
+    slot.cv.notify_all();
+}
+
+}   // namespace nhope::detail
@@ -1,4 +1,7 @@
+#include <cstddef>
+#include <cstdint>
 #include <stdexcept>
+#include <system_error>
 #include "nhope/io/detail/serial-port-detail.h"
 
 namespace nhope::detail {
@@ -18,4 +21,27 @@ nhope::SerialPortParams::ModemControl getModemControl(asio::serial_port& /*seria
     throw std::logic_error("serial-port: platform don't support modem control");
 }
 
+std::size_t bytesAvailable(asio::serial_port& serialPort)
+{
+    DWORD errors = 0;
+    COMSTAT stat{};
+    if (ClearCommError(serialPort.native_handle(), &errors, &stat) == 0) {
+        const auto err = std::error_code(static_cast<int>(GetLastError()), std::system_category());
+        throw std::system_error(err, "serial-port: failed to get the number of received bytes");
+    }
+    return stat.cbInQue;
+}
+
+void setBaudrate(asio::serial_port& serialPort, std::uint32_t baudrate)
+{
+    // DCB takes any rate
+    serialPort.set_option(asio::serial_port::baud_rate(baudrate));
+}
+
+void setLowLatency(asio::serial_port& /*serialPort*/, bool /*state*/)
+{}
+
+void setReadThreshold(asio::serial_port& /*serialPort*/, std::uint8_t /*minSize*/)
+{}
+
 }   // namespace nhope::detail
@@ -1,6 +1,10 @@
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -219,3 +223,129 @@ TEST(all, nonCopyableVectorArgs)   // NOLINT
     EXPECT_EQ(res.at(1), 4);
     EXPECT_EQ(res.at(2), 6);
 }
+
+namespace {
+
+class CollectConsumer final : public Consumer<int>
+{
+public:
+    explicit CollectConsumer(std::vector<int>& values, std::size_t limit = std::numeric_limits<std::size_t>::max())
+      : m_values(values)
+      , m_limit(limit)
+    {}
+
+    Status consume(const int& value) override
+    {
+        m_values.push_back(value);
+        return m_values.size() < m_limit ? Status::Ok : Status::Closed;
+    }
+
+private:
+    std::vector<int>& m_values;
+    std::size_t m_limit;
+};
+
+}   // namespace
+
+TEST(all, limited)   // NOLINT
+{
+    static constexpr std::size_t maxInFlight = 3;
+    static constexpr int argCount = 20;
+
+    ThreadExecutor executor;
+    AOContext ao(executor);
+
+    std::vector<int> input(argCount);
+    std::iota(input.begin(), input.end(), 0);
+
+    std::atomic<std::size_t> inFlight = 0;
+    std::atomic<std::size_t> maxObserved = 0;
+    auto fn = [&](AOContext&, int x) {
+        const auto current = ++inFlight;
+        maxObserved = std::max<std::size_t>(maxObserved, current);
+        return toThread([x, &inFlight] {
+            std::this_thread::sleep_for(1ms);
+            --inFlight;
+            return x * 2;
+        });
+    };
+
+    {
+        const auto res = allLimited(ao, fn, input, maxInFlight).get();
+        ASSERT_EQ(res.size(), input.size());
+        for (int i = 0; i < argCount; ++i) {
+            EXPECT_EQ(res[static_cast<std::size_t>(i)], i * 2);
+        }
+        EXPECT_LE(maxObserved, maxInFlight);
+        EXPECT_GT(maxObserved, 1);
+    }
+
+    {
+        std::atomic<int> callCount = 0;
+        allLimited(
+          ao,
+          [&callCount](AOContext&, int) {
+              ++callCount;
+              return makeReadyFuture();
+          },
+          input, 1)
+          .get();
+        EXPECT_EQ(callCount, argCount);
+    }
+
+    {
+        EXPECT_TRUE(allLimited(ao, fn, std::vector<int>{}, maxInFlight).get().empty());
+    }
+
+    {
+        // после ошибки оставшиеся аргументы не обрабатываются
+        std::atomic<int> callCount = 0;
+        auto res = allLimited(
+          ao,
+          [&callCount](AOContext&, int x) {
+              ++callCount;
+              return toThread([x] {
+                  if (x == 2) {
+                      throw std::invalid_argument("some problem");
+                  }
+                  return x;
+              });
+          },
+          input, 2);
+
+        EXPECT_THROW(res.get(), std::invalid_argument);   // NOLINT
+        EXPECT_LT(callCount, argCount);
+    }
+}
+
+TEST(all, toConsumer)   // NOLINT
+{
+    static constexpr int argCount = 1000;
+
+    ThreadExecutor executor;
+    AOContext ao(executor);
+
+    std::vector<int> input(argCount);
+    std::iota(input.begin(), input.end(), 0);
+
+    auto fn = [](AOContext&, int x) {
+        return makeReadyFuture<int>(x + 1);
+    };
+
+    {
+        std::vector<int> values;
+        allToConsumer(ao, fn, input, std::make_unique<CollectConsumer>(values), 8).get();
+
+        std::sort(values.begin(), values.end());
+        ASSERT_EQ(values.size(), input.size());
+        EXPECT_EQ(values.front(), 1);
+        EXPECT_EQ(values.back(), argCount);
+    }
+
+    {
+        // закрытый получатель останавливает обработку
+        std::vector<int> values;
+        allToConsumer(ao, fn, input, std::make_unique<CollectConsumer>(values, 10), 8).get();
+        EXPECT_EQ(values.size(), 10);
+    }
+}
@@ -1,3 +1,4 @@
+#include <array>
 #include <atomic>
 #include <stdexcept>
 #include <thread>
@@ -150,4 +151,16 @@ TEST(DelayedProperty, destroyBeforeProducerEnd)   // NOLINT
     close.store(true);
 
     numProducer.wait();
-}
\ No newline at end of file
+}
+
+TEST(DelayedProperty, consumeBatch)   // NOLINT
+{
+    DelayedProperty prop(0);
+    auto input = prop.makeInput();
+
+    const auto values = std::array{1, 2, testValue};
+    EXPECT_EQ(input->consumeBatch(values), Consumer<int>::Status::Ok);
+    EXPECT_TRUE(prop.hasNewValue());
+    prop.applyNewValue(nullHandler);
+    EXPECT_EQ(prop.getCurrentValue(), testValue);
+}
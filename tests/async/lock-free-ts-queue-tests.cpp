@@ -0,0 +1,191 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nhope/async/lock-free-ts-queue.h"
+#include "nhope/async/thread-executor.h"
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+using namespace nhope;
+
+TEST(LockFreeTSQueue, Capacity)   // NOLINT
+{
+    constexpr std::size_t capacity = 42;
+    constexpr std::size_t roundedCapacity = 64;
+
+    LockFreeTSQueue<int> queue(capacity);
+    EXPECT_EQ(queue.capacity(), roundedCapacity);
+
+    for (std::size_t i = 0; i < roundedCapacity; ++i) {
+        EXPECT_TRUE(queue.write(int(i), 0ms));
+    }
+    EXPECT_FALSE(queue.write(0, 10ms));
+    EXPECT_EQ(queue.size(), roundedCapacity);
+
+    int value{};
+    for (std::size_t i = 0; i < roundedCapacity; ++i) {
+        EXPECT_TRUE(queue.read(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.read(value, 10ms));
+    EXPECT_TRUE(queue.empty());
+
+    EXPECT_EQ(LockFreeTSQueue<int>().capacity(), LockFreeTSQueue<int>::maxCapacity);
+}
+
+TEST(LockFreeTSQueue, CloseQueue)   // NOLINT
+{
+    constexpr int iterCount = 100;
+    constexpr int closeIter = 42;
+
+    LockFreeTSQueue<int> queue(iterCount);
+
+    for (int i = 0; i < iterCount; ++i) {
+        if (i == closeIter) {
+            queue.close();
+        }
+        queue.write(int(i));
+    }
+    EXPECT_EQ(queue.size(), closeIter);
+
+    // The closed queue can be drained
+    int value{};
+    for (int i = 0; i < closeIter; ++i) {
+        EXPECT_TRUE(queue.read(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.read(value));
+    EXPECT_FALSE(queue.read().has_value());
+}
+
+TEST(LockFreeTSQueue, CloseWakesUpWaiters)   // NOLINT
+{
+    LockFreeTSQueue<int> readQueue(2);
+    LockFreeTSQueue<int> writeQueue(2);
+    writeQueue.write(0);
+    writeQueue.write(0);
+
+    std::atomic<int> finished = 0;
+    std::thread reader([&] {
+        EXPECT_FALSE(readQueue.read().has_value());
+        ++finished;
+    });
+    std::thread writer([&] {
+        EXPECT_FALSE(writeQueue.write(1));
+        ++finished;
+    });
+
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(finished, 0);
+
+    readQueue.close();
+    writeQueue.close();
+    reader.join();
+    writer.join();
+    EXPECT_EQ(finished, 2);
+}
+
+TEST(LockFreeTSQueue, ReadFor)   // NOLINT
+{
+    constexpr int iterCount = 100;
+    constexpr int writeValue = 42;
+
+    ThreadExecutor thread;
+
+    LockFreeTSQueue<int> queue;
+    int readValue{0};
+
+    for (int i = 0; i < iterCount; ++i) {
+        thread.exec([&] {
+            std::this_thread::sleep_for(2ms);
+            queue.write(int(writeValue));
+        });
+        bool read = queue.read(readValue, 50ms);
+
+        EXPECT_TRUE(read);
+        EXPECT_EQ(readValue, writeValue);
+    }
+}
+
+TEST(LockFreeTSQueue, ManyWritersManyReaders)   // NOLINT
+{
+    constexpr int threadCount = 4;
+    constexpr std::int64_t valuesPerWriter = 100'000;
+    constexpr std::size_t capacity = 16;
+
+    LockFreeTSQueue<std::int64_t> queue(capacity);
+    std::atomic<std::int64_t> sum = 0;
+    std::atomic<std::int64_t> count = 0;
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < threadCount; ++i) {
+        readers.emplace_back([&] {
+            while (auto value = queue.read()) {
+                sum += *value;
+                ++count;
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int i = 0; i < threadCount; ++i) {
+        writers.emplace_back([&] {
+            for (std::int64_t v = 1; v <= valuesPerWriter; ++v) {
+                EXPECT_TRUE(queue.write(v));
+            }
+        });
+    }
+
+    for (auto& w : writers) {
+        w.join();
+    }
+    queue.close();
+    for (auto& r : readers) {
+        r.join();
+    }
+
+    EXPECT_EQ(count, threadCount * valuesPerWriter);
+    EXPECT_EQ(sum, threadCount * valuesPerWriter * (valuesPerWriter + 1) / 2);
+}
+
+TEST(LockFreeTSQueue, DestroyNotEmpty)   // NOLINT
+{
+    auto value = std::make_shared<std::string>("value");
+    {
+        LockFreeTSQueue<std::shared_ptr<std::string>> queue(4);
+        queue.write(value);
+        queue.write(value);
+        EXPECT_EQ(value.use_count(), 3);
+    }
+    EXPECT_EQ(value.use_count(), 1);
+}
+
+TEST(LockFreeTSQueue, Batch)   // NOLINT
+{
+    constexpr int valueCount = 100;
+    constexpr std::size_t maxBatch = 30;
+
+    LockFreeTSQueue<int> queue;
+
+    std::vector<int> values(valueCount);
+    std::iota(values.begin(), values.end(), 0);
+    EXPECT_EQ(queue.writeBatch(values), valueCount);
+
+    std::vector<int> read;
+    EXPECT_EQ(queue.readBatch(read, maxBatch), maxBatch);
+    EXPECT_EQ(queue.readBatch(read, maxBatch, 10ms), maxBatch);
+    EXPECT_EQ(queue.drainTo(read), valueCount - 2 * maxBatch);
+    EXPECT_EQ(read, values);
+
+    EXPECT_EQ(queue.readBatch(read, maxBatch, 10ms), 0);
+
+    queue.close();
+    EXPECT_EQ(queue.readBatch(read, maxBatch), 0);
+    EXPECT_EQ(queue.writeBatch(values), 0);
+}
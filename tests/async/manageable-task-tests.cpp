@@ -1,6 +1,8 @@
 #include <atomic>
 #include <chrono>
+#include <memory>
 #include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -227,3 +229,48 @@ TEST(ManageableTask, InsaneControl)   // NOLINT
     task->resume();
     stopped = true;
 }
+
+TEST(ManageableTask, ManyTasks)   // NOLINT
+{
+    static constexpr int taskCount = 1000;
+    std::atomic<int> counter = 0;
+
+    for (int i = 0; i < taskCount; ++i) {
+        auto task = ManageableTask::start([&counter](auto& /*unused*/) {
+            ++counter;
+        });
+        task->waitForStopped();
+    }
+    ASSERT_EQ(counter, taskCount);
+
+    // Созданная и не запущенная задача удаляется без ожидания
+    auto notStarted = ManageableTask::create([&counter](auto& /*unused*/) {
+        ++counter;
+    });
+    notStarted.reset();
+    ASSERT_EQ(counter, taskCount);
+}
+
+TEST(ManageableTask, PausedTasksDoNotBlockOthers)   // NOLINT
+{
+    static constexpr int taskCount = 32;
+
+    std::vector<std::unique_ptr<ManageableTask>> pausedTasks;
+    for (int i = 0; i < taskCount; ++i) {
+        auto& task = pausedTasks.emplace_back(ManageableTask::start([](auto& ctx) {
+            while (ctx.checkPoint()) {
+                std::this_thread::sleep_for(1ms);
+            }
+        }));
+        task->pause();
+        ASSERT_EQ(task->state(), ManageableTask::State::Paused);
+    }
+
+    auto task = ManageableTask::start([](auto& /*unused*/) {});
+    ASSERT_TRUE(task->asyncWaitForStopped().waitFor(1s));
+
+    for (auto& pausedTask : pausedTasks) {
+        pausedTask->stop();
+        ASSERT_EQ(pausedTask->state(), ManageableTask::State::Stopped);
+    }
+}
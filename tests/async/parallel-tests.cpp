@@ -0,0 +1,98 @@
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "nhope/async/parallel.h"
+#include "nhope/async/thread-executor.h"
+#include "nhope/async/thread-pool-executor.h"
+
+using namespace nhope;
+
+namespace {
+
+constexpr std::size_t valueCount = 100'000;
+
+}   // namespace
+
+TEST(Parallel, For)   // NOLINT
+{
+    ThreadPoolExecutor executor(4);
+
+    std::vector<std::atomic<int>> visits(valueCount);
+    parallelFor(executor, 0, valueCount, [&visits](std::size_t i) {
+        ++visits[i];
+    }).get();
+    for (const auto& v : visits) {
+        ASSERT_EQ(v, 1);
+    }
+
+    std::atomic<std::size_t> total = 0;
+    std::atomic<std::size_t> chunkCount = 0;
+    parallelFor(
+      executor, 10, 1010,
+      [&](std::size_t begin, std::size_t end) {
+          // только последний кусок может быть меньше grain
+          if (end != 1010) {
+              EXPECT_GE(end - begin, 100);
+          }
+          total += end - begin;
+          ++chunkCount;
+      },
+      100)
+      .get();
+    EXPECT_EQ(total, 1000);
+    EXPECT_GT(chunkCount, 1);
+
+    parallelFor(executor, 5, 5, [](std::size_t) {
+        FAIL();
+    }).get();
+}
+
+TEST(Parallel, TransformAndReduce)   // NOLINT
+{
+    ThreadPoolExecutor pool(4);
+    ThreadExecutor thread;
+
+    std::vector<std::uint64_t> values(valueCount);
+    std::iota(values.begin(), values.end(), 0);
+
+    for (Executor* executor : std::initializer_list<Executor*>{&pool, &thread}) {
+        std::vector<std::uint64_t> squares(valueCount);
+        parallelTransform(*executor, values.begin(), values.end(), squares.begin(), [](std::uint64_t v) {
+            return v * v;
+        }).get();
+        for (std::size_t i = 0; i < valueCount; ++i) {
+            ASSERT_EQ(squares[i], values[i] * values[i]);
+        }
+
+        const auto sum = parallelReduce(*executor, values.begin(), values.end(), std::uint64_t(1),
+                                        std::plus<std::uint64_t>())
+                           .get();
+        EXPECT_EQ(sum, std::accumulate(values.begin(), values.end(), std::uint64_t(1)));
+
+        EXPECT_EQ(parallelReduce(*executor, values.begin(), values.begin(), 7, std::plus<>()).get(), 7);
+    }
+}
+
+TEST(Parallel, Exception)   // NOLINT
+{
+    ThreadPoolExecutor executor(4);
+
+    std::atomic<std::size_t> calls = 0;
+    auto future = parallelFor(
+      executor, 0, valueCount,
+      [&calls](std::size_t i) {
+          ++calls;
+          if (i == 10) {
+              throw std::runtime_error("parallel");
+          }
+      },
+      1);
+
+    EXPECT_THROW(future.get(), std::runtime_error);   // NOLINT
+    EXPECT_LT(calls, valueCount);
+}
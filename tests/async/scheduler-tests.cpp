@@ -614,3 +614,79 @@ TEST(Scheduler, PausedTaskFinish)   // NOLINT
     scheduler.activate(firstId);
     scheduler.asyncWait(firstId).get();
 }
+
+TEST(Scheduler, ConcurrentTasks)   // NOLINT
+{
+    Scheduler scheduler(Scheduler::Options{2, std::nullopt});
+    std::atomic_bool finish = false;
+
+    auto f = [&finish](auto& ctx) {
+        while (ctx.checkPoint() && !finish) {
+            std::this_thread::sleep_for(5ms);
+        }
+    };
+
+    const auto firstId = scheduler.push(f, 0);
+    const auto secondId = scheduler.push(f, 1);
+    const auto thirdId = scheduler.push(f, 0);
+    EXPECT_EQ(scheduler.getState(firstId), ManageableTask::State::Running);
+    EXPECT_EQ(scheduler.getState(secondId), ManageableTask::State::Running);
+    EXPECT_EQ(scheduler.getState(thirdId), ManageableTask::State::WaitForStart);
+    EXPECT_EQ(scheduler.getActiveTaskIds().size(), 2);
+    EXPECT_EQ(scheduler.getActiveTaskId(), secondId);
+
+    // вытесняется задача с наименьшим приоритетом
+    const auto fourthId = scheduler.push(f, 2);
+    EXPECT_EQ(scheduler.getState(firstId), ManageableTask::State::Paused);
+    EXPECT_EQ(scheduler.getState(secondId), ManageableTask::State::Running);
+    EXPECT_EQ(scheduler.getState(fourthId), ManageableTask::State::Running);
+    EXPECT_EQ(scheduler.getActiveTaskId(), fourthId);
+
+    std::this_thread::sleep_for(20ms);
+    const auto stats = scheduler.getTaskStats(thirdId).value();
+    EXPECT_GE(stats.waitTime, 20ms);
+    EXPECT_EQ(stats.runTime, 0ms);
+
+    finish = true;
+    scheduler.waitAll();
+    EXPECT_EQ(scheduler.size(), 0);
+    EXPECT_TRUE(scheduler.getActiveTaskIds().empty());
+    EXPECT_EQ(scheduler.getStats().at(0).finishedCount, 2);
+    EXPECT_EQ(scheduler.getStats().at(1).finishedCount, 1);
+    EXPECT_EQ(scheduler.getStats().at(2).finishedCount, 1);
+}
+
+TEST(Scheduler, TimeSlice)   // NOLINT
+{
+    static constexpr auto iterCount{20};
+    Scheduler scheduler(Scheduler::Options{1, 20ms});
+    std::atomic_bool firstFinished = false;
+    std::atomic_bool secondStarted = false;
+
+    scheduler.push(
+      [&](auto& ctx) {
+          for (int i = 0; i < iterCount && ctx.checkPoint(); ++i) {
+              std::this_thread::sleep_for(5ms);
+          }
+          firstFinished = true;
+      },
+      1);
+    scheduler.push(
+      [&](auto& ctx) {
+          // задачи одного приоритета выполняются по очереди
+          EXPECT_FALSE(firstFinished);
+          secondStarted = true;
+          for (int i = 0; i < iterCount && ctx.checkPoint(); ++i) {
+              std::this_thread::sleep_for(5ms);
+          }
+      },
+      1);
+
+    scheduler.waitAll();
+    EXPECT_TRUE(secondStarted);
+
+    const auto stats = scheduler.getStats().at(1);
+    EXPECT_EQ(stats.finishedCount, 2);
+    EXPECT_GE(stats.runTime, 2 * iterCount * 5ms);
+    EXPECT_GT(stats.waitTime, 0ms);
+}
@@ -1,5 +1,9 @@
 #include <chrono>
+#include <deque>
+#include <memory>
+#include <numeric>
 #include <thread>
+#include <vector>
 
 #include "nhope/async/ts-queue.h"
 #include "nhope/async/thread-executor.h"
@@ -170,4 +174,94 @@ TEST(TSQueue, GenerateAndRead)   // NOLINT
         }
     }
     EXPECT_TRUE(queue.empty());
-}
\ No newline at end of file
+}
+
+TEST(TSQueue, WriteAndReadBatch)   // NOLINT
+{
+    constexpr int valueCount = 100;
+    constexpr std::size_t maxBatch = 30;
+
+    TSQueue<int> queue;
+
+    std::vector<int> values(valueCount);
+    std::iota(values.begin(), values.end(), 0);
+    EXPECT_EQ(queue.writeBatch(values), valueCount);
+    EXPECT_EQ(values.size(), valueCount);
+    EXPECT_EQ(queue.size(), valueCount);
+
+    std::vector<int> read;
+    EXPECT_EQ(queue.readBatch(read, maxBatch), maxBatch);
+    EXPECT_EQ(queue.readBatch(read, maxBatch, 10ms), maxBatch);
+    EXPECT_EQ(queue.drainTo(read), valueCount - 2 * maxBatch);
+    EXPECT_EQ(read, values);
+    EXPECT_TRUE(queue.empty());
+
+    EXPECT_EQ(queue.readBatch(read, maxBatch, 10ms), 0);
+    EXPECT_EQ(queue.drainTo(read), 0);
+
+    queue.close();
+    EXPECT_EQ(queue.readBatch(read, maxBatch), 0);
+    EXPECT_EQ(queue.writeBatch(values), 0);
+}
+
+TEST(TSQueue, MoveBatch)   // NOLINT
+{
+    constexpr int valueCount = 10;
+
+    TSQueue<std::unique_ptr<int>> queue;
+
+    std::vector<std::unique_ptr<int>> values;
+    for (int i = 0; i < valueCount; ++i) {
+        values.emplace_back(std::make_unique<int>(i));
+    }
+    EXPECT_EQ(queue.writeBatch(std::move(values)), valueCount);
+
+    std::deque<std::unique_ptr<int>> read;
+    EXPECT_EQ(queue.drainTo(read), valueCount);
+    for (int i = 0; i < valueCount; ++i) {
+        EXPECT_EQ(*read[i], i);
+    }
+}
+
+TEST(TSQueue, WriteBatchWithCapacity)   // NOLINT
+{
+    constexpr int valueCount = 1000;
+    constexpr std::size_t capacity = 7;
+    constexpr std::size_t maxBatch = 5;
+
+    TSQueue<int> queue(capacity);
+
+    std::vector<int> values(valueCount);
+    std::iota(values.begin(), values.end(), 0);
+
+    ThreadExecutor writeThread;
+    writeThread.exec([&] {
+        EXPECT_EQ(queue.writeBatch(values), valueCount);
+    });
+
+    std::vector<int> read;
+    while (read.size() < values.size()) {
+        EXPECT_LE(queue.size(), capacity);
+        EXPECT_LE(queue.readBatch(read, maxBatch), maxBatch);
+    }
+    EXPECT_EQ(read, values);
+}
+
+TEST(TSQueue, CloseWakesUpBatchWriter)   // NOLINT
+{
+    constexpr std::size_t capacity = 2;
+
+    TSQueue<int> queue(capacity);
+
+    Event writterFinishedEvent;
+    ThreadExecutor writeThread;
+    writeThread.exec([&] {
+        EXPECT_EQ(queue.writeBatch(std::vector<int>{1, 2, 3, 4}), capacity);
+        writterFinishedEvent.set();
+    });
+
+    std::this_thread::sleep_for(10ms);
+    queue.close();
+    writterFinishedEvent.wait();
+    EXPECT_EQ(queue.size(), capacity);
+}
@@ -29,9 +29,17 @@
 #include "nhope/async/future.h"
 #include "nhope/async/lockable-value.h"
 #include "nhope/async/thread-executor.h"
+#include "nhope/io/base64-reader.h"
+#include "nhope/io/base64-writter.h"
 #include "nhope/io/bit-seq-reader.h"
+#include "nhope/io/bit-stream-reader.h"
 #include "nhope/io/detail/asio-device-wrapper.h"
+#include "nhope/io/digest.h"
+#include "nhope/io/fifo-reader.h"
+#include "nhope/io/hashing-reader.h"
+#include "nhope/io/hashing-writter.h"
 #include "nhope/io/file.h"
+#include "nhope/io/hex-writter.h"
 #include "nhope/io/io-device.h"
 #include "nhope/io/local-socket.h"
 #include "nhope/io/null-device.h"
@@ -41,6 +49,9 @@
 #include "nhope/io/string-writter.h"
 #include "nhope/io/tcp.h"
 #include "nhope/io/udp.h"
+#include "nhope/utils/base64.h"
+#include "nhope/utils/crc.h"
+#include "nhope/utils/hex.h"
 
 #include "./test-helpers/tcp-echo-server.h"
 #include "./test-helpers/udp-echo-server.h"
@@ -54,6 +65,7 @@
 #endif
 
 #ifdef __linux__
+#include "./test-helpers/pseudo-terminal.h"
 #include "./test-helpers/virtual-serial-port.h"
 #include <sys/socket.h>
 #endif
@@ -324,6 +336,90 @@ TEST(IOTest, PspReader)   // NOLINT
     EXPECT_EQ(buf, etalonData);
 }
 
+TEST(IOTest, BitSeqReader_Periods)   // NOLINT
+{
+    // Short periods are copied, the last one (> 1 MB in bytes) is generated word by word
+    for (const std::size_t bitCount : {1, 3, 8, 13, 64, 65, 127, 1000, (1 << 20) + 1}) {
+        std::vector<bool> bits(bitCount);
+        for (std::size_t i = 0; i < bitCount; ++i) {
+            bits[i] = ((i * 7 + i / 5) % 3) == 0;
+        }
+
+        ThreadExecutor executor;
+        AOContext aoCtx(executor);
+        auto dev = BitSeqReader::create(aoCtx, bits);
+
+        std::size_t pos = 0;
+        for (const std::size_t size : {1, 5, 8, 13, 4096, 3, 70000}) {
+            const auto data = read(*dev, size).get();
+            ASSERT_EQ(data.size(), size);
+            for (std::size_t i = 0; i < size * 8; ++i, ++pos) {
+                ASSERT_EQ(((data[i / 8] >> (i % 8)) & 1) != 0, bits[pos % bitCount]) << bitCount << " " << pos;
+            }
+        }
+    }
+}
+
+TEST(IOTest, BitStreamReader)   // NOLINT
+{
+    // Fields cross the chunks of the internal buffer
+    std::string etalonData;
+    for (int i = 0; i < 10000; ++i) {
+        etalonData += std::to_string(i);
+    }
+    const std::vector<std::uint8_t> etalonBytes(etalonData.begin(), etalonData.end());
+
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    for (const auto order : {BitOrder::MsbFirst, BitOrder::LsbFirst}) {
+        auto reader = BitStreamReader::create(aoCtx, StringReader::create(aoCtx, etalonData), order);
+
+        std::size_t pos = 0;
+        for (std::size_t i = 0; pos + 64 <= etalonBytes.size() * 8; ++i) {
+            const auto n = i * 7 % 65;
+            const auto value = readBits(*reader, n).get();
+
+            std::uint64_t etalon = 0;
+            for (std::size_t b = 0; b < n; ++b, ++pos) {
+                const auto shift = order == BitOrder::MsbFirst ? 7 - pos % 8 : pos % 8;
+                const std::uint64_t bit = (etalonBytes[pos / 8] >> shift) & 1;
+                etalon |= order == BitOrder::MsbFirst ? bit << (n - 1 - b) : bit << b;
+            }
+            ASSERT_EQ(value, etalon) << pos << " " << n;
+        }
+    }
+}
+
+TEST(IOTest, BitStreamReader_EndOfStream)   // NOLINT
+{
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    auto reader = BitStreamReader::create(aoCtx, StringReader::create(aoCtx, "\xA5\x0F"));
+    EXPECT_EQ(readBits(*reader, 4).get(), 0xA);
+    EXPECT_EQ(readBits(*reader, 8).get(), 0x50);
+    EXPECT_THROW(readBits(*reader, 5).get(), UnexpectedEndOfStream);   // NOLINT
+    EXPECT_EQ(readBits(*reader, 4).get(), 0xF);
+    EXPECT_THROW(readBits(*reader, 1).get(), UnexpectedEndOfStream);   // NOLINT
+}
+
+TEST(IOTest, BitStreamReader_FailRead)   // NOLINT
+{
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    StubDevice dev(aoCtx, AsioStub::Operations{
+                            AsioStub::ReadOp{4096, "12"sv},
+                            AsioStub::ReadOp{4095, std::errc::io_error},
+                            AsioStub::CloseOp{},
+                          });
+    auto reader = BitStreamReader::create(aoCtx, dev, BitOrder::LsbFirst);
+
+    EXPECT_EQ(readBits(*reader, 12).get(), 0x231);
+    EXPECT_THROW(readBits(*reader, 8).get(), std::system_error);   // NOLINT
+}
+
 TEST(IOTest, AsioDeviceWrapper_Read)   // NOLINT
 {
     constexpr std::size_t bufSize = 1024;
@@ -982,6 +1078,42 @@ TEST(IOTest, modemControlSerialPort)   // NOLINT
 #endif
 }
 
+TEST(IOTest, SerialPort_LowLatencyOptions)   // NOLINT
+{
+#ifdef __linux__
+    using namespace std::chrono_literals;
+
+    ThreadExecutor e;
+    AOContext aoCtx(e);
+    nhope::test::PseudoTerminal pty;
+
+    SerialPortParams p{};
+    p.customBaudrate = 921600;
+    p.lowLatency = true;
+    p.minReadSize = 4;
+    auto serial = SerialPort::open(aoCtx, pty.slaveName(), p);
+    EXPECT_EQ(pty.baudrate(), std::make_pair(921600U, 921600U));
+
+    // The read is posted before the data arrives, VMIN holds it back until the whole frame is received
+    auto received = read(*serial, 4);
+    pty.write("12");
+    for (int i = 0; i < 100 && serial->bytesAvailable() < 2; ++i) {
+        std::this_thread::sleep_for(10ms);
+    }
+    EXPECT_EQ(serial->bytesAvailable(), 2);
+    EXPECT_FALSE(received.waitFor(50ms));
+
+    pty.write("34");
+    EXPECT_EQ(received.get(), std::vector<std::uint8_t>({'1', '2', '3', '4'}));
+    EXPECT_EQ(serial->bytesAvailable(), 0);
+
+    EXPECT_EQ(writeExactly(*serial, {'a', 'b', 'c'}).get(), 3);
+    EXPECT_EQ(pty.read(3), "abc");
+#else
+    GTEST_SKIP();   //NOLINT
+#endif
+}
+
 constexpr auto copyPortionSize = 4 * 1024;
 
 TEST(IOTest, Copy)   // NOLINT
@@ -1240,6 +1372,75 @@ TEST(IOTest, PushbackReader_FailRead)   // NOLINT
     retrived.wait();
 }
 
+TEST(IOTest, FifoReader)   // NOLINT
+{
+    constexpr auto lineCount = 1000;
+
+    std::string etalonData;
+    for (int i = 0; i < lineCount; ++i) {
+        etalonData += "line " + std::to_string(i) + "\n";
+    }
+
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    auto fifoReader = FifoReader::create(aoCtx, StringReader::create(aoCtx, etalonData));
+    for (int i = 0; i < lineCount; ++i) {
+        EXPECT_EQ(readLine(*fifoReader).get(), "line " + std::to_string(i));
+    }
+    EXPECT_EQ(fifoReader->buffered(), 0);
+    EXPECT_TRUE(readAll(*fifoReader).get().empty());
+
+    // Large reads are passed to the origin reader
+    const std::string largeData(FifoReader::bufferSize * 3, 'x');
+    auto stringReader = StringReader::create(aoCtx, largeData);
+    fifoReader = FifoReader::create(aoCtx, *stringReader);
+    EXPECT_TRUE(eq(read(*fifoReader, 10).get(), std::string_view(largeData).substr(0, 10)));
+    EXPECT_EQ(fifoReader->buffered(), FifoReader::bufferSize - 10);
+    EXPECT_EQ(read(*fifoReader, FifoReader::bufferSize).get().size(), FifoReader::bufferSize - 10);
+    EXPECT_EQ(read(*fifoReader, FifoReader::bufferSize * 2).get().size(), FifoReader::bufferSize * 2);
+    EXPECT_EQ(fifoReader->buffered(), 0);
+}
+
+TEST(IOTest, FifoReader_FailRead)   // NOLINT
+{
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    auto dev = std::make_unique<StubDevice>(aoCtx, AsioStub::Operations{
+                                                     AsioStub::ReadOp{FifoReader::bufferSize, std::errc::io_error},
+                                                     AsioStub::CloseOp{},
+                                                   });
+    auto fifoReader = FifoReader::create(aoCtx, *dev);
+    std::array<uint8_t, 2> buf{};
+
+    Event retrived;
+    fifoReader->read(buf, [&](const std::exception_ptr& e, std::size_t c) {
+        EXPECT_EQ(c, 0);
+        EXPECT_THROW(std::rethrow_exception(e), std::system_error);   // NOLINT
+        retrived.set();
+    });
+    retrived.wait();
+}
+
+TEST(IOTest, FifoReader_PartialReads)   // NOLINT
+{
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    // Every origin read gets the whole buffer, however far the previous reads moved the fifo head
+    auto dev = std::make_unique<StubDevice>(aoCtx, AsioStub::Operations{
+                                                     AsioStub::ReadOp{FifoReader::bufferSize, "abc"sv},
+                                                     AsioStub::ReadOp{FifoReader::bufferSize, "de"sv},
+                                                     AsioStub::ReadOp{FifoReader::bufferSize, "f"sv},
+                                                     AsioStub::CloseOp{},
+                                                   });
+    auto fifoReader = FifoReader::create(aoCtx, *dev);
+    EXPECT_TRUE(eq(read(*fifoReader, 10).get(), "abc"sv));
+    EXPECT_TRUE(eq(read(*fifoReader, 10).get(), "de"sv));
+    EXPECT_TRUE(eq(read(*fifoReader, 10).get(), "f"sv));
+}
+
 TEST(IOTest, StringWritter)   // NOLINT
 {
     constexpr auto testData = std::array{
@@ -1264,6 +1465,234 @@ TEST(IOTest, StringWritter)   // NOLINT
     EXPECT_EQ(contetnt, "1234567890");
 }
 
+TEST(IOTest, Base64Reader)   // NOLINT
+{
+    std::vector<std::uint8_t> etalonData(10000);
+    for (std::size_t i = 0; i < etalonData.size(); ++i) {
+        etalonData[i] = static_cast<std::uint8_t>(i * 7);
+    }
+
+    std::string text;
+    const auto base64 = toBase64(etalonData);
+    for (std::size_t i = 0; i < base64.size(); i += 76) {
+        text += base64.substr(i, 76) + "\r\n";
+    }
+
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    auto reader = Base64Reader::create(aoCtx, StringReader::create(aoCtx, text));
+    EXPECT_EQ(read(*reader, 1).get(), std::vector<std::uint8_t>{etalonData[0]});
+    EXPECT_EQ(read(*reader, 2).get(), std::vector<std::uint8_t>(etalonData.begin() + 1, etalonData.begin() + 3));
+
+    auto rest = readAll(*reader).get();
+    EXPECT_TRUE(std::equal(rest.begin(), rest.end(), etalonData.begin() + 3, etalonData.end()));
+}
+
+TEST(IOTest, Base64Reader_InvalidText)   // NOLINT
+{
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    auto reader = Base64Reader::create(aoCtx, StringReader::create(aoCtx, "MTIz!A=="));
+    EXPECT_THROW(readAll(*reader).get(), Base64ParseError);   // NOLINT
+
+    reader = Base64Reader::create(aoCtx, StringReader::create(aoCtx, "MTIzN"));
+    EXPECT_THROW(readAll(*reader).get(), Base64ParseError);   // NOLINT
+}
+
+TEST(IOTest, Base64Writter)   // NOLINT
+{
+    constexpr auto testData = std::array{
+      "1"sv, "23"sv, ""sv, "4567"sv, "<p>Hello?</p>"sv,
+    };
+
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    auto stringWritter = StringWritter::create(aoCtx);
+    auto dev = Base64Writter::create(aoCtx, *stringWritter);
+
+    std::string etalonData;
+    for (const auto str : testData) {
+        etalonData += str;
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto data = gsl::span{reinterpret_cast<const std::uint8_t*>(str.data()), str.size()};
+        const auto written = asyncInvoke(aoCtx, [&] {
+                                 return write(*dev, {data.begin(), data.end()});
+                             }).get();
+        EXPECT_EQ(written, str.size());
+    }
+
+    Event finished;
+    dev->finish([&](const std::exception_ptr& e, std::size_t /*unused*/) {
+        EXPECT_EQ(e, nullptr);
+        finished.set();
+    });
+    finished.wait();
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto etalonBytes = gsl::span{reinterpret_cast<const std::uint8_t*>(etalonData.data()), etalonData.size()};
+    EXPECT_EQ(stringWritter->takeContent(), toBase64(etalonBytes));
+}
+
+TEST(IOTest, HexWritter)   // NOLINT
+{
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    auto stringWritter = StringWritter::create(aoCtx);
+    auto dev = HexWritter::create(aoCtx, *stringWritter);
+
+    std::vector<std::uint8_t> etalonData(1000);
+    for (std::size_t i = 0; i < etalonData.size(); ++i) {
+        etalonData[i] = static_cast<std::uint8_t>(i);
+    }
+
+    const auto half = etalonData.size() / 2;
+    EXPECT_EQ(write(*dev, {etalonData.begin(), etalonData.begin() + half}).get(), half);
+    EXPECT_EQ(write(*dev, {etalonData.begin() + half, etalonData.end()}).get(), etalonData.size() - half);
+
+    EXPECT_EQ(stringWritter->takeContent(), toHex(etalonData));
+}
+
+TEST(IOTest, Digest)   // NOLINT
+{
+    std::string etalonData;
+    for (int i = 0; i < 100000; ++i) {
+        etalonData += std::to_string(i);
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto etalonBytes = gsl::span{reinterpret_cast<const std::uint8_t*>(etalonData.data()), etalonData.size()};
+
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    auto reader = StringReader::create(aoCtx, etalonData);
+    EXPECT_EQ(digest(*reader).get(), MD5::digest(etalonBytes));
+
+    auto emptyReader = StringReader::create(aoCtx, std::string());
+    EXPECT_EQ(digest<MD5>(*emptyReader).get(), MD5::digest(gsl::span<const std::uint8_t>()));
+}
+
+TEST(IOTest, DigestMany)   // NOLINT
+{
+    // Different sizes, so the devices reach EOF in different rounds
+    std::vector<std::string> etalonData(11);
+    for (std::size_t i = 0; i < etalonData.size(); ++i) {
+        for (std::size_t j = 0; j < i * i * 1000; ++j) {
+            etalonData[i] += std::to_string(i + j);
+        }
+    }
+
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    std::vector<StringReaderPtr> readers;
+    std::vector<Reader*> devs;
+    for (const auto& data : etalonData) {
+        devs.push_back(readers.emplace_back(StringReader::create(aoCtx, data)).get());
+    }
+
+    const auto digests = digestMany(devs).get();
+    ASSERT_EQ(digests.size(), etalonData.size());
+    for (std::size_t i = 0; i < etalonData.size(); ++i) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        const auto bytes = gsl::span{reinterpret_cast<const std::uint8_t*>(etalonData[i].data()), etalonData[i].size()};
+        EXPECT_EQ(digests[i], MD5::digest(bytes)) << i;
+    }
+
+    EXPECT_TRUE(digestMany({}).get().empty());
+}
+
+TEST(IOTest, Digest_FailRead)   // NOLINT
+{
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    auto dev = std::make_unique<StubDevice>(aoCtx, AsioStub::Operations{
+                                                     AsioStub::ReadOp{detail::DigestOp<MD5>::bufferSize, "12345"sv},
+                                                     AsioStub::ReadOp{detail::DigestOp<MD5>::bufferSize,
+                                                                      std::errc::io_error},
+                                                     AsioStub::CloseOp{},
+                                                   });
+    EXPECT_THROW(digest(*dev).get(), std::system_error);   // NOLINT
+
+    auto failDev = std::make_unique<StubDevice>(aoCtx, AsioStub::Operations{
+                                                         AsioStub::ReadOp{detail::DigestOp<MD5>::bufferSize, "12345"sv},
+                                                         AsioStub::ReadOp{detail::DigestOp<MD5>::bufferSize,
+                                                                          std::errc::io_error},
+                                                         AsioStub::CloseOp{},
+                                                       });
+    auto reader = StringReader::create(aoCtx, std::string(100000, 'x'));
+    EXPECT_THROW(digestMany(std::vector<Reader*>{failDev.get(), reader.get()}).get(), std::system_error);   // NOLINT
+}
+
+TEST(IOTest, HashingReader)   // NOLINT
+{
+    std::string etalonData;
+    for (int i = 0; i < 100000; ++i) {
+        etalonData += std::to_string(i);
+    }
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto etalonBytes = gsl::span{reinterpret_cast<const std::uint8_t*>(etalonData.data()), etalonData.size()};
+
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    auto src = HashingReader<MD5>::create(aoCtx, StringReader::create(aoCtx, etalonData));
+    auto dest = StringWritter::create(aoCtx);
+    EXPECT_EQ(copy(*src, *dest).get(), etalonData.size());
+    EXPECT_EQ(dest->takeContent(), etalonData);
+    EXPECT_EQ(src->digest(), MD5::digest(etalonBytes));
+
+    auto crcReader = HashingReader<CRC32C>::create(aoCtx, StringReader::create(aoCtx, etalonData));
+    EXPECT_EQ(readAll(*crcReader).get().size(), etalonData.size());
+    EXPECT_EQ(crcReader->digest(), CRC32C::digest(etalonBytes));
+}
+
+TEST(IOTest, HashingReader_FailRead)   // NOLINT
+{
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    StubDevice dev(aoCtx, AsioStub::Operations{
+                            AsioStub::ReadOp{5, "12345"sv},
+                            AsioStub::ReadOp{5, std::errc::io_error},
+                            AsioStub::CloseOp{},
+                          });
+    auto reader = HashingReader<CRC32C>::create(aoCtx, dev);
+
+    EXPECT_EQ(read(*reader, 5).get().size(), 5);
+    EXPECT_THROW(read(*reader, 5).get(), std::system_error);   // NOLINT
+    EXPECT_EQ(reader->digest(), CRC32C::digest(std::vector<std::uint8_t>{'1', '2', '3', '4', '5'}));
+}
+
+TEST(IOTest, HashingWritter)   // NOLINT
+{
+    constexpr auto testData = std::array{
+      "1"sv, "23"sv, ""sv, "4567"sv, "<p>Hello?</p>"sv,
+    };
+
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+
+    auto stringWritter = StringWritter::create(aoCtx);
+    auto dev = HashingWritter<CRC32C>::create(aoCtx, *stringWritter);
+
+    std::string etalonData;
+    for (const auto str : testData) {
+        etalonData += str;
+        EXPECT_EQ(writeExactly(*dev, {str.begin(), str.end()}).get(), str.size());
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    const auto etalonBytes = gsl::span{reinterpret_cast<const std::uint8_t*>(etalonData.data()), etalonData.size()};
+    EXPECT_EQ(stringWritter->takeContent(), etalonData);
+    EXPECT_EQ(dev->digest(), CRC32C::digest(etalonBytes));
+    EXPECT_EQ(dev->digest(), CRC32C::digest(gsl::span<const std::uint8_t>()));
+}
+
 TEST(IOTest, AsioDeviceWrapper_toExceptionPtr)   // NOLINT
 {
     using asio::error::misc_errors;
@@ -1,4 +1,5 @@
 #include <climits>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -9,7 +10,8 @@
 namespace {
 using namespace nhope;
 
-int sum(Chan<int>& chan, int n = INT_MAX)
+template<typename Chan>
+int sum(Chan& chan, int n = INT_MAX)
 {
     int result = 0;
     int value = 0;
@@ -21,7 +23,8 @@ int sum(Chan<int>& chan, int n = INT_MAX)
     return result;
 }
 
-int count(Chan<int>& chan, int n = INT_MAX)
+template<typename Chan>
+int count(Chan& chan, int n = INT_MAX)
 {
     int result = 0;
     int value = 0;
@@ -128,6 +131,40 @@ TEST(ChanTest, OneToMany)   // NOLINT
     thread2.join();
 }
 
+TEST(ChanTest, LockFreeQueue)   // NOLINT
+{
+    static constexpr int MaxProduseCount = 1'000'000;
+    static constexpr int ChanCapacity = 16;
+    static constexpr int CountLimit = 100'000;
+
+    FuncProducer<int> evenNumProducer([m = 0](int& value) mutable -> bool {
+        if (m >= MaxProduseCount) {
+            return false;
+        }
+
+        value = 2 * m++;
+        return true;
+    });
+
+    FuncProducer<int> oddNumproducer([m = 0](int& value) mutable -> bool {
+        if (m >= MaxProduseCount) {
+            return false;
+        }
+
+        value = (2 * m++) + 1;
+        return true;
+    });
+
+    Chan<int, LockFreeTSQueue> chan(true, ChanCapacity);
+    chan.attachToProducer(evenNumProducer);
+    chan.attachToProducer(oddNumproducer);
+    evenNumProducer.start();
+    oddNumproducer.start();
+
+    int res = count(chan, CountLimit);
+    GTEST_ASSERT_EQ(res, 100'000);
+}
+
 TEST(ConsumerListTest, Closed)   //NOLINT
 {
     Chan<int> chan(true);
@@ -137,3 +174,57 @@ TEST(ConsumerListTest, Closed)   //NOLINT
     int x{};
     cl.consume(x);
 }
+
+TEST(ChanTest, GetMany)   //NOLINT
+{
+    static constexpr int MaxProduseCount = 10'000;
+    static constexpr int ChanCapacity = 64;
+    static constexpr std::size_t MaxBatch = 100;
+
+    FuncProducer<int> numProducer([m = 0](int& value) mutable -> bool {
+        if (m >= MaxProduseCount) {
+            return false;
+        }
+
+        value = m++;
+        return true;
+    });
+
+    Chan<int> chan(true, ChanCapacity);
+    chan.attachToProducer(numProducer);
+    numProducer.start();
+
+    std::vector<int> values;
+    while (chan.getMany(values, MaxBatch) > 0) {
+    }
+
+    GTEST_ASSERT_EQ(values.size(), MaxProduseCount);
+    for (int i = 0; i < MaxProduseCount; ++i) {
+        GTEST_ASSERT_EQ(values[i], i);
+    }
+}
+
+TEST(ChanTest, ProducerBatches)   //NOLINT
+{
+    static constexpr int MaxProduseCount = 10'000;
+    static constexpr int ChanCapacity = 64;
+    static constexpr std::size_t BatchSize = 10;
+
+    FuncProducer<int> numProducer(
+      [m = 0](int& value) mutable -> bool {
+          if (m >= MaxProduseCount) {
+              return false;
+          }
+
+          value = m++;
+          return true;
+      },
+      BatchSize);
+
+    Chan<int> chan(true, ChanCapacity);
+    chan.attachToProducer(numProducer);
+    numProducer.start();
+
+    int res = count(chan);
+    GTEST_ASSERT_EQ(res, MaxProduseCount);
+}
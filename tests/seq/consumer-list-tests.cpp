@@ -1,5 +1,8 @@
+#include <array>
+#include <atomic>
 #include <memory>
 #include <stdexcept>
+#include <thread>
 #include <tuple>
 #include <vector>
 
@@ -148,3 +151,131 @@ TEST(ConsumerList, exceptionInConsumer)   // NOLINT
     consumerList.consume(*expectValue);
     EXPECT_EQ(*consumeCallCounter, 1);
 }
+
+TEST(ConsumerList, concurrentConsume)   // NOLINT
+{
+    constexpr auto producerCount = 4;
+    constexpr auto consumerCount = 8;
+    constexpr auto valueCount = 10000;
+
+    class CountingConsumer final : public Consumer<int>
+    {
+    public:
+        explicit CountingConsumer(std::atomic<int>& counter)
+          : m_counter(counter)
+        {}
+
+        Status consume(const int& /*value*/) override
+        {
+            ++m_counter;
+            return Status::Ok;
+        }
+
+    private:
+        std::atomic<int>& m_counter;
+    };
+
+    std::atomic<int> counter = 0;
+    ConsumerList<int> consumerList;
+    for (int i = 0; i < consumerCount; ++i) {
+        consumerList.addConsumer(std::make_unique<CountingConsumer>(counter));
+    }
+
+    /* Потребители вызываются параллельно, ни одно значение не теряется */
+    std::vector<std::thread> producers;
+    for (int i = 0; i < producerCount; ++i) {
+        producers.emplace_back([&] {
+            for (int v = 0; v < valueCount; ++v) {
+                EXPECT_EQ(consumerList.consume(v), Consumer<int>::Status::Ok);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_EQ(counter, producerCount * consumerCount * valueCount);
+}
+
+TEST(ConsumerList, consumeBatch)   // NOLINT
+{
+    auto consumeCallCounter = std::make_shared<int>(0);
+
+    ConsumerList<int> consumerList;
+    auto consumer = std::make_unique<TestConsumer>(consumeCallCounter, nullptr);
+    auto closeFlag = consumer->closeFlag();
+    consumerList.addConsumer(std::move(consumer));
+    consumerList.addConsumer(std::make_unique<TestConsumer>(consumeCallCounter, nullptr));
+
+    /* По умолчанию пачка передается Consumer-у по одному значению */
+    const auto values = std::array{1, 2, 3};
+    EXPECT_EQ(consumerList.consumeBatch(values), Consumer<int>::Status::Ok);
+    EXPECT_EQ(*consumeCallCounter, 6);
+
+    /* Закрывшийся Consumer удаляется из списка */
+    *closeFlag = true;
+    *consumeCallCounter = 0;
+    consumerList.consumeBatch(values);
+    EXPECT_EQ(*consumeCallCounter, 4);
+
+    *consumeCallCounter = 0;
+    consumerList.consumeBatch(values);
+    EXPECT_EQ(*consumeCallCounter, 3);
+
+    consumerList.close();
+    EXPECT_EQ(consumerList.consumeBatch(values), Consumer<int>::Status::Closed);
+}
+
+TEST(ConsumerList, consumeOwned)   // NOLINT
+{
+    class OwnershipConsumer final : public Consumer<std::vector<int>>
+    {
+    public:
+        Status consume(const std::vector<int>& /*value*/) override
+        {
+            ++copied;
+            return Status::Ok;
+        }
+
+        Status consumeOwned(std::vector<int>&& value) override
+        {
+            owned = std::move(value);
+            return Status::Ok;
+        }
+
+        Status consumeShared(const std::shared_ptr<const std::vector<int>>& value) override
+        {
+            shared = value;
+            return Status::Ok;
+        }
+
+        int copied = 0;
+        std::vector<int> owned;
+        std::shared_ptr<const std::vector<int>> shared;
+    };
+
+    const std::vector<int> etalon{1, 2, 3};
+
+    ConsumerList<std::vector<int>> consumerList;
+    auto first = std::make_unique<OwnershipConsumer>();
+    auto second = std::make_unique<OwnershipConsumer>();
+    auto last = std::make_unique<OwnershipConsumer>();
+    auto* firstPtr = first.get();
+    auto* secondPtr = second.get();
+    auto* lastPtr = last.get();
+    consumerList.addConsumer(std::move(first));
+    consumerList.addConsumer(std::move(second));
+    consumerList.addConsumer(std::move(last));
+
+    /* Последний Consumer забирает значение, остальные разделяют одну копию */
+    auto value = etalon;
+    const auto* data = value.data();
+    EXPECT_EQ(consumerList.consumeOwned(std::move(value)), Consumer<std::vector<int>>::Status::Ok);
+
+    EXPECT_EQ(lastPtr->owned.data(), data);
+    EXPECT_EQ(lastPtr->shared, nullptr);
+    ASSERT_NE(firstPtr->shared, nullptr);
+    EXPECT_EQ(firstPtr->shared, secondPtr->shared);
+    EXPECT_EQ(*firstPtr->shared, etalon);
+    EXPECT_EQ(firstPtr->copied + secondPtr->copied + lastPtr->copied, 0);
+}
@@ -1,5 +1,7 @@
 #include <array>
+#include <cstdint>
 #include <optional>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -112,3 +114,103 @@ TEST(Fifo, pushAndPop)   // NOLINT
     }
     EXPECT_TRUE(fifo.empty());
 }
+
+TEST(SpscFifo, pushAndPop)   // NOLINT
+{
+    SpscFifo<int, 4> fifo;
+    std::array<int, 4> test{};
+
+    EXPECT_TRUE(fifo.empty());
+    EXPECT_EQ(fifo.push(etalonData), 4);
+    EXPECT_EQ(fifo.size(), 4);
+    EXPECT_EQ(fifo.push(5), 0);
+    EXPECT_EQ(fifo.pop(), 1);
+    EXPECT_EQ(fifo.pop(span(test).first<2>()), 2);
+    EXPECT_EQ(test[0], 2);
+    EXPECT_EQ(test[1], 3);
+
+    // wrap around
+    EXPECT_EQ(fifo.push(span(etalonData).subspan(4)), 3);
+    EXPECT_EQ(fifo.pop(test), 4);
+    const auto e = std::array{4, 5, 6, 7};
+    EXPECT_EQ(test, e);
+    EXPECT_EQ(fifo.pop(), std::nullopt);
+
+    fifo.push(1);
+    fifo.clear();
+    EXPECT_TRUE(fifo.empty());
+    EXPECT_EQ(fifo.push(etalonData), 4);
+    EXPECT_EQ(fifo.size(), 4);
+}
+
+TEST(SpscFifo, zeroCopy)   // NOLINT
+{
+    SpscFifo<int, 4> fifo;
+
+    auto free = fifo.reserveContiguous();
+    EXPECT_EQ(free.size(), 4);
+    free[0] = 1;
+    free[1] = 2;
+    free[2] = 3;
+    fifo.publish(3);
+    EXPECT_EQ(fifo.size(), 3);
+
+    auto data = fifo.data();
+    ASSERT_EQ(data.size(), 3);
+    EXPECT_EQ(data[0], 1);
+    EXPECT_EQ(data[2], 3);
+    fifo.consume(2);
+    EXPECT_EQ(fifo.size(), 1);
+
+    // only the part up to the end of the buffer is contiguous
+    EXPECT_EQ(fifo.reserveContiguous().size(), 1);
+    EXPECT_EQ(fifo.push(span(etalonData).subspan(3)), 3);
+    EXPECT_EQ(fifo.data().size(), 2);
+    fifo.consume(2);
+    data = fifo.data();
+    ASSERT_EQ(data.size(), 2);
+    EXPECT_EQ(data[0], 5);
+    EXPECT_EQ(data[1], 6);
+}
+
+TEST(SpscFifo, crossThread)   // NOLINT
+{
+    static constexpr std::uint32_t valueCount = 1'000'000;
+    static constexpr std::size_t chunkSize = 13;
+
+    SpscFifo<std::uint32_t, 64> fifo;
+
+    std::thread producer([&] {
+        std::array<std::uint32_t, chunkSize> chunk{};
+        std::uint32_t next = 0;
+        while (next < valueCount) {
+            const auto count = std::min<std::size_t>(chunkSize, valueCount - next);
+            for (std::size_t i = 0; i < count; ++i) {
+                chunk[i] = next + static_cast<std::uint32_t>(i);
+            }
+
+            const auto pushed = fifo.push(span(chunk).first(count));
+            next += static_cast<std::uint32_t>(pushed);
+            if (pushed == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < valueCount) {
+        auto data = fifo.data();
+        for (auto v : data) {
+            ordered = ordered && v == expected++;
+        }
+        fifo.consume(data.size());
+        if (data.empty()) {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(fifo.empty());
+}
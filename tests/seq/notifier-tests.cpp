@@ -1,6 +1,7 @@
 #include <atomic>
 #include <chrono>
 #include <memory>
+#include <string>
 #include <thread>
 
 #include <gtest/gtest.h>
@@ -83,3 +84,83 @@ TEST(NotifierTests, DestroyFromHandler)   // NOLINT
     /* Let's wait to make sure that the notifier handler is no longer called */
     std::this_thread::sleep_for(200ms);
 }
+
+TEST(NotifierTests, CallHandlerWithBatches)   // NOLINT
+{
+    static constexpr int iterCount = 1000;
+    static constexpr std::size_t batchSize = 16;
+
+    FuncProducer<int> numProducer(
+      [n = 0](int& value) mutable -> bool {
+          value = n++;
+          return value < iterCount;
+      },
+      batchSize);
+
+    std::atomic<int> counter = 0;
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+    Notifier<int> notifier(aoCtx, [&counter](const int& v) {
+        EXPECT_EQ(counter++, v);
+    });
+    notifier.attachToProducer(numProducer);
+    numProducer.start();
+
+    EXPECT_TRUE(waitForValue(1s, counter, iterCount));
+}
+
+TEST(NotifierTests, FuncGetsEmptyValue)   // NOLINT
+{
+    static constexpr int iterCount = 100;
+
+    for (const std::size_t batchSize : {1, 16}) {
+        FuncProducer<std::string> strProducer(
+          [n = 0](std::string& value) mutable -> bool {
+              EXPECT_TRUE(value.empty());
+              value += std::to_string(n);
+              return n++ < iterCount;
+          },
+          batchSize);
+
+        std::atomic<int> counter = 0;
+        ThreadExecutor executor;
+        AOContext aoCtx(executor);
+        Notifier<std::string> notifier(aoCtx, [&counter](const std::string& v) {
+            EXPECT_EQ(std::to_string(counter++), v);
+        });
+        notifier.attachToProducer(strProducer);
+        strProducer.start();
+
+        EXPECT_TRUE(waitForValue(1s, counter, iterCount));
+    }
+}
+
+TEST(NotifierTests, LatestValue)   // NOLINT
+{
+    static constexpr int iterCount = 10000;
+
+    FuncProducer<int> numProducer([n = 0](int& value) mutable -> bool {
+        value = n++;
+        return value < iterCount;
+    });
+
+    std::atomic<int> lastValue = -1;
+    std::atomic<int> callCount = 0;
+    ThreadExecutor executor;
+    AOContext aoCtx(executor);
+    Notifier<int> notifier(
+      aoCtx,
+      [&](const int& v) {
+          EXPECT_GT(v, lastValue);
+          ++callCount;
+          lastValue = v;
+          std::this_thread::sleep_for(100us);
+      },
+      Notifier<int>::Mode::LatestValue);
+    notifier.attachToProducer(numProducer);
+    numProducer.start();
+
+    EXPECT_TRUE(waitForValue(5s, lastValue, iterCount - 1));
+    EXPECT_GT(notifier.droppedCount(), 0);
+    EXPECT_EQ(callCount + static_cast<int>(notifier.droppedCount()), iterCount);
+}
@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -66,3 +69,131 @@ TEST(PriorityQueue, EraseAndClear)   //NOLINT
     });
     ASSERT_TRUE(queue.empty());
 }
+
+TEST(PriorityQueue, StableOrder)   //NOLINT
+{
+    constexpr int count = 1000;
+    constexpr int priorityCount = 7;
+
+    nhope::PriorityQueue<int> queue;
+    for (int i = 0; i < count; ++i) {
+        queue.push(i, i % priorityCount);
+    }
+
+    for (int priority = priorityCount - 1; priority >= 0; --priority) {
+        for (int i = priority; i < count; i += priorityCount) {
+            ASSERT_EQ(queue.pop(), i);
+        }
+    }
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(IndexedPriorityQueue, Priority)   //NOLINT
+{
+    nhope::IndexedPriorityQueue<int> queue;
+    queue.push(0);
+    queue.push(1);
+    queue.push(2, 1);
+    queue.push(3, 1);
+    queue.push(4);
+    ASSERT_EQ(queue.size(), 5);
+
+    ASSERT_EQ(queue.pop(), 2);
+    ASSERT_EQ(queue.pop(), 3);
+    ASSERT_EQ(queue.pop(), 0);
+    ASSERT_EQ(queue.pop(), 1);
+    ASSERT_EQ(queue.pop(), 4);
+    ASSERT_EQ(queue.pop(), std::nullopt);
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(IndexedPriorityQueue, Handles)   //NOLINT
+{
+    nhope::IndexedPriorityQueue<int> queue;
+    const auto h0 = queue.push(0);
+    const auto h1 = queue.push(1);
+    const auto h2 = queue.push(2);
+    const auto h3 = queue.push(3);
+
+    ASSERT_TRUE(queue.contains(h1));
+    ASSERT_EQ(queue.remove(h1), 1);
+    ASSERT_FALSE(queue.contains(h1));
+    ASSERT_EQ(queue.remove(h1), std::nullopt);
+    ASSERT_FALSE(queue.changePriority(h1, 1));
+
+    ASSERT_TRUE(queue.changePriority(h3, 1));
+    ASSERT_EQ(queue.priority(h3), 1);
+    ASSERT_TRUE(queue.changePriority(h0, -1));
+
+    // The slot of the removed value is reused, but the old handle stays invalid
+    const auto h4 = queue.push(4);
+    ASSERT_NE(h4, h1);
+    ASSERT_FALSE(queue.contains(h1));
+    ASSERT_TRUE(queue.contains(h4));
+
+    ASSERT_EQ(queue.pop(), 3);
+    ASSERT_EQ(queue.pop(), 2);
+    ASSERT_FALSE(queue.contains(h2));
+    ASSERT_EQ(queue.pop(), 4);
+    ASSERT_EQ(queue.pop(), 0);
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(IndexedPriorityQueue, PushFront)   //NOLINT
+{
+    nhope::IndexedPriorityQueue<int> queue;
+    queue.push(1, 1);
+    queue.push(2, 1);
+    queue.pushFront(3, 1);
+    queue.pushFront(4, 1);
+    queue.pushFront(5);
+    queue.push(6, 2);
+
+    ASSERT_EQ(queue.topPriority(), 2);
+    ASSERT_EQ(queue.pop(), 6);
+    ASSERT_EQ(queue.pop(), 4);
+    ASSERT_EQ(queue.pop(), 3);
+    ASSERT_EQ(queue.pop(), 1);
+    ASSERT_EQ(queue.pop(), 2);
+    ASSERT_EQ(queue.pop(), 5);
+    ASSERT_TRUE(queue.empty());
+    ASSERT_EQ(queue.topPriority(), std::nullopt);
+}
+
+TEST(IndexedPriorityQueue, RandomOperations)   //NOLINT
+{
+    constexpr int count = 2000;
+
+    nhope::IndexedPriorityQueue<int> queue;
+    std::vector<nhope::IndexedPriorityQueue<int>::Handle> handles;
+    std::vector<int> priorities(count);
+    for (int i = 0; i < count; ++i) {
+        priorities[i] = (i * 7919) % 13;
+        handles.push_back(queue.push(i, priorities[i]));
+    }
+
+    for (int i = 0; i < count; i += 3) {
+        ASSERT_EQ(queue.remove(handles[i]), i);
+    }
+    for (int i = 1; i < count; i += 3) {
+        priorities[i] = (i * 104729) % 17;
+        ASSERT_TRUE(queue.changePriority(handles[i], priorities[i]));
+    }
+    queue.remove_if([](const int& v, int /*unused*/) {
+        return v % 3 == 2 && v % 5 == 0;
+    });
+
+    std::vector<std::pair<int, int>> expected;
+    for (int i = 0; i < count; ++i) {
+        if (i % 3 != 0 && !(i % 3 == 2 && i % 5 == 0)) {
+            expected.emplace_back(-priorities[i], i);
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+
+    ASSERT_EQ(queue.size(), expected.size());
+    for (const auto& [priority, value] : expected) {
+        ASSERT_EQ(queue.pop(), value);
+    }
+    ASSERT_TRUE(queue.empty());
+}
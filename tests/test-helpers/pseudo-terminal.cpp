@@ -0,0 +1,25 @@
+#ifdef __linux__
+
+#include <asm/termbits.h>
+#include <cstdint>
+#include <stdexcept>
+#include <sys/ioctl.h>
+#include <utility>
+
+#include "pseudo-terminal.h"
+
+namespace nhope::test {
+
+std::pair<std::uint32_t, std::uint32_t> PseudoTerminal::baudrate() const
+{
+    // The termios of the master side of a pty are the termios of the slave side
+    termios2 tio{};
+    if (ioctl(m_master, TCGETS2, &tio) == -1) {
+        throw std::runtime_error("Unable to get termios2 of the pseudo terminal");
+    }
+    return {tio.c_ospeed, tio.c_ispeed};
+}
+
+}   // namespace nhope::test
+
+#endif
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <utility>
+
+#include <gsl/span>
+
+namespace nhope::test {
+
+// The slave side is opened as a serial port, the master side talks to it (no socat and no hardware needed).
+// Used by the tests and the benchmarks.
+class PseudoTerminal final
+{
+public:
+    PseudoTerminal()
+      : m_master(posix_openpt(O_RDWR | O_NOCTTY))
+    {
+        if (m_master == -1 || grantpt(m_master) != 0 || unlockpt(m_master) != 0) {
+            throw std::runtime_error("Unable to open a pseudo terminal");
+        }
+        m_slaveName = ptsname(m_master);   // NOLINT(concurrency-mt-unsafe)
+    }
+
+    ~PseudoTerminal()
+    {
+        close(m_master);
+    }
+
+    PseudoTerminal(const PseudoTerminal&) = delete;
+    PseudoTerminal& operator=(const PseudoTerminal&) = delete;
+
+    [[nodiscard]] const std::string& slaveName() const
+    {
+        return m_slaveName;
+    }
+
+    void write(gsl::span<const std::uint8_t> data) const
+    {
+        while (!data.empty()) {
+            const auto size = ::write(m_master, data.data(), data.size());
+            if (size <= 0) {
+                throw std::runtime_error("Unable to write to the pseudo terminal");
+            }
+            data = data.subspan(static_cast<std::size_t>(size));
+        }
+    }
+
+    void write(std::string_view data) const
+    {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        this->write(gsl::span(reinterpret_cast<const std::uint8_t*>(data.data()), data.size()));
+    }
+
+    // Blocks until buf is filled
+    void read(gsl::span<std::uint8_t> buf) const
+    {
+        while (!buf.empty()) {
+            const auto size = ::read(m_master, buf.data(), buf.size());
+            if (size <= 0) {
+                throw std::runtime_error("Unable to read from the pseudo terminal");
+            }
+            buf = buf.subspan(static_cast<std::size_t>(size));
+        }
+    }
+
+    [[nodiscard]] std::string read(std::size_t size) const
+    {
+        std::string data(size, '\0');
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        this->read(gsl::span(reinterpret_cast<std::uint8_t*>(data.data()), data.size()));
+        return data;
+    }
+
+    /**
+     * @brief Output and input rates of the slave side (set by termios2)
+     * @note Defined in pseudo-terminal.cpp, because <asm/termbits.h> conflicts with <termios.h>
+     */
+    [[nodiscard]] std::pair<std::uint32_t, std::uint32_t> baudrate() const;
+
+private:
+    int m_master;
+    std::string m_slaveName;
+};
+
+}   // namespace nhope::test
@@ -2,6 +2,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -10,6 +11,7 @@
 #include "gsl/span"
 #include "nhope/utils/base64.h"
 #include "nhope/utils/bytes.h"
+#include "nhope/utils/detail/cpu-features.h"
 
 namespace {
 
@@ -26,6 +28,138 @@ constexpr auto encoded = std::array{
 
 static_assert(decoded.size() == encoded.size());
 
+constexpr auto simdLevels = std::array{
+  detail::SimdLevel::Scalar,
+  detail::SimdLevel::Sse41,
+  detail::SimdLevel::Avx2,
+};
+
+// Limits the codec kernels, the levels above the detected one fall back to it
+class SimdLevelGuard final
+{
+public:
+    explicit SimdLevelGuard(detail::SimdLevel level)
+    {
+        detail::setSimdLevelLimit(level);
+    }
+
+    ~SimdLevelGuard()
+    {
+        detail::setSimdLevelLimit(detail::SimdLevel::Avx2);
+    }
+
+    SimdLevelGuard(const SimdLevelGuard&) = delete;
+    SimdLevelGuard& operator=(const SimdLevelGuard&) = delete;
+};
+
+// The implementation before vectorization, the new one must give the same results
+namespace legacy {
+
+std::uint8_t decode(char c)
+{
+    if (c >= 'A' && c <= 'Z') {
+        return static_cast<std::uint8_t>(c - 'A');
+    }
+    if (c >= 'a' && c <= 'z') {
+        return static_cast<std::uint8_t>(c - 'a' + 26);
+    }
+    if (c >= '0' && c <= '9') {
+        return static_cast<std::uint8_t>(c - '0' + 52);
+    }
+    if (c == '+') {
+        return 62;
+    }
+    if (c == '/') {
+        return 63;
+    }
+    throw Base64ParseError("invalid symbol");
+}
+
+std::vector<std::uint8_t> fromBase64(std::string_view str)
+{
+    const auto strLen = str.length();
+    if (strLen == 0) {
+        return {};
+    }
+    if (strLen % 4 != 0) {
+        throw Base64ParseError("Illegal input length");
+    }
+
+    std::vector<std::uint8_t> retval;
+    const auto n = str.back() == '=' ? strLen - 4 : strLen;
+    for (std::size_t i = 0; i < n; i += 4) {
+        const auto by1 = decode(str[i]);
+        const auto by2 = decode(str[i + 1]);
+        const auto by3 = decode(str[i + 2]);
+        const auto by4 = decode(str[i + 3]);
+
+        retval.push_back(static_cast<std::uint8_t>(by1 << 2) | (by2 >> 4));
+        retval.push_back(static_cast<std::uint8_t>((by2 & 0xf) << 4) | (by3 >> 2));
+        retval.push_back(static_cast<std::uint8_t>((by3 & 0x3) << 6) | by4);
+    }
+
+    if (str.substr(strLen - 2) == "=="sv) {
+        const auto by1 = decode(str[strLen - 4]);
+        const auto by2 = decode(str[strLen - 3]);
+        retval.push_back(static_cast<std::uint8_t>(by1 << 2) | (by2 >> 4));
+    } else if (str.back() == '=') {
+        const auto by1 = decode(str[strLen - 4]);
+        const auto by2 = decode(str[strLen - 3]);
+        const auto by3 = decode(str[strLen - 2]);
+        retval.push_back(static_cast<std::uint8_t>(by1 << 2) | (by2 >> 4));
+        retval.push_back(static_cast<std::uint8_t>((by2 & 0xf) << 4) | (by3 >> 2));
+    }
+    return retval;
+}
+
+std::string toBase64(gsl::span<const std::uint8_t> plainSeq)
+{
+    constexpr auto table = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                           "abcdefghijklmnopqrstuvwxyz"
+                           "0123456789+/"sv;
+
+    const auto plainSize = plainSeq.size();
+    std::string retval;
+    std::size_t i = 0;
+    for (i = 0; i + 2 < plainSize; i += 3) {
+        const auto by1 = plainSeq[i];
+        const auto by2 = plainSeq[i + 1];
+        const auto by3 = plainSeq[i + 2];
+
+        retval += table[by1 >> 2];
+        retval += table[((by1 & 0x3) << 4) | (by2 >> 4)];
+        retval += table[((by2 & 0xf) << 2) | (by3 >> 6)];
+        retval += table[by3 & 0x3f];
+    }
+
+    if (i + 1 == plainSize) {
+        const auto by1 = plainSeq[i];
+        retval += table[by1 >> 2];
+        retval += table[(by1 & 0x3) << 4];
+        retval += "=="sv;
+    } else if (i + 2 == plainSize) {
+        const auto by1 = plainSeq[i];
+        const auto by2 = plainSeq[i + 1];
+        retval += table[by1 >> 2];
+        retval += table[((by1 & 0x3) << 4) | (by2 >> 4)];
+        retval += table[(by2 & 0xf) << 2];
+        retval += "="sv;
+    }
+    return retval;
+}
+
+}   // namespace legacy
+
+std::vector<std::uint8_t> randomBytes(std::mt19937& gen, std::size_t size)
+{
+    std::uniform_int_distribution<int> dist(0, std::numeric_limits<std::uint8_t>::max());
+    std::vector<std::uint8_t> retval(size);
+    for (auto& b : retval) {
+        b = static_cast<std::uint8_t>(dist(gen));
+    }
+    return retval;
+}
+
 }   // namespace
 
 TEST(Base64, decode)   // NOLINT
@@ -67,4 +201,130 @@ TEST(Base64, bigdata)   // NOLINT
     EXPECT_GT(base64.size(), data.size());
 
     EXPECT_EQ(data, fromBase64(base64));
-}
\ No newline at end of file
+}
+TEST(Base64, compareWithLegacy)   // NOLINT
+{
+    std::mt19937 gen(1);
+    for (const auto level : simdLevels) {
+        SimdLevelGuard guard(level);
+
+        for (std::size_t size = 0; size < 300; ++size) {
+            const auto data = randomBytes(gen, size);
+            const auto base64 = toBase64(data);
+            EXPECT_EQ(base64, legacy::toBase64(data));
+            EXPECT_EQ(fromBase64(base64, false), legacy::fromBase64(base64));
+        }
+
+        const auto data = randomBytes(gen, 100000);
+        const auto base64 = toBase64(data);
+        EXPECT_EQ(base64, legacy::toBase64(data));
+        EXPECT_EQ(fromBase64(base64, false), data);
+    }
+}
+
+TEST(Base64, skipSpaces)   // NOLINT
+{
+    constexpr auto spaces = " \t\n\v\f\r"sv;
+
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<std::size_t> spaceDist(0, spaces.size() - 1);
+    for (const auto level : simdLevels) {
+        SimdLevelGuard guard(level);
+
+        const auto data = randomBytes(gen, 5000);
+        const auto base64 = toBase64(data);
+
+        // Line breaks of MIME and spaces at random positions
+        std::string text;
+        for (std::size_t i = 0; i < base64.size(); ++i) {
+            if (i % 76 == 0) {
+                text += "\r\n";
+            }
+            if (i % 53 == 0 || i % 97 == 0) {
+                text += spaces[spaceDist(gen)];
+            }
+            text += base64[i];
+        }
+        text += "\n";
+
+        EXPECT_EQ(fromBase64(text), data);
+        EXPECT_THROW(fromBase64(text, false), Base64ParseError);   // NOLINT
+    }
+}
+
+TEST(Base64, invalidSymbols)   // NOLINT
+{
+    constexpr auto invalidSymbols = "!-_.:@[`{\x7f\x80\xff"sv;
+
+    std::mt19937 gen(3);
+    for (const auto level : simdLevels) {
+        SimdLevelGuard guard(level);
+
+        const auto base64 = toBase64(randomBytes(gen, 150));
+        for (std::size_t i = 0; i < base64.size(); ++i) {
+            for (const auto c : invalidSymbols) {
+                auto text = base64;
+                text[i] = c;
+                EXPECT_THROW(fromBase64(text), Base64ParseError);   // NOLINT
+            }
+        }
+    }
+
+    EXPECT_THROW(fromBase64("=MTI"), Base64ParseError);       // NOLINT
+    EXPECT_THROW(fromBase64("M=TI"), Base64ParseError);       // NOLINT
+    EXPECT_THROW(fromBase64("MT=I"), Base64ParseError);       // NOLINT
+    EXPECT_THROW(fromBase64("MQ==MQ=="), Base64ParseError);   // NOLINT
+    EXPECT_THROW(fromBase64("MTI=="), Base64ParseError);      // NOLINT
+    EXPECT_EQ(fromBase64("MQ== \n"), fromBase64("MQ=="));
+}
+
+TEST(Base64, span)   // NOLINT
+{
+    const auto data = std::vector<std::uint8_t>{1, 2, 3, 4, 5};
+
+    std::array<char, base64EncodedSize(5)> text{};
+    EXPECT_EQ(toBase64(data, text), text.size());
+
+    std::array<std::uint8_t, base64DecodedMaxSize(text.size())> out{};
+    const auto size = fromBase64(std::string_view(text.data(), text.size()), out);
+    EXPECT_EQ(std::vector<std::uint8_t>(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(size)), data);
+}
+
+TEST(Base64, streaming)   // NOLINT
+{
+    std::mt19937 gen(4);
+    for (const auto level : simdLevels) {
+        SimdLevelGuard guard(level);
+
+        const auto data = randomBytes(gen, 200);
+        const auto etalon = toBase64(data);
+
+        for (std::size_t split = 0; split <= data.size(); split += 7) {
+            Base64Encoder encoder;
+            std::string text(base64EncodedSize(data.size()), '\0');
+            auto out = gsl::span<char>(text.data(), text.size());
+
+            const auto first = gsl::span(data).first(split);
+            const auto second = gsl::span(data).subspan(split);
+            auto written = encoder.update(first, out);
+            written += encoder.update(second, out.subspan(written));
+            written += encoder.finish(out.subspan(written));
+            EXPECT_EQ(written, text.size());
+            EXPECT_EQ(text, etalon);
+        }
+
+        const auto text = " " + etalon.substr(0, 100) + "\r\n" + etalon.substr(100) + "\n";
+        for (std::size_t split = 0; split <= text.size(); ++split) {
+            Base64Decoder decoder;
+            std::vector<std::uint8_t> result(decoder.updateMaxSize(text.size()));
+
+            const auto first = std::string_view(text).substr(0, split);
+            const auto second = std::string_view(text).substr(split);
+            auto written = decoder.update(first, result);
+            written += decoder.update(second, gsl::span(result).subspan(written));
+            decoder.finish();
+            result.resize(written);
+            EXPECT_EQ(result, data);
+        }
+    }
+}
@@ -0,0 +1,168 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nhope/utils/bit-stream.h>
+
+namespace {
+
+using namespace nhope;
+
+std::vector<std::uint8_t> makeData(std::size_t size)
+{
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(size));
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    std::vector<std::uint8_t> data(size);
+    for (auto& b : data) {
+        b = static_cast<std::uint8_t>(dist(gen));
+    }
+    return data;
+}
+
+bool bitAt(const std::vector<std::uint8_t>& data, std::size_t pos, BitOrder order)
+{
+    if (pos >= data.size() * 8) {
+        return false;
+    }
+    const auto shift = order == BitOrder::MsbFirst ? 7 - pos % 8 : pos % 8;
+    return ((data[pos / 8] >> shift) & 1) != 0;
+}
+
+// Reads bit by bit
+std::uint64_t naiveRead(const std::vector<std::uint8_t>& data, std::size_t pos, std::size_t n, BitOrder order)
+{
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint64_t bit = bitAt(data, pos + i, order) ? 1 : 0;
+        if (order == BitOrder::MsbFirst) {
+            value = value << 1 | bit;
+        } else {
+            value |= bit << i;
+        }
+    }
+    return value;
+}
+
+template<BitOrder Order>
+void checkRead(const std::vector<std::uint8_t>& data)
+{
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<std::size_t> widths(0, 64);
+
+    BitReader<Order> reader(data);
+    std::size_t pos = 0;
+    while (pos < data.size() * 8 + 100) {
+        const auto n = widths(gen);
+        const auto value = n <= BitReader<Order>::maxFastBits ? reader.read(n) : reader.readLong(n);
+        ASSERT_EQ(value, naiveRead(data, pos, n, Order)) << data.size() << " " << pos << " " << n;
+        pos += n;
+        ASSERT_EQ(reader.position(), pos);
+    }
+    EXPECT_EQ(reader.bitsLeft(), 0);
+}
+
+template<BitOrder Order>
+void checkWrite(std::size_t fieldCount)
+{
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(fieldCount));
+    std::uniform_int_distribution<std::size_t> widths(0, 64);
+    std::uniform_int_distribution<std::uint64_t> values;
+
+    std::vector<std::pair<std::uint64_t, std::size_t>> fields;
+    std::size_t bitCount = 0;
+    for (std::size_t i = 0; i < fieldCount; ++i) {
+        const auto n = widths(gen);
+        const auto mask = n == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1;
+        fields.emplace_back(values(gen) & mask, n);
+        bitCount += n;
+    }
+
+    // The buffer has no spare bytes, the tail is written byte by byte
+    std::vector<std::uint8_t> buf((bitCount + 7) / 8);
+    BitWritter<Order> writter(buf);
+    for (const auto& [value, n] : fields) {
+        writter.write(value, n);
+    }
+    EXPECT_EQ(writter.position(), bitCount);
+    EXPECT_EQ(writter.flush(), buf.size());
+
+    std::size_t pos = 0;
+    for (const auto& [value, n] : fields) {
+        ASSERT_EQ(naiveRead(buf, pos, n, Order), value) << fieldCount << " " << pos << " " << n;
+        pos += n;
+    }
+    for (; pos < buf.size() * 8; ++pos) {
+        ASSERT_FALSE(bitAt(buf, pos, Order));
+    }
+}
+
+}   // namespace
+
+TEST(BitStream, readKnownValues)   // NOLINT
+{
+    const std::vector<std::uint8_t> data = {0b1011'0011, 0b0101'1100};
+
+    BitReader<BitOrder::MsbFirst> msb(data);
+    EXPECT_EQ(msb.read(3), 0b101);
+    EXPECT_TRUE(msb.readBit());
+    EXPECT_EQ(msb.read(8), 0b0011'0101);
+    EXPECT_EQ(msb.bitsLeft(), 4);
+    msb.alignToByte();
+    EXPECT_EQ(msb.position(), 16);
+    EXPECT_EQ(msb.read(5), 0);
+
+    BitReader<BitOrder::LsbFirst> lsb(data);
+    EXPECT_EQ(lsb.read(3), 0b011);
+    EXPECT_FALSE(lsb.readBit());
+    EXPECT_EQ(lsb.read(8), 0b1100'1011);
+    lsb.skip(2);
+    EXPECT_EQ(lsb.read(4), 0b01);
+    EXPECT_EQ(lsb.bitsLeft(), 0);
+}
+
+TEST(BitStream, read)   // NOLINT
+{
+    for (const std::size_t size : {0, 1, 7, 8, 9, 100, 1000}) {
+        const auto data = makeData(size);
+        checkRead<BitOrder::MsbFirst>(data);
+        checkRead<BitOrder::LsbFirst>(data);
+    }
+}
+
+TEST(BitStream, write)   // NOLINT
+{
+    const std::vector<std::uint8_t> etalon = {0b1011'0011, 0b0101'0000};
+    std::vector<std::uint8_t> buf(2);
+    BitWritter<BitOrder::MsbFirst> msb(buf);
+    msb.write(0b101, 3);
+    msb.writeBit(true);
+    msb.write(0b0011'0101, 8);
+    EXPECT_EQ(msb.flush(), 2);
+    EXPECT_EQ(buf, etalon);
+
+    for (const std::size_t fieldCount : {0, 1, 2, 10, 1000}) {
+        checkWrite<BitOrder::MsbFirst>(fieldCount);
+        checkWrite<BitOrder::LsbFirst>(fieldCount);
+    }
+}
+
+TEST(BitStream, writeAfterFlush)   // NOLINT
+{
+    std::vector<std::uint8_t> buf(16);
+    BitWritter<BitOrder::LsbFirst> writter(buf);
+    writter.write(0b101, 3);
+    EXPECT_EQ(writter.flush(), 1);
+    writter.write(0b11111, 5);
+    writter.write(0x1ff, 9);
+    EXPECT_EQ(writter.flush(), 3);
+
+    BitReader<BitOrder::LsbFirst> reader(buf);
+    EXPECT_EQ(reader.read(3), 0b101);
+    EXPECT_EQ(reader.read(5), 0b11111);
+    EXPECT_EQ(reader.read(9), 0x1ff);
+    EXPECT_EQ(reader.read(7), 0);
+}
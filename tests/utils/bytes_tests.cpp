@@ -1,11 +1,17 @@
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include <gsl/span>
 #include <gtest/gtest.h>
 
 #include <nhope/utils/bytes.h>
+#include <nhope/utils/detail/cpu-features.h>
 
 namespace {
 using namespace nhope;
@@ -25,6 +31,45 @@ bool eq(const std::array<std::uint8_t, N>& a, const VBytes& b)
     return true;
 }
 
+VBytes makeBytes(std::size_t size)
+{
+    VBytes bytes(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<std::uint8_t>(i * 7 + i / 256);
+    }
+    return bytes;
+}
+
+// The bulk converters must give the same values as the single ones at every SIMD level
+template<typename Int>
+void checkBulk()
+{
+    constexpr std::array levels = {detail::SimdLevel::Scalar, detail::SimdLevel::Sse41, detail::SimdLevel::Avx2};
+    constexpr std::size_t maxCount = 300;
+    using UInt = std::make_unsigned_t<Int>;
+
+    const auto bytes = makeBytes(maxCount * sizeof(Int));
+    for (const auto level : levels) {
+        detail::setSimdLevelLimit(level);
+        for (std::size_t count = 0; count <= maxCount; count += count < 70 ? 1 : 23) {
+            for (const auto endian : {Endian::Little, Endian::Big}) {
+                std::vector<Int> values(count);
+                fromBytes<Int>(bytes, values, endian);
+
+                VBytes roundTrip(count * sizeof(Int));
+                toBytes<Int>(values, roundTrip, endian);
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    const auto etalon = fromBytes<UInt>(gsl::span(bytes).subspan(i * sizeof(Int)), endian);
+                    ASSERT_EQ(values[i], static_cast<Int>(etalon)) << count << " " << i;
+                }
+                ASSERT_TRUE(std::equal(roundTrip.begin(), roundTrip.end(), bytes.begin())) << count;
+            }
+        }
+    }
+    detail::setSimdLevelLimit(detail::SimdLevel::Avx2);
+}
+
 }   // namespace
 
 TEST(Bytes, toBytes)   // NOLINT
@@ -56,4 +101,27 @@ TEST(Bytes, bytesSwap)   // NOLINT
     EXPECT_EQ(bytesSwap(std::uint16_t(0xABCD)), 0xCDAB);
     EXPECT_EQ(bytesSwap(std::uint32_t(0xABCDEFDD)), 0xDDEFCDAB);
     EXPECT_EQ(bytesSwap(std::uint64_t(0x0102030405060708)), 0x0807060504030201);
+    EXPECT_EQ(bytesSwap(std::int16_t(0x0180)), std::int16_t(-32767));
+    EXPECT_EQ(bytesSwap(std::uint8_t(0xAB)), 0xAB);
+
+    static_assert(bytesSwap(std::uint32_t(0x01020304)) == 0x04030201);
+    static_assert(bytesSwap(std::int64_t(0x80)) == std::numeric_limits<std::int64_t>::min());
+}
+
+TEST(Bytes, bulkFromToBytes)   // NOLINT
+{
+    checkBulk<std::uint16_t>();
+    checkBulk<std::int16_t>();
+    checkBulk<std::uint32_t>();
+    checkBulk<std::int64_t>();
+    checkBulk<std::uint64_t>();
+
+    const VBytes bytes = {0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc};
+    std::array<std::uint16_t, 3> values{};
+    fromBytes<std::uint16_t>(bytes, values, Endian::Big);
+    EXPECT_EQ(values, (std::array<std::uint16_t, 3>{0x1234, 0x5678, 0x9abc}));
+
+    std::array<std::uint8_t, 3> bytesAsIs{};
+    fromBytes<std::uint8_t>(bytes, bytesAsIs, Endian::Big);
+    EXPECT_TRUE(eq(bytesAsIs, bytes));
 }
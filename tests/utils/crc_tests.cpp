@@ -0,0 +1,157 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <gsl/span>
+#include <gtest/gtest.h>
+
+#include <nhope/utils/crc.h>
+#include <nhope/utils/detail/cpu-features.h>
+
+namespace {
+
+using namespace nhope;
+using namespace std::literals;
+
+gsl::span<const std::uint8_t> asBytes(std::string_view str)
+{
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    return {reinterpret_cast<const std::uint8_t*>(str.data()), str.size()};
+}
+
+std::vector<std::uint8_t> makeData(std::size_t size)
+{
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(size));
+    std::uniform_int_distribution<int> dist(0, 255);
+
+    std::vector<std::uint8_t> data(size);
+    for (auto& b : data) {
+        b = static_cast<std::uint8_t>(dist(gen));
+    }
+    return data;
+}
+
+// Parameters and check values (CRC of "123456789") from the catalogue of parametrised CRC algorithms
+using CRC8Smbus = Crc<std::uint8_t, 0x07, 0, false, 0>;
+using CRC16Kermit = Crc<std::uint16_t, 0x1021, 0, true, 0>;
+using CRC32Bzip2 = Crc<std::uint32_t, 0x04c11db7, 0xffffffff, false, 0xffffffff>;
+using CRC32IsoHdlc = Crc<std::uint32_t, 0x04c11db7, 0xffffffff, true, 0xffffffff>;
+using CRC64Xz = Crc<std::uint64_t, 0x42f0e1eba9ea3693, ~std::uint64_t(0), true, ~std::uint64_t(0)>;
+
+constexpr auto crc32Table = makeCrcTable<std::uint32_t>(0x04c11db7, true);
+static_assert(crc32Table[1] == 0x77073096 && crc32Table[255] == 0x2d02ef8d);
+
+constexpr auto crc16Table = makeCrcTable<std::uint16_t>(0x1021, false);
+static_assert(crc16Table[1] == 0x1021 && crc16Table[255] == 0x1ef0);
+
+template<typename Hash>
+typename Hash::Digest digestBySteps(gsl::span<const std::uint8_t> data, std::size_t step)
+{
+    Hash hash;
+    for (std::size_t pos = 0; pos < data.size(); pos += step) {
+        hash.update(data.subspan(pos, std::min(step, data.size() - pos)));
+    }
+    return hash.digest();
+}
+
+}   // namespace
+
+TEST(Crc, checkValues)   // NOLINT
+{
+    const auto check = asBytes("123456789"sv);
+
+    EXPECT_EQ(CRC8Smbus::digest(check), 0xf4);
+    EXPECT_EQ(CRC16Modbus::digest(check), 0x4b37);
+    EXPECT_EQ(CRC16CcittFalse::digest(check), 0x29b1);
+    EXPECT_EQ(CRC16Xmodem::digest(check), 0x31c3);
+    EXPECT_EQ(CRC16Kermit::digest(check), 0x2189);
+    EXPECT_EQ(CRC32Bzip2::digest(check), 0xfc891918);
+    EXPECT_EQ(CRC32IsoHdlc::digest(check), 0xcbf43926);
+    EXPECT_EQ(CRC64Xz::digest(check), 0x995dc9bbdf1939fa);
+    EXPECT_EQ(CRC32::digest(check), 0xcbf43926);
+    EXPECT_EQ(CRC32C::digest(check), 0xe3069283);
+}
+
+TEST(Crc, genericUpdate)   // NOLINT
+{
+    const auto data = makeData(1000);
+
+    for (const std::size_t step : {1, 7, 8, 9, 100}) {
+        EXPECT_EQ(digestBySteps<CRC8Smbus>(data, step), CRC8Smbus::digest(data));
+        EXPECT_EQ(digestBySteps<CRC16Modbus>(data, step), CRC16Modbus::digest(data));
+        EXPECT_EQ(digestBySteps<CRC16CcittFalse>(data, step), CRC16CcittFalse::digest(data));
+        EXPECT_EQ(digestBySteps<CRC64Xz>(data, step), CRC64Xz::digest(data));
+    }
+
+    CRC16Modbus crc;
+    crc.update(asBytes("123456789"sv));
+    EXPECT_EQ(crc.digest(), 0x4b37);
+    EXPECT_EQ(crc.digest(), CRC16Modbus::digest(gsl::span<const std::uint8_t>()));
+}
+
+// Hardware kernels against the tables on every size around the block boundaries
+TEST(Crc, crc32_kernels)   // NOLINT
+{
+    const auto data = makeData(8000);
+    const auto bytes = gsl::span<const std::uint8_t>(data);
+
+    for (std::size_t size = 0; size < data.size(); size += size < 300 ? 1 : 97) {
+        const auto part = bytes.subspan(1, size);
+        const auto crc32 = CRC32::digest(part);
+        const auto crc32c = CRC32C::digest(part);
+        EXPECT_EQ(crc32, CRC32IsoHdlc::digest(part)) << size;
+
+        detail::setSimdLevelLimit(detail::SimdLevel::Scalar);
+        EXPECT_EQ(CRC32::digest(part), crc32) << size;
+        EXPECT_EQ(CRC32C::digest(part), crc32c) << size;
+        detail::setSimdLevelLimit(detail::SimdLevel::Avx2);
+    }
+
+    for (const std::size_t step : {13, 64, 1000, 3100}) {
+        EXPECT_EQ(digestBySteps<CRC32>(bytes, step), CRC32::digest(bytes)) << step;
+        EXPECT_EQ(digestBySteps<CRC32C>(bytes, step), CRC32C::digest(bytes)) << step;
+    }
+}
+
+TEST(Crc, crc32c)   // NOLINT
+{
+    EXPECT_EQ(CRC32C::digest(asBytes(""sv)), 0);
+    EXPECT_EQ(CRC32C::digest(asBytes("123456789"sv)), 0xe3069283);
+    EXPECT_EQ(CRC32C::digest(asBytes("The quick brown fox jumps over the lazy dog"sv)), 0x22620404);
+
+    const std::vector<std::uint8_t> zeros(32);
+    EXPECT_EQ(CRC32C::digest(zeros), 0x8a9136aa);
+}
+
+TEST(Crc, crc32c_update)   // NOLINT
+{
+    const auto data = makeData(1000);
+    const auto etalon = CRC32C::digest(data);
+
+    for (const std::size_t step : {1, 3, 8, 13, 64, 999}) {
+        CRC32C crc;
+        for (std::size_t pos = 0; pos < data.size(); pos += step) {
+            crc.update(gsl::span(data).subspan(pos, std::min(step, data.size() - pos)));
+        }
+        EXPECT_EQ(crc.digest(), etalon) << step;
+
+        // digest resets the state
+        EXPECT_EQ(crc.digest(), 0);
+    }
+}
+
+TEST(Crc, crc32c_scalar)   // NOLINT
+{
+    const auto data = makeData(4099);
+    const auto etalon = CRC32C::digest(data);
+
+    detail::setSimdLevelLimit(detail::SimdLevel::Scalar);
+    const auto scalar = CRC32C::digest(data);
+    const auto check = CRC32C::digest(asBytes("123456789"sv));
+    detail::setSimdLevelLimit(detail::SimdLevel::Avx2);
+
+    EXPECT_EQ(scalar, etalon);
+    EXPECT_EQ(check, 0xe3069283);
+}
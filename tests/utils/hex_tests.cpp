@@ -1,7 +1,12 @@
 #include <array>
 #include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
 #include <gtest/gtest.h>
 
+#include "nhope/utils/detail/cpu-features.h"
 #include "nhope/utils/hex.h"
 #include "nhope/utils/string-utils.h"
 
@@ -16,6 +21,50 @@ const auto etalon = std::vector<uint8_t>{
 
 constexpr auto etalonStr = "a6 e7 d3 b4 6f df af 0b de 2a 1f 83 2a 00 d2 de"sv;
 
+constexpr auto simdLevels = std::array{
+  detail::SimdLevel::Scalar,
+  detail::SimdLevel::Sse41,
+  detail::SimdLevel::Avx2,
+};
+
+class SimdLevelGuard final
+{
+public:
+    explicit SimdLevelGuard(detail::SimdLevel level)
+    {
+        detail::setSimdLevelLimit(level);
+    }
+
+    ~SimdLevelGuard()
+    {
+        detail::setSimdLevelLimit(detail::SimdLevel::Avx2);
+    }
+
+    SimdLevelGuard(const SimdLevelGuard&) = delete;
+    SimdLevelGuard& operator=(const SimdLevelGuard&) = delete;
+};
+
+std::vector<std::uint8_t> randomBytes(std::mt19937& gen, std::size_t size)
+{
+    std::uniform_int_distribution<int> dist(0, UINT8_MAX);
+    std::vector<std::uint8_t> retval(size);
+    for (auto& b : retval) {
+        b = static_cast<std::uint8_t>(dist(gen));
+    }
+    return retval;
+}
+
+std::string simpleToHex(const std::vector<std::uint8_t>& bytes, bool upper)
+{
+    const auto digits = upper ? "0123456789ABCDEF"sv : "0123456789abcdef"sv;
+    std::string retval;
+    for (const auto b : bytes) {
+        retval += digits[b >> 4];
+        retval += digits[b & 0xf];
+    }
+    return retval;
+}
+
 }   // namespace
 
 TEST(Hex, fromHex)   // NOLINT
@@ -31,3 +80,76 @@ TEST(Hex, toHex)   // NOLINT
     const auto hex = toHex(etalon);
     EXPECT_EQ(hex, removeWhitespaces(etalonStr));
 }
+
+TEST(Hex, compareWithSimple)   // NOLINT
+{
+    std::mt19937 gen(1);
+    for (const auto level : simdLevels) {
+        SimdLevelGuard guard(level);
+
+        for (std::size_t size = 0; size < 200; ++size) {
+            const auto data = randomBytes(gen, size);
+            EXPECT_EQ(toHex(data), simpleToHex(data, false));
+            EXPECT_EQ(fromHex(simpleToHex(data, false)), data);
+            EXPECT_EQ(fromHex(simpleToHex(data, true)), data);
+        }
+
+        const auto data = randomBytes(gen, 100000);
+        EXPECT_EQ(toHex(data), simpleToHex(data, false));
+        EXPECT_EQ(fromHex(toHex(data)), data);
+    }
+}
+
+TEST(Hex, decodeToSpan)   // NOLINT
+{
+    std::mt19937 gen(2);
+    for (const auto level : simdLevels) {
+        SimdLevelGuard guard(level);
+
+        const auto data = randomBytes(gen, 300);
+        const auto hex = toHex(data);
+
+        // Dump split into lines and bytes
+        std::string text;
+        for (std::size_t i = 0; i < hex.size(); i += 2) {
+            text += hex.substr(i, 2);
+            text += i % 32 == 30 ? "\r\n" : " ";
+        }
+
+        std::vector<std::uint8_t> out(text.size() / 2);
+        const auto result = fromHex(text, out);
+        EXPECT_TRUE(result.ok());
+        out.resize(result.size);
+        EXPECT_EQ(out, data);
+    }
+}
+
+TEST(Hex, errorPosition)   // NOLINT
+{
+    constexpr auto invalidSymbols = "g/:@G`x.\x80\xff"sv;
+
+    std::mt19937 gen(3);
+    for (const auto level : simdLevels) {
+        SimdLevelGuard guard(level);
+
+        const auto hex = toHex(randomBytes(gen, 100));
+        std::vector<std::uint8_t> out(hex.size() / 2);
+        for (std::size_t i = 0; i < hex.size(); ++i) {
+            for (const auto c : invalidSymbols) {
+                auto text = hex;
+                text[i] = c;
+                const auto result = fromHex(text, out);
+                EXPECT_FALSE(result.ok());
+                EXPECT_EQ(result.errorPos, i);
+                EXPECT_EQ(result.size, i / 2);
+            }
+        }
+
+        const auto result = fromHex(hex.substr(0, 101), out);
+        EXPECT_EQ(result.errorPos, 101);
+        EXPECT_EQ(result.size, 50);
+    }
+
+    EXPECT_THROW(fromHex("a6e"sv), HexParseError);   //NOLINT
+    EXPECT_EQ(fromHex("a 6\te7"sv), (std::vector<std::uint8_t>{0xa6, 0xe7}));
+}
@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <fstream>
 #include <ios>
+#include <random>
 #include <sstream>
 #include <string>
 #include <system_error>
@@ -12,6 +13,7 @@
 
 #include <gtest/gtest.h>
 
+#include <nhope/utils/detail/cpu-features.h>
 #include <nhope/utils/md5.h>
 
 namespace {
@@ -76,3 +78,72 @@ TEST(Md5, emptyBuffer)   // NOLINT
     const auto res = MD5::digest(std::vector<uint8_t>());
     EXPECT_EQ(etalonDigest, res);
 }
+
+TEST(Md5, digestMany)   // NOLINT
+{
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> byteDist(0, UINT8_MAX);
+    std::uniform_int_distribution<std::size_t> sizeDist(0, 2000);
+
+    std::vector<std::vector<std::uint8_t>> messages(100);
+    for (auto& message : messages) {
+        message.resize(sizeDist(gen));
+        for (auto& b : message) {
+            b = static_cast<std::uint8_t>(byteDist(gen));
+        }
+    }
+    // A long message keeps its lane after the others are done
+    messages[3].resize(100000, 0x5a);
+
+    const std::vector<gsl::span<const std::uint8_t>> spans(messages.begin(), messages.end());
+    for (const auto level : {detail::SimdLevel::Scalar, detail::SimdLevel::Sse41, detail::SimdLevel::Avx2}) {
+        detail::setSimdLevelLimit(level);
+        EXPECT_GE(MD5::laneCount(), 1);
+
+        const auto digests = MD5::digestMany(spans);
+        ASSERT_EQ(digests.size(), messages.size());
+        for (std::size_t i = 0; i < messages.size(); ++i) {
+            EXPECT_EQ(digests[i], MD5::digest(messages[i])) << "message " << i << " of " << messages[i].size();
+        }
+
+        EXPECT_TRUE(MD5::digestMany({}).empty());
+    }
+    detail::setSimdLevelLimit(detail::SimdLevel::Avx2);
+}
+
+TEST(Md5, multiMd5)   // NOLINT
+{
+    std::mt19937 gen(2);
+    std::uniform_int_distribution<int> byteDist(0, UINT8_MAX);
+    std::uniform_int_distribution<std::size_t> sizeDist(0, 300);
+
+    constexpr std::size_t streamCount = 13;
+    constexpr std::size_t roundCount = 50;
+
+    for (const auto level : {detail::SimdLevel::Scalar, detail::SimdLevel::Sse41, detail::SimdLevel::Avx2}) {
+        detail::setSimdLevelLimit(level);
+
+        MultiMD5 multi(streamCount);
+        EXPECT_EQ(multi.streamCount(), streamCount);
+        std::vector<MD5> etalons(streamCount);
+
+        // Portions of any size, so the streams have partial blocks between the updates
+        std::vector<std::vector<std::uint8_t>> portions(streamCount);
+        for (std::size_t round = 0; round < roundCount; ++round) {
+            for (std::size_t i = 0; i < streamCount; ++i) {
+                portions[i].resize(sizeDist(gen));
+                for (auto& b : portions[i]) {
+                    b = static_cast<std::uint8_t>(byteDist(gen));
+                }
+                etalons[i].update(portions[i]);
+            }
+            multi.update(std::vector<gsl::span<const std::uint8_t>>(portions.begin(), portions.end()));
+        }
+
+        for (std::size_t i = 0; i < streamCount; ++i) {
+            EXPECT_EQ(multi.digest(i), etalons[i].digest()) << "stream " << i;
+        }
+        EXPECT_EQ(multi.digest(0), MD5::digest(gsl::span<const std::uint8_t>()));
+    }
+    detail::setSimdLevelLimit(detail::SimdLevel::Avx2);
+}
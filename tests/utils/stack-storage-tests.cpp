@@ -37,6 +37,8 @@ TEST(StackStorage, pushPopRecs)   // NOLINT
             checkRecs(depth);
         }
     };
+
+    testFn(0);
 }
 
 TEST(StackStorage, overrideKey)   // NOLINT
@@ -48,3 +50,41 @@ TEST(StackStorage, overrideKey)   // NOLINT
     }
     EXPECT_EQ(*StackStorage::get(0), 0);
 }
+
+TEST(StackStorage, count)   // NOLINT
+{
+    EXPECT_EQ(StackStorage::count(0), 0);
+
+    StackStorage::Record rec(0, 0);
+    EXPECT_EQ(StackStorage::count(0), 1);
+    {
+        StackStorage::Record rec2(1, 0);
+        StackStorage::Record rec3(0, 1);
+        EXPECT_EQ(StackStorage::count(0), 2);
+        EXPECT_EQ(StackStorage::count(1), 1);
+    }
+    EXPECT_EQ(StackStorage::count(0), 1);
+    EXPECT_EQ(StackStorage::count(1), 0);
+}
+
+TEST(StackStorage, manyKeys)   // NOLINT
+{
+    constexpr int keyCount = 1000;
+
+    std::function<void(int)> testFn = [&](int key) {
+        StackStorage::Record rec(key, -key);
+        if (key + 1 < keyCount) {
+            testFn(key + 1);
+        } else {
+            for (int k = 0; k < keyCount; ++k) {
+                EXPECT_EQ(*StackStorage::get(k), -k);
+            }
+        }
+
+        EXPECT_FALSE(StackStorage::contains(key + 1));
+        EXPECT_EQ(*StackStorage::get(key), -key);
+    };
+
+    testFn(0);
+    EXPECT_FALSE(StackStorage::contains(0));
+}
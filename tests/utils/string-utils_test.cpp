@@ -1,14 +1,119 @@
 #include <array>
+#include <cctype>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include <gsl/span>
 #include <gtest/gtest.h>
 
+#include <nhope/utils/detail/cpu-features.h>
 #include <nhope/utils/string-utils.h>
 
 using namespace nhope;
 using namespace std::literals;
 
+namespace {
+
+using detail::SimdLevel;
+
+// Text with a lot of whitespaces and HTML metacharacters, also has bytes above 127
+std::string makeText(std::size_t size)
+{
+    constexpr auto alphabet = "ab <>&\"\t\n\v\f\r\x85\xa0\x1fz"sv;
+
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(size));
+    std::uniform_int_distribution<std::size_t> dist(0, alphabet.size() - 1);
+
+    std::string text(size, '\0');
+    for (auto& ch : text) {
+        ch = alphabet[dist(gen)];
+    }
+    return text;
+}
+
+std::string simpleRemoveWhitespaces(std::string_view s)
+{
+    std::string result;
+    for (const char ch : s) {
+        if (std::isspace(static_cast<unsigned char>(ch)) == 0) {
+            result += ch;
+        }
+    }
+    return result;
+}
+
+std::string simpleToHtmlEscaped(std::string_view s)
+{
+    std::string result;
+    for (const char ch : s) {
+        switch (ch) {
+        case '<':
+            result += "&lt;";
+            break;
+        case '>':
+            result += "&gt;";
+            break;
+        case '&':
+            result += "&amp;";
+            break;
+        case '"':
+            result += "&quot;";
+            break;
+        default:
+            result += ch;
+            break;
+        }
+    }
+    return result;
+}
+
+}   // namespace
+
 TEST(String, toHtmlEscaped)   // NOLINT
 {
     constexpr auto plain = R"(&include "<header>)";
     auto html = toHtmlEscaped(plain);
     EXPECT_EQ(html, "&amp;include &quot;&lt;header&gt;");
 }
+
+TEST(String, removeWhitespaces)   // NOLINT
+{
+    EXPECT_EQ(removeWhitespaces(" a\tb\nc\vd\fe\rf "sv), "abcdef");
+    EXPECT_EQ(removeWhitespaces(""sv), "");
+    EXPECT_EQ(removeWhitespaces("   "sv), "");
+}
+
+TEST(String, compareWithSimple)   // NOLINT
+{
+    for (const auto level : {SimdLevel::Scalar, SimdLevel::Sse41, SimdLevel::Avx2}) {
+        detail::setSimdLevelLimit(level);
+        for (std::size_t size = 0; size < 200; ++size) {
+            const auto text = makeText(size);
+            EXPECT_EQ(removeWhitespaces(text), simpleRemoveWhitespaces(text)) << size;
+            EXPECT_EQ(toHtmlEscaped(text), simpleToHtmlEscaped(text)) << size;
+            EXPECT_EQ(htmlEscapedSize(text), simpleToHtmlEscaped(text).size()) << size;
+        }
+
+        // Long runs without special characters are copied by blocks
+        auto text = std::string(1000, 'x') + makeText(100) + std::string(333, 'y');
+        EXPECT_EQ(removeWhitespaces(text), simpleRemoveWhitespaces(text));
+        EXPECT_EQ(toHtmlEscaped(text), simpleToHtmlEscaped(text));
+    }
+    detail::setSimdLevelLimit(SimdLevel::Avx2);
+}
+
+TEST(String, toSpan)   // NOLINT
+{
+    const auto text = makeText(1000);
+
+    // Exact sizes, no spare bytes for the kernels
+    std::string out(text.size(), '\0');
+    const auto size = removeWhitespaces(text, gsl::span<char>(out.data(), out.size()));
+    EXPECT_EQ(out.substr(0, size), simpleRemoveWhitespaces(text));
+
+    std::string html(htmlEscapedSize(text), '\0');
+    EXPECT_EQ(toHtmlEscaped(text, gsl::span<char>(html.data(), html.size())), html.size());
+    EXPECT_EQ(html, simpleToHtmlEscaped(text));
+}